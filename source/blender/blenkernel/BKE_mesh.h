@@ -85,6 +85,21 @@ int poly_get_adj_loops_from_vert(
 int BKE_mesh_edge_other_vert(const struct MEdge *e, int v);
 
 void BKE_mesh_free(struct Mesh *me);
+extern void (*BKE_mesh_dim_draw_cache_free_cb)(struct Mesh *me);
+void BKE_mesh_dim_draw_cache_free(struct Mesh *me);
+struct MDim *BKE_mesh_dimension_pool_to_main(struct Main *bmain, struct Mesh *me, const int index);
+
+/* Evaluated dimension data of an object, see #BKE_mesh_dim_eval_update */
+typedef struct MeshDimEval {
+	/* evaluated coordinates of linear dimension vertices, two per dimension */
+	float (*vco)[2][3];
+	int totdim;
+	/* hash of vco, changes when evaluated dimension vertices move */
+	unsigned int hash;
+} MeshDimEval;
+
+void BKE_mesh_dim_eval_update(struct Object *ob, struct DerivedMesh *dm);
+void BKE_mesh_dim_eval_free(struct Object *ob);
 void BKE_mesh_init(struct Mesh *me);
 struct Mesh *BKE_mesh_add(struct Main *bmain, const char *name);
 void BKE_mesh_copy_data(struct Main *bmain, struct Mesh *me_dst, const struct Mesh *me_src, const int flag);
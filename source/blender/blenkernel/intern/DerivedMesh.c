@@ -2640,6 +2640,10 @@ static void mesh_build_data(
 
 	DM_set_object_boundbox(ob, ob->derivedFinal);
 
+#ifdef WITH_MECHANICAL_MESH_DIMENSIONS
+	BKE_mesh_dim_eval_update(ob, ob->derivedFinal);
+#endif
+
 	ob->derivedFinal->needsFree = 0;
 	ob->derivedDeform->needsFree = 0;
 	ob->lastDataMask = dataMask;
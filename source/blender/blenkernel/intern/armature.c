@@ -945,6 +945,9 @@ static void pchan_bone_deform(bPoseChannel *pchan, bPoseChanDeform *pdef_info, f
 	(*contrib) += weight;
 }
 
+/* Vertices to deform on threads */
+#define ARMATURE_DEFORM_THREADED_LIMIT 1024
+
 typedef struct ArmatureBBoneDefmatsData {
 	bPoseChanDeform *pdef_info_array;
 	DualQuat *dualquats;
@@ -971,6 +974,173 @@ static void armature_bbone_defmats_cb(void *userdata, Link *iter, int index)
 	}
 }
 
+typedef struct ArmatureDeformVertsData {
+	Object *armOb;
+	float (*vertexCos)[3];
+	float (*defMats)[3][3];
+	float (*prevCos)[3];
+	const MDeformVert *dverts;
+	int dverts_len;
+	bPoseChanDeform *pdef_info_array;
+	bPoseChannel **defnrToPC;
+	int *defnrToPCIndex;
+	int defbase_tot;
+	int armature_def_nr;
+	float premat[4][4], postmat[4][4];
+	bool use_envelope, use_quaternion, invert_vgroup, use_dverts;
+} ArmatureDeformVertsData;
+
+static void armature_deform_verts_task_cb(void *userdata, void *UNUSED(userdata_chunk), const int i,
+                                          const int UNUSED(thread_id))
+{
+	ArmatureDeformVertsData *data = userdata;
+	float (*vertexCos)[3] = data->vertexCos;
+	float (*defMats)[3][3] = data->defMats;
+	float (*prevCos)[3] = data->prevCos;
+	const int armature_def_nr = data->armature_def_nr;
+	const bool use_envelope = data->use_envelope;
+	const bool use_quaternion = data->use_quaternion;
+	const bool invert_vgroup = data->invert_vgroup;
+	bPoseChanDeform *pdef_info;
+	bPoseChannel *pchan;
+	const MDeformVert *dvert;
+	DualQuat sumdq, *dq = NULL;
+	float *co, dco[3];
+	float sumvec[3], summat[3][3];
+	float *vec = NULL, (*smat)[3] = NULL;
+	float contrib = 0.0f;
+	float armature_weight = 1.0f; /* default to 1 if no overall def group */
+	float prevco_weight = 1.0f;   /* weight for optional cached vertexcos */
+
+	if (use_quaternion) {
+		memset(&sumdq, 0, sizeof(DualQuat));
+		dq = &sumdq;
+	}
+	else {
+		sumvec[0] = sumvec[1] = sumvec[2] = 0.0f;
+		vec = sumvec;
+
+		if (defMats) {
+			zero_m3(summat);
+			smat = summat;
+		}
+	}
+
+	if ((data->use_dverts || armature_def_nr != -1) && data->dverts && i < data->dverts_len)
+		dvert = data->dverts + i;
+	else
+		dvert = NULL;
+
+	if (armature_def_nr != -1 && dvert) {
+		armature_weight = defvert_find_weight(dvert, armature_def_nr);
+
+		if (invert_vgroup)
+			armature_weight = 1.0f - armature_weight;
+
+		/* hackish: the blending factor can be used for blending with prevCos too */
+		if (prevCos) {
+			prevco_weight = armature_weight;
+			armature_weight = 1.0f;
+		}
+	}
+
+	/* check if there's any  point in calculating for this vert */
+	if (armature_weight == 0.0f)
+		return;
+
+	/* get the coord we work on */
+	co = prevCos ? prevCos[i] : vertexCos[i];
+
+	/* Apply the object's matrix */
+	mul_m4_v3(data->premat, co);
+
+	if (data->use_dverts && dvert && dvert->totweight) { /* use weight groups ? */
+		MDeformWeight *dw = dvert->dw;
+		int deformed = 0;
+		unsigned int j;
+
+		for (j = dvert->totweight; j != 0; j--, dw++) {
+			const int index = dw->def_nr;
+			if (index >= 0 && index < data->defbase_tot && (pchan = data->defnrToPC[index])) {
+				float weight = dw->weight;
+				Bone *bone = pchan->bone;
+				pdef_info = data->pdef_info_array + data->defnrToPCIndex[index];
+
+				deformed = 1;
+
+				if (bone && bone->flag & BONE_MULT_VG_ENV) {
+					weight *= distfactor_to_bone(co, bone->arm_head, bone->arm_tail,
+					                             bone->rad_head, bone->rad_tail, bone->dist);
+				}
+				pchan_bone_deform(pchan, pdef_info, weight, vec, dq, smat, co, &contrib);
+			}
+		}
+		/* if there are vertexgroups but not groups with bones
+		 * (like for softbody groups) */
+		if (deformed == 0 && use_envelope) {
+			pdef_info = data->pdef_info_array;
+			for (pchan = data->armOb->pose->chanbase.first; pchan; pchan = pchan->next, pdef_info++) {
+				if (!(pchan->bone->flag & BONE_NO_DEFORM))
+					contrib += dist_bone_deform(pchan, pdef_info, vec, dq, smat, co);
+			}
+		}
+	}
+	else if (use_envelope) {
+		pdef_info = data->pdef_info_array;
+		for (pchan = data->armOb->pose->chanbase.first; pchan; pchan = pchan->next, pdef_info++) {
+			if (!(pchan->bone->flag & BONE_NO_DEFORM))
+				contrib += dist_bone_deform(pchan, pdef_info, vec, dq, smat, co);
+		}
+	}
+
+	/* actually should be EPSILON? weight values and contrib can be like 10e-39 small */
+	if (contrib > 0.0001f) {
+		if (use_quaternion) {
+			normalize_dq(dq, contrib);
+
+			if (armature_weight != 1.0f) {
+				copy_v3_v3(dco, co);
+				mul_v3m3_dq(dco, (defMats) ? summat : NULL, dq);
+				sub_v3_v3(dco, co);
+				mul_v3_fl(dco, armature_weight);
+				add_v3_v3(co, dco);
+			}
+			else
+				mul_v3m3_dq(co, (defMats) ? summat : NULL, dq);
+
+			smat = summat;
+		}
+		else {
+			mul_v3_fl(vec, armature_weight / contrib);
+			add_v3_v3v3(co, vec, co);
+		}
+
+		if (defMats) {
+			float pre[3][3], post[3][3], tmpmat[3][3];
+
+			copy_m3_m4(pre, data->premat);
+			copy_m3_m4(post, data->postmat);
+			copy_m3_m3(tmpmat, defMats[i]);
+
+			if (!use_quaternion) /* quaternion already is scale corrected */
+				mul_m3_fl(smat, armature_weight / contrib);
+
+			mul_m3_series(defMats[i], post, smat, pre, tmpmat);
+		}
+	}
+
+	/* always, check above code */
+	mul_m4_v3(data->postmat, co);
+
+	/* interpolate with previous modifier position using weight group */
+	if (prevCos) {
+		float mw = 1.0f - prevco_weight;
+		vertexCos[i][0] = prevco_weight * vertexCos[i][0] + mw * co[0];
+		vertexCos[i][1] = prevco_weight * vertexCos[i][1] + mw * co[1];
+		vertexCos[i][2] = prevco_weight * vertexCos[i][2] + mw * co[2];
+	}
+}
+
 void armature_deform_verts(Object *armOb, Object *target, DerivedMesh *dm, float (*vertexCos)[3],
                            float (*defMats)[3][3], int numVerts, int deformflag,
                            float (*prevCos)[3], const char *defgrp_name)
@@ -1086,151 +1256,30 @@ void armature_deform_verts(Object *armOb, Object *target, DerivedMesh *dm, float
 		}
 	}
 
-	for (i = 0; i < numVerts; i++) {
-		MDeformVert *dvert;
-		DualQuat sumdq, *dq = NULL;
-		float *co, dco[3];
-		float sumvec[3], summat[3][3];
-		float *vec = NULL, (*smat)[3] = NULL;
-		float contrib = 0.0f;
-		float armature_weight = 1.0f; /* default to 1 if no overall def group */
-		float prevco_weight = 1.0f;   /* weight for optional cached vertexcos */
-
-		if (use_quaternion) {
-			memset(&sumdq, 0, sizeof(DualQuat));
-			dq = &sumdq;
-		}
-		else {
-			sumvec[0] = sumvec[1] = sumvec[2] = 0.0f;
-			vec = sumvec;
-
-			if (defMats) {
-				zero_m3(summat);
-				smat = summat;
-			}
-		}
-
-		if (use_dverts || armature_def_nr != -1) {
-			if (dm)
-				dvert = dm->getVertData(dm, i, CD_MDEFORMVERT);
-			else if (dverts && i < target_totvert)
-				dvert = dverts + i;
-			else
-				dvert = NULL;
-		}
-		else
-			dvert = NULL;
-
-		if (armature_def_nr != -1 && dvert) {
-			armature_weight = defvert_find_weight(dvert, armature_def_nr);
-
-			if (invert_vgroup)
-				armature_weight = 1.0f - armature_weight;
-
-			/* hackish: the blending factor can be used for blending with prevCos too */
-			if (prevCos) {
-				prevco_weight = armature_weight;
-				armature_weight = 1.0f;
-			}
-		}
-
-		/* check if there's any  point in calculating for this vert */
-		if (armature_weight == 0.0f)
-			continue;
-
-		/* get the coord we work on */
-		co = prevCos ? prevCos[i] : vertexCos[i];
-
-		/* Apply the object's matrix */
-		mul_m4_v3(premat, co);
-
-		if (use_dverts && dvert && dvert->totweight) { /* use weight groups ? */
-			MDeformWeight *dw = dvert->dw;
-			int deformed = 0;
-			unsigned int j;
-
-			for (j = dvert->totweight; j != 0; j--, dw++) {
-				const int index = dw->def_nr;
-				if (index >= 0 && index < defbase_tot && (pchan = defnrToPC[index])) {
-					float weight = dw->weight;
-					Bone *bone = pchan->bone;
-					pdef_info = pdef_info_array + defnrToPCIndex[index];
-
-					deformed = 1;
-
-					if (bone && bone->flag & BONE_MULT_VG_ENV) {
-						weight *= distfactor_to_bone(co, bone->arm_head, bone->arm_tail,
-						                             bone->rad_head, bone->rad_tail, bone->dist);
-					}
-					pchan_bone_deform(pchan, pdef_info, weight, vec, dq, smat, co, &contrib);
-				}
-			}
-			/* if there are vertexgroups but not groups with bones
-			 * (like for softbody groups) */
-			if (deformed == 0 && use_envelope) {
-				pdef_info = pdef_info_array;
-				for (pchan = armOb->pose->chanbase.first; pchan; pchan = pchan->next, pdef_info++) {
-					if (!(pchan->bone->flag & BONE_NO_DEFORM))
-						contrib += dist_bone_deform(pchan, pdef_info, vec, dq, smat, co);
-				}
-			}
-		}
-		else if (use_envelope) {
-			pdef_info = pdef_info_array;
-			for (pchan = armOb->pose->chanbase.first; pchan; pchan = pchan->next, pdef_info++) {
-				if (!(pchan->bone->flag & BONE_NO_DEFORM))
-					contrib += dist_bone_deform(pchan, pdef_info, vec, dq, smat, co);
-			}
-		}
-
-		/* actually should be EPSILON? weight values and contrib can be like 10e-39 small */
-		if (contrib > 0.0001f) {
-			if (use_quaternion) {
-				normalize_dq(dq, contrib);
-
-				if (armature_weight != 1.0f) {
-					copy_v3_v3(dco, co);
-					mul_v3m3_dq(dco, (defMats) ? summat : NULL, dq);
-					sub_v3_v3(dco, co);
-					mul_v3_fl(dco, armature_weight);
-					add_v3_v3(co, dco);
-				}
-				else
-					mul_v3m3_dq(co, (defMats) ? summat : NULL, dq);
-
-				smat = summat;
-			}
-			else {
-				mul_v3_fl(vec, armature_weight / contrib);
-				add_v3_v3v3(co, vec, co);
-			}
-
-			if (defMats) {
-				float pre[3][3], post[3][3], tmpmat[3][3];
-
-				copy_m3_m4(pre, premat);
-				copy_m3_m4(post, postmat);
-				copy_m3_m3(tmpmat, defMats[i]);
-
-				if (!use_quaternion) /* quaternion already is scale corrected */
-					mul_m3_fl(smat, armature_weight / contrib);
-
-				mul_m3_series(defMats[i], post, smat, pre, tmpmat);
-			}
-		}
-
-		/* always, check above code */
-		mul_m4_v3(postmat, co);
+	ArmatureDeformVertsData vdata = {
+	    .armOb = armOb, .vertexCos = vertexCos, .defMats = defMats, .prevCos = prevCos,
+	    .pdef_info_array = pdef_info_array, .defnrToPC = defnrToPC, .defnrToPCIndex = defnrToPCIndex,
+	    .defbase_tot = defbase_tot, .armature_def_nr = armature_def_nr,
+	    .use_envelope = use_envelope, .use_quaternion = use_quaternion, .invert_vgroup = invert_vgroup,
+	    .use_dverts = use_dverts,
+	};
+	copy_m4_m4(vdata.premat, premat);
+	copy_m4_m4(vdata.postmat, postmat);
 
-		/* interpolate with previous modifier position using weight group */
-		if (prevCos) {
-			float mw = 1.0f - prevco_weight;
-			vertexCos[i][0] = prevco_weight * vertexCos[i][0] + mw * co[0];
-			vertexCos[i][1] = prevco_weight * vertexCos[i][1] + mw * co[1];
-			vertexCos[i][2] = prevco_weight * vertexCos[i][2] + mw * co[2];
-		}
+	/* DerivedMesh data is looked up once, not from threads */
+	if (dm) {
+		vdata.dverts = dm->getVertDataArray(dm, CD_MDEFORMVERT);
+		vdata.dverts_len = numVerts;
+	}
+	else if (dverts) {
+		vdata.dverts = dverts;
+		vdata.dverts_len = target_totvert;
 	}
 
+	/* Cost depends on the number of weights of each vertex, dynamic scheduling keeps threads busy. */
+	BLI_task_parallel_range_ex(0, numVerts, &vdata, NULL, 0, armature_deform_verts_task_cb,
+	                           numVerts > ARMATURE_DEFORM_THREADED_LIMIT, true);
+
 	if (dualquats)
 		MEM_freeN(dualquats);
 	if (defnrToPC)
@@ -25,6 +25,7 @@
 
 #include "BLI_utildefines.h"
 #include "BLI_ghash.h"
+#include "BLI_rhash.h"
 #include "BLI_listbase.h"
 
 #include "DNA_ID.h"
@@ -45,7 +46,7 @@
  * This doesn't account for adding/removing data-blocks,
  * and should only be used when performing many lookups.
  *
- * \note GHash's are initialized on demand,
+ * \note RHash's are initialized on demand,
  * since its likely some types will never have lookups run on them,
  * so its a waste to create and never use.
  * \{ */
@@ -58,9 +59,9 @@ struct IDNameLib_Key {
 };
 
 struct IDNameLib_TypeMap {
-	GHash *map;
+	RHash *map;
 	short id_type;
-	/* only for storage of keys in the ghash, avoid many single allocs */
+	/* only for storage of keys in the rhash, avoid many single allocs */
 	struct IDNameLib_Key *keys;
 };
 
@@ -137,21 +138,21 @@ ID *BKE_main_idmap_lookup(struct IDNameLib_Map *id_map, short id_type, const cha
 		if (lb_len == 0) {
 			return NULL;
 		}
-		type_map->map = BLI_ghash_new_ex(idkey_hash, idkey_cmp, __func__, lb_len);
+		type_map->map = BLI_rhash_new_ex(idkey_hash, idkey_cmp, __func__, lb_len);
 		type_map->keys = MEM_mallocN(sizeof(struct IDNameLib_Key) * lb_len, __func__);
 
-		GHash *map = type_map->map;
+		RHash *map = type_map->map;
 		struct IDNameLib_Key *key = type_map->keys;
 
 		for (ID *id = lb->first; id; id = id->next, key++) {
 			key->name = id->name + 2;
 			key->lib = id->lib;
-			BLI_ghash_insert(map, key, id);
+			BLI_rhash_insert(map, key, id);
 		}
 	}
 
 	const struct IDNameLib_Key key_lookup = {name, lib};
-	return BLI_ghash_lookup(type_map->map, &key_lookup);
+	return BLI_rhash_lookup(type_map->map, &key_lookup);
 }
 
 ID *BKE_main_idmap_lookup_id(struct IDNameLib_Map *id_map, const ID *id)
@@ -164,7 +165,7 @@ void BKE_main_idmap_destroy(struct IDNameLib_Map *id_map)
 	struct IDNameLib_TypeMap *type_map = id_map->type_maps;
 	for (int i = 0; i < MAX_LIBARRAY; i++, type_map++) {
 		if (type_map->map) {
-			BLI_ghash_free(type_map->map, NULL, NULL);
+			BLI_rhash_free(type_map->map, NULL, NULL);
 			type_map->map = NULL;
 			MEM_freeN(type_map->keys);
 		}
@@ -44,6 +44,7 @@
 #include "BLI_memarena.h"
 #include "BLI_edgehash.h"
 #include "BLI_string.h"
+#include "BLI_hash_mm2a.h"
 
 #include "BKE_animsys.h"
 #include "BKE_main.h"
@@ -68,6 +69,8 @@
 
 #include "DEG_depsgraph.h"
 
+#include "mesh_dimensions_driven.h"
+
 /* Define for cases when you want extra validation of mesh
  * after certain modifications.
  */
@@ -438,6 +441,45 @@ bool BKE_mesh_has_custom_loop_normals(Mesh *me)
 	}
 }
 
+#ifdef WITH_MECHANICAL_MESH_DIMENSIONS
+/* Dimensions read packed are owned by the mesh, instead of by main */
+static void mesh_dimension_pool_free(Mesh *me)
+{
+	for (int i = 0; i < me->totdim_pool; i++) {
+		MDim *mdim = &me->mdim_pool[i];
+		BKE_animdata_free(&mdim->id, false);
+		MEM_SAFE_FREE(mdim->v);
+	}
+	MEM_SAFE_FREE(me->mdim_pool);
+	me->totdim_pool = 0;
+}
+
+static void mesh_dimension_pool_copy(Main *bmain, Mesh *me_dst, const Mesh *me_src)
+{
+	if (me_src->mdim_pool == NULL) {
+		return;
+	}
+
+	me_dst->mdim = MEM_dupallocN(me_src->mdim);
+	me_dst->mdim_pool = MEM_dupallocN(me_src->mdim_pool);
+
+	for (int i = 0; i < me_dst->totdim_pool; i++) {
+		MDim *mdim = &me_dst->mdim_pool[i];
+		mdim->v = MEM_dupallocN(mdim->v);
+		if (mdim->adt) {
+			mdim->adt = BKE_animdata_copy(bmain, mdim->adt, false);
+		}
+	}
+	for (int i = 0; i < me_dst->totdim; i++) {
+		const MDim *mdim = me_src->mdim[i];
+		// Only pooled dimensions are not on main
+		if (mdim->id.tag & LIB_TAG_NO_MAIN) {
+			me_dst->mdim[i] = &me_dst->mdim_pool[mdim - me_src->mdim_pool];
+		}
+	}
+}
+#endif
+
 /** Free (or release) any data used by this mesh (does not free the mesh itself). */
 void BKE_mesh_free(Mesh *me)
 {
@@ -453,6 +495,107 @@ void BKE_mesh_free(Mesh *me)
 	MEM_SAFE_FREE(me->bb);
 	MEM_SAFE_FREE(me->mselect);
 	MEM_SAFE_FREE(me->edit_btmesh);
+#ifdef WITH_MECHANICAL_MESH_DIMENSIONS
+	mesh_dimensions_driven_cache_free(me);
+	BKE_mesh_dim_draw_cache_free(me);
+	mesh_dimension_pool_free(me);
+#endif
+#ifdef WITH_MECHANICAL_GEOMETRY
+	MEM_SAFE_FREE(me->mgeom);
+	MEM_SAFE_FREE(me->mgeom_index);
+#endif
+}
+
+/* Dimension draw cache is owned by draw code, which sets the callback to free it. */
+void (*BKE_mesh_dim_draw_cache_free_cb)(Mesh *me) = NULL;
+
+void BKE_mesh_dim_draw_cache_free(Mesh *me)
+{
+	if (me->dim_draw_cache && BKE_mesh_dim_draw_cache_free_cb) {
+		BKE_mesh_dim_draw_cache_free_cb(me);
+	}
+	me->dim_draw_cache = NULL;
+}
+
+/**
+ * Keeps on \a ob the coordinates of its dimension vertices on \a dm, once the derived mesh
+ * is built, so object mode drawing does not look them up on every redraw.
+ */
+void BKE_mesh_dim_eval_update(Object *ob, DerivedMesh *dm)
+{
+	Mesh *me = ob->data;
+	MeshDimEval *eval = ob->dim_eval;
+	BLI_HashMurmur2A mm2;
+	int totvert;
+
+	if (me->totdim == 0) {
+		BKE_mesh_dim_eval_free(ob);
+		return;
+	}
+
+	if (eval == NULL) {
+		eval = ob->dim_eval = MEM_callocN(sizeof(*eval), __func__);
+	}
+	if (eval->totdim != me->totdim) {
+		MEM_SAFE_FREE(eval->vco);
+		eval->vco = MEM_mallocN(sizeof(*eval->vco) * me->totdim, __func__);
+		eval->totdim = me->totdim;
+	}
+
+	totvert = dm->getNumVerts(dm);
+	for (int i = 0; i < me->totdim; i++) {
+		MDim *mdm = me->mdim[i];
+		if (mdm->dim_type != DIM_TYPE_LINEAR) {
+			zero_v3(eval->vco[i][0]);
+			zero_v3(eval->vco[i][1]);
+			continue;
+		}
+		for (int j = 0; j < 2; j++) {
+			if (mdm->v[j] < totvert) {
+				dm->getVertCo(dm, mdm->v[j], eval->vco[i][j]);
+			}
+			else {
+				// Removed by modifiers
+				copy_v3_v3(eval->vco[i][j], me->mvert[mdm->v[j]].co);
+			}
+		}
+	}
+
+	BLI_hash_mm2a_init(&mm2, 0);
+	BLI_hash_mm2a_add(&mm2, (const unsigned char *)eval->vco, sizeof(*eval->vco) * eval->totdim);
+	eval->hash = BLI_hash_mm2a_end(&mm2);
+}
+
+void BKE_mesh_dim_eval_free(Object *ob)
+{
+	if (ob->dim_eval) {
+		MEM_SAFE_FREE(ob->dim_eval->vco);
+		MEM_freeN(ob->dim_eval);
+		ob->dim_eval = NULL;
+	}
+}
+
+/**
+ * Moves a dimension packed on \a me to an ID block on \a bmain, to be used out of the mesh.
+ * The packed one is left unused on the pool.
+ */
+MDim *BKE_mesh_dimension_pool_to_main(Main *bmain, Mesh *me, const int index)
+{
+	MDim *mdim = me->mdim[index];
+	MDim *mdim_new;
+
+	if ((mdim->id.tag & LIB_TAG_NO_MAIN) == 0) {
+		return mdim;
+	}
+
+	mdim_new = BKE_libblock_alloc(bmain, ID_DM, mdim->id.name + 2, 0);
+	// Vertex indices and animation are moved too
+	memcpy(((char *)mdim_new) + sizeof(ID), ((char *)mdim) + sizeof(ID), sizeof(MDim) - sizeof(ID));
+	mdim->adt = NULL;
+	mdim->v = NULL;
+
+	me->mdim[index] = mdim_new;
+	return mdim_new;
 }
 
 static void mesh_tessface_clear_intern(Mesh *mesh, int free_customdata)
@@ -530,6 +673,15 @@ void BKE_mesh_copy_data(Main *bmain, Mesh *me_dst, const Mesh *me_src, const int
 	BKE_mesh_update_customdata_pointers(me_dst, do_tessface);
 
 	me_dst->edit_btmesh = NULL;
+	me_dst->dim_bm = NULL;
+	me_dst->dim_draw_cache = NULL;
+#ifdef WITH_MECHANICAL_MESH_DIMENSIONS
+	mesh_dimension_pool_copy(bmain, me_dst, me_src);
+#endif
+#ifdef WITH_MECHANICAL_GEOMETRY
+	me_dst->mgeom = MEM_dupallocN(me_src->mgeom);
+	me_dst->mgeom_index = MEM_dupallocN(me_src->mgeom_index);
+#endif
 
 	me_dst->mselect = MEM_dupallocN(me_dst->mselect);
 	me_dst->bb = MEM_dupallocN(me_dst->bb);
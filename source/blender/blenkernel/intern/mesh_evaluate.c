@@ -176,7 +176,8 @@ typedef struct MeshCalcNormalsData {
 	float (*vnors)[3];
 } MeshCalcNormalsData;
 
-static void mesh_calc_normals_poly_task_cb(void *userdata, const int pidx)
+static void mesh_calc_normals_poly_task_cb(void *userdata, void *UNUSED(userdata_chunk), const int pidx,
+                                           const int UNUSED(thread_id))
 {
 	MeshCalcNormalsData *data = userdata;
 	const MPoly *mp = &data->mpolys[pidx];
@@ -184,7 +185,8 @@ static void mesh_calc_normals_poly_task_cb(void *userdata, const int pidx)
 	BKE_mesh_calc_poly_normal(mp, data->mloop + mp->loopstart, data->mverts, data->pnors[pidx]);
 }
 
-static void mesh_calc_normals_poly_accum_task_cb(void *userdata, const int pidx)
+static void mesh_calc_normals_poly_accum_task_cb(void *userdata, void *UNUSED(userdata_chunk), const int pidx,
+                                                 const int UNUSED(thread_id))
 {
 	MeshCalcNormalsData *data = userdata;
 	const MPoly *mp = &data->mpolys[pidx];
@@ -265,7 +267,8 @@ void BKE_mesh_calc_normals_poly(
 		    .mpolys = mpolys, .mloop = mloop, .mverts = mverts, .pnors = pnors,
 		};
 
-		BLI_task_parallel_range(0, numPolys, &data, mesh_calc_normals_poly_task_cb, (numPolys > BKE_MESH_OMP_LIMIT));
+		BLI_task_parallel_range_ex(0, numPolys, &data, NULL, 0, mesh_calc_normals_poly_task_cb,
+		                           (numPolys > BKE_MESH_OMP_LIMIT), true);
 		return;
 	}
 
@@ -282,7 +285,9 @@ void BKE_mesh_calc_normals_poly(
 	    .mpolys = mpolys, .mloop = mloop, .mverts = mverts, .pnors = pnors, .vnors = vnors,
 	};
 
-	BLI_task_parallel_range(0, numPolys, &data, mesh_calc_normals_poly_accum_task_cb, (numPolys > BKE_MESH_OMP_LIMIT));
+	/* N-gons are much more expensive than triangles, dynamic scheduling keeps threads busy on mixed meshes. */
+	BLI_task_parallel_range_ex(0, numPolys, &data, NULL, 0, mesh_calc_normals_poly_accum_task_cb,
+	                           (numPolys > BKE_MESH_OMP_LIMIT), true);
 
 	for (i = 0; i < numVerts; i++) {
 		MVert *mv = &mverts[i];
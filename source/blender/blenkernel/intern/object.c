@@ -356,6 +356,10 @@ void BKE_object_free_derived_caches(Object *ob)
 		ob->derivedDeform->release(ob->derivedDeform);
 		ob->derivedDeform = NULL;
 	}
+
+#ifdef WITH_MECHANICAL_MESH_DIMENSIONS
+	BKE_mesh_dim_eval_free(ob);
+#endif
 	
 	BKE_object_free_curve_cache(ob);
 }
@@ -1177,6 +1181,7 @@ void BKE_object_copy_data(Main *UNUSED(bmain), Object *ob_dst, const Object *ob_
 	
 	/* Do not copy runtime curve data. */
 	ob_dst->curve_cache = NULL;
+	ob_dst->dim_eval = NULL;
 
 	/* Do not copy object's preview (mostly due to the fact renderers create temp copy of objects). */
 	if ((flag & LIB_ID_COPY_NO_PREVIEW) == 0 && false) {  /* XXX TODO temp hack */
@@ -2676,7 +2681,9 @@ void BKE_object_handle_update_ex(EvaluationContext *eval_ctx,
 		Mesh *me = ob->data;
 		if (me->totdim) {
 			for (int i=0;i<me->totdim;i++) {
-				BKE_animsys_evaluate_animdata(scene, &me->mdim[i]->id, me->mdim[i]->adt, BKE_scene_frame_get(scene), ADT_RECALC_DRIVERS);
+				// Dimensions packed on the mesh are not on main, animation is not evaluated with main
+				const short recalc = (me->mdim[i]->id.tag & LIB_TAG_NO_MAIN) ? ADT_RECALC_ALL : ADT_RECALC_DRIVERS;
+				BKE_animsys_evaluate_animdata(scene, &me->mdim[i]->id, me->mdim[i]->adt, BKE_scene_frame_get(scene), recalc);
 			}
 		}
 	}
@@ -69,6 +69,7 @@
 
 #include "mechanical_geometry.h"
 #include "mesh_dimensions.h"
+#include "mesh_dimensions_driven.h"
 #include "mesh_references.h"
 
 #ifdef WITH_LEGACY_DEPSGRAPH
@@ -205,7 +206,8 @@ void BKE_object_handle_data_update(EvaluationContext *eval_ctx,
 			// This occur when needed to change the dimension value from drivers
 			bool temp_em = false;
 			if (em == NULL && me->totdim) {
-				if (me->totdim) {
+				// Applied on a BMesh kept on the mesh, without converting the mesh on every update
+				if (!mesh_dimensions_driven_update(scene, ob)) {
 					for (int i=0;i<me->totdim;i++) {
 						if (me->mdim[i]->adt) {
 							//const bool use_key_index = mesh_needs_keyindex(ob->data);
@@ -222,18 +224,24 @@ void BKE_object_handle_data_update(EvaluationContext *eval_ctx,
 
 			if (em) {
 				BMesh *bm = em->bm;
-				BMDim *edm;
+				BMDim *edm, **dims;
 				BMIter iter;
 				int i =0;
+				int dims_tot;
+
+				// Changed dimension values, applied together
+				dims_tot = get_pending_dimensions(bm, &dims);
+				if (dims_tot) {
+					apply_dimension_values(bm, dims, dims_tot, scene->toolsettings->dimension_constraints, scene);
+					MEM_freeN(dims);
+				}
+
 				BM_ITER_MESH_INDEX (edm, &iter, bm, BM_DIMS_OF_MESH, i) {
 					// check diension data udate
 					if (get_dimension_value (edm) != edm->mdim->value) {
 						if (edm->mdim->value == edm->mdim->value_pr) {
 							// Changed vertex position
 							edm->mdim->value =  get_dimension_value (edm);
-						} else {
-							// Changed dimension value
-							apply_dimension_value(bm,edm,edm->mdim->value,scene->toolsettings);
 						}
 					}
 
@@ -263,7 +271,8 @@ void BKE_object_handle_data_update(EvaluationContext *eval_ctx,
 								BLI_assert(0);
 						}
 					}
-					dimension_data_update(em->bm, edm, scene);
+					// Only dimensions with moved vertices or placement
+					dimension_data_update_check(em->bm, edm, scene);
 				}
 			}
 			if (temp_em) {
@@ -276,7 +285,7 @@ void BKE_object_handle_data_update(EvaluationContext *eval_ctx,
 #endif
 #ifdef WITH_MECHANICAL_GEOMETRY
 			if (em && scene->geom_enabled && ob->geom_enabled && !G.moving) {
-				mechanical_update_mesh_geometry(em->bm);
+				mechanical_update_mesh_geometry_dirty(em->bm);
 			}
 #endif
 			if (em) {
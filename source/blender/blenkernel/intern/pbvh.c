@@ -57,6 +57,9 @@
 
 #define PBVH_THREADED_LIMIT 4
 
+/* Primitives to build a PBVH on threads */
+#define PBVH_BUILD_THREADED_LIMIT 10000
+
 typedef struct PBVHStack {
 	PBVHNode *node;
 	bool revisiting;
@@ -514,6 +517,49 @@ static void pbvh_build(PBVH *bvh, BB *cb, BBC *prim_bbc, int totprim)
 	build_sub(bvh, 0, cb, prim_bbc, 0, totprim);
 }
 
+typedef struct PBVHBuildData {
+	PBVH *bvh;
+	BBC *prim_bbc;
+} PBVHBuildData;
+
+/* Stores the AABB and AABB centroid of a face, expanding the bounds of centroids. */
+static void pbvh_build_mesh_prim_bbc_cb(void *userdata, const int i, float r_min[3], float r_max[3])
+{
+	PBVHBuildData *data = userdata;
+	PBVH *bvh = data->bvh;
+	const MLoopTri *lt = &bvh->looptri[i];
+	const int sides = 3;
+	BBC *bbc = data->prim_bbc + i;
+
+	BB_reset((BB *)bbc);
+
+	for (int j = 0; j < sides; ++j)
+		BB_expand((BB *)bbc, bvh->verts[bvh->mloop[lt->tri[j]].v].co);
+
+	BBC_update_centroid(bbc);
+
+	minmax_v3v3_v3(r_min, r_max, bbc->bcentroid);
+}
+
+/* Stores the AABB and AABB centroid of a grid, expanding the bounds of centroids. */
+static void pbvh_build_grids_prim_bbc_cb(void *userdata, const int i, float r_min[3], float r_max[3])
+{
+	PBVHBuildData *data = userdata;
+	PBVH *bvh = data->bvh;
+	const CCGKey *key = &bvh->gridkey;
+	CCGElem *grid = bvh->grids[i];
+	BBC *bbc = data->prim_bbc + i;
+
+	BB_reset((BB *)bbc);
+
+	for (int j = 0; j < key->grid_size * key->grid_size; ++j)
+		BB_expand((BB *)bbc, CCG_elem_offset_co(key, grid, j));
+
+	BBC_update_centroid(bbc);
+
+	minmax_v3v3_v3(r_min, r_max, bbc->bcentroid);
+}
+
 /**
  * Do a full rebuild with on Mesh data structure.
  *
@@ -543,20 +589,10 @@ void BKE_pbvh_build_mesh(
 	/* For each face, store the AABB and the AABB centroid */
 	prim_bbc = MEM_mallocN(sizeof(BBC) * looptri_num, "prim_bbc");
 
-	for (int i = 0; i < looptri_num; ++i) {
-		const MLoopTri *lt = &looptri[i];
-		const int sides = 3;
-		BBC *bbc = prim_bbc + i;
-
-		BB_reset((BB *)bbc);
-
-		for (int j = 0; j < sides; ++j)
-			BB_expand((BB *)bbc, verts[bvh->mloop[lt->tri[j]].v].co);
+	PBVHBuildData data = {.bvh = bvh, .prim_bbc = prim_bbc};
 
-		BBC_update_centroid(bbc);
-
-		BB_expand(&cb, bbc->bcentroid);
-	}
+	BLI_task_parallel_range_minmax_v3(0, looptri_num, &data, pbvh_build_mesh_prim_bbc_cb, cb.bmin, cb.bmax,
+	                                  looptri_num > PBVH_BUILD_THREADED_LIMIT);
 
 	if (looptri_num)
 		pbvh_build(bvh, &cb, prim_bbc, looptri_num);
@@ -586,19 +622,10 @@ void BKE_pbvh_build_grids(PBVH *bvh, CCGElem **grids,
 	/* For each grid, store the AABB and the AABB centroid */
 	BBC *prim_bbc = MEM_mallocN(sizeof(BBC) * totgrid, "prim_bbc");
 
-	for (int i = 0; i < totgrid; ++i) {
-		CCGElem *grid = grids[i];
-		BBC *bbc = prim_bbc + i;
-
-		BB_reset((BB *)bbc);
+	PBVHBuildData data = {.bvh = bvh, .prim_bbc = prim_bbc};
 
-		for (int j = 0; j < gridsize * gridsize; ++j)
-			BB_expand((BB *)bbc, CCG_elem_offset_co(key, grid, j));
-
-		BBC_update_centroid(bbc);
-
-		BB_expand(&cb, bbc->bcentroid);
-	}
+	BLI_task_parallel_range_minmax_v3(0, totgrid, &data, pbvh_build_grids_prim_bbc_cb, cb.bmin, cb.bmax,
+	                                  totgrid > PBVH_BUILD_THREADED_LIMIT / (gridsize * gridsize));
 
 	if (totgrid)
 		pbvh_build(bvh, &cb, prim_bbc, totgrid);
@@ -932,7 +959,8 @@ typedef struct PBVHUpdateData {
 	int flag;
 } PBVHUpdateData;
 
-static void pbvh_update_normals_accum_task_cb(void *userdata, const int n)
+static void pbvh_update_normals_accum_task_cb(void *userdata, void *UNUSED(userdata_chunk), const int n,
+                                              const int UNUSED(thread_id))
 {
 	PBVHUpdateData *data = userdata;
 
@@ -985,7 +1013,8 @@ static void pbvh_update_normals_accum_task_cb(void *userdata, const int n)
 	}
 }
 
-static void pbvh_update_normals_store_task_cb(void *userdata, const int n)
+static void pbvh_update_normals_store_task_cb(void *userdata, void *UNUSED(userdata_chunk), const int n,
+                                              const int UNUSED(thread_id))
 {
 	PBVHUpdateData *data = userdata;
 	PBVH *bvh = data->bvh;
@@ -1046,14 +1075,18 @@ static void pbvh_update_normals(PBVH *bvh, PBVHNode **nodes,
 	    .fnors = fnors, .vnors = vnors,
 	};
 
-	BLI_task_parallel_range(0, totnode, &data, pbvh_update_normals_accum_task_cb, totnode > PBVH_THREADED_LIMIT);
+	/* Only nodes flagged for update have work to do, dynamic scheduling spreads them over threads. */
+	BLI_task_parallel_range_ex(0, totnode, &data, NULL, 0, pbvh_update_normals_accum_task_cb,
+	                           totnode > PBVH_THREADED_LIMIT, true);
 
-	BLI_task_parallel_range(0, totnode, &data, pbvh_update_normals_store_task_cb, totnode > PBVH_THREADED_LIMIT);
+	BLI_task_parallel_range_ex(0, totnode, &data, NULL, 0, pbvh_update_normals_store_task_cb,
+	                           totnode > PBVH_THREADED_LIMIT, true);
 
 	MEM_freeN(vnors);
 }
 
-static void pbvh_update_BB_redraw_task_cb(void *userdata, const int n)
+static void pbvh_update_BB_redraw_task_cb(void *userdata, void *UNUSED(userdata_chunk), const int n,
+                                          const int UNUSED(thread_id))
 {
 	PBVHUpdateData *data = userdata;
 	PBVH *bvh = data->bvh;
@@ -1080,7 +1113,8 @@ void pbvh_update_BB_redraw(PBVH *bvh, PBVHNode **nodes, int totnode, int flag)
 	    .flag = flag,
 	};
 
-	BLI_task_parallel_range(0, totnode, &data, pbvh_update_BB_redraw_task_cb, totnode > PBVH_THREADED_LIMIT);
+	BLI_task_parallel_range_ex(0, totnode, &data, NULL, 0, pbvh_update_BB_redraw_task_cb,
+	                           totnode > PBVH_THREADED_LIMIT, true);
 }
 
 static void pbvh_update_draw_buffers(PBVH *bvh, PBVHNode **nodes, int totnode)
@@ -56,6 +56,7 @@ void               *BLI_memarena_alloc(struct MemArena *ma, size_t size) ATTR_WA
 void               *BLI_memarena_calloc(struct MemArena *ma, size_t size) ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1) ATTR_MALLOC ATTR_ALLOC_SIZE(2);
 
 void BLI_memarena_clear(MemArena *ma) ATTR_NONNULL(1);
+size_t BLI_memarena_size_get(const MemArena *ma) ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
 
 #ifdef __cplusplus
 }
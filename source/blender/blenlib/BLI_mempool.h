@@ -53,6 +53,14 @@ void         BLI_mempool_clear_ex(BLI_mempool *pool,
                                   const int totelem_reserve) ATTR_NONNULL(1);
 void         BLI_mempool_clear(BLI_mempool *pool) ATTR_NONNULL(1);
 void         BLI_mempool_destroy(BLI_mempool *pool) ATTR_NONNULL(1);
+
+void         BLI_mempool_concurrent_begin(BLI_mempool *pool, const unsigned int num_threads,
+                                          const unsigned int totelem_reserve) ATTR_NONNULL(1);
+void         BLI_mempool_concurrent_end(BLI_mempool *pool) ATTR_NONNULL(1);
+void        *BLI_mempool_alloc_thread(BLI_mempool *pool, const int thread_id) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
+void        *BLI_mempool_calloc_thread(BLI_mempool *pool, const int thread_id) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
+void         BLI_mempool_free_thread(BLI_mempool *pool, void *addr, const int thread_id) ATTR_NONNULL(1, 2);
+
 int          BLI_mempool_count(BLI_mempool *pool) ATTR_NONNULL(1);
 void        *BLI_mempool_findelem(BLI_mempool *pool, unsigned int index) ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
 
@@ -0,0 +1,146 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+#ifndef __BLI_RHASH_H__
+#define __BLI_RHASH_H__
+
+/** \file BLI_rhash.h
+ *  \ingroup bli
+ *
+ * Open addressing (robin-hood) alternative to #GHash and #GSet,
+ * using the same hash and compare callbacks.
+ *
+ * \warning Unlike #GHash, inserting or removing may move other entries,
+ * pointers returned by #BLI_rhash_lookup_p & #BLI_rhash_ensure_p are only valid until the next change.
+ */
+
+#include "BLI_sys_types.h" /* for bool */
+#include "BLI_compiler_attrs.h"
+#include "BLI_ghash.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct RHash RHash;
+
+typedef struct RHashIterator {
+	RHash *rh;
+	unsigned int curr_bucket;
+} RHashIterator;
+
+/* *** */
+
+RHash *BLI_rhash_new_ex(GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info,
+                        const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+RHash *BLI_rhash_new(GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+void   BLI_rhash_free(RHash *rh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp);
+void   BLI_rhash_reserve(RHash *rh, const unsigned int nentries_reserve);
+void   BLI_rhash_insert(RHash *rh, void *key, void *val);
+bool   BLI_rhash_reinsert(RHash *rh, void *key, void *val, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp);
+void  *BLI_rhash_lookup(RHash *rh, const void *key) ATTR_WARN_UNUSED_RESULT;
+void  *BLI_rhash_lookup_default(RHash *rh, const void *key, void *val_default) ATTR_WARN_UNUSED_RESULT;
+void **BLI_rhash_lookup_p(RHash *rh, const void *key) ATTR_WARN_UNUSED_RESULT;
+bool   BLI_rhash_ensure_p(RHash *rh, void *key, void ***r_val) ATTR_WARN_UNUSED_RESULT;
+bool   BLI_rhash_remove(RHash *rh, const void *key, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp);
+void   BLI_rhash_clear(RHash *rh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp);
+void   BLI_rhash_clear_ex(RHash *rh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp,
+                          const unsigned int nentries_reserve);
+void  *BLI_rhash_popkey(RHash *rh, const void *key, GHashKeyFreeFP keyfreefp) ATTR_WARN_UNUSED_RESULT;
+bool   BLI_rhash_haskey(RHash *rh, const void *key) ATTR_WARN_UNUSED_RESULT;
+unsigned int BLI_rhash_size(RHash *rh) ATTR_WARN_UNUSED_RESULT;
+
+RHash *BLI_rhash_ptr_new_ex(const char *info,
+                            const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+RHash *BLI_rhash_ptr_new(const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+RHash *BLI_rhash_int_new_ex(const char *info,
+                            const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+RHash *BLI_rhash_int_new(const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+RHash *BLI_rhash_str_new_ex(const char *info,
+                            const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+RHash *BLI_rhash_str_new(const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+
+/* *** */
+
+void  BLI_rhashIterator_init(RHashIterator *rhi, RHash *rh);
+void  BLI_rhashIterator_step(RHashIterator *rhi);
+void *BLI_rhashIterator_getKey(RHashIterator *rhi) ATTR_WARN_UNUSED_RESULT;
+void *BLI_rhashIterator_getValue(RHashIterator *rhi) ATTR_WARN_UNUSED_RESULT;
+void **BLI_rhashIterator_getValue_p(RHashIterator *rhi) ATTR_WARN_UNUSED_RESULT;
+bool  BLI_rhashIterator_done(RHashIterator *rhi) ATTR_WARN_UNUSED_RESULT;
+
+#define RHASH_ITER(rh_iter_, rhash_) \
+	for (BLI_rhashIterator_init(&rh_iter_, rhash_); \
+	     BLI_rhashIterator_done(&rh_iter_) == false; \
+	     BLI_rhashIterator_step(&rh_iter_))
+
+/* *** */
+
+typedef struct RSet RSet;
+
+/* so we can cast but compiler sees as different */
+typedef struct RSetIterator {
+	RHashIterator _rhi;
+} RSetIterator;
+
+RSet  *BLI_rset_new_ex(GSetHashFP hashfp, GSetCmpFP cmpfp, const char *info,
+                       const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+RSet  *BLI_rset_new(GSetHashFP hashfp, GSetCmpFP cmpfp, const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+void   BLI_rset_free(RSet *rs, GSetKeyFreeFP keyfreefp);
+void   BLI_rset_reserve(RSet *rs, const unsigned int nentries_reserve);
+void   BLI_rset_insert(RSet *rs, void *key);
+bool   BLI_rset_add(RSet *rs, void *key);
+bool   BLI_rset_reinsert(RSet *rs, void *key, GSetKeyFreeFP keyfreefp);
+bool   BLI_rset_haskey(RSet *rs, const void *key) ATTR_WARN_UNUSED_RESULT;
+bool   BLI_rset_remove(RSet *rs, const void *key, GSetKeyFreeFP keyfreefp);
+void   BLI_rset_clear(RSet *rs, GSetKeyFreeFP keyfreefp);
+void   BLI_rset_clear_ex(RSet *rs, GSetKeyFreeFP keyfreefp,
+                         const unsigned int nentries_reserve);
+unsigned int BLI_rset_size(RSet *rs) ATTR_WARN_UNUSED_RESULT;
+
+RSet  *BLI_rset_ptr_new_ex(const char *info, const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+RSet  *BLI_rset_ptr_new(const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+RSet  *BLI_rset_int_new_ex(const char *info, const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+RSet  *BLI_rset_int_new(const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+RSet  *BLI_rset_str_new_ex(const char *info, const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+RSet  *BLI_rset_str_new(const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+
+BLI_INLINE void BLI_rsetIterator_init(RSetIterator *rsi, RSet *rs) { BLI_rhashIterator_init((RHashIterator *)rsi, (RHash *)rs); }
+BLI_INLINE void BLI_rsetIterator_step(RSetIterator *rsi) { BLI_rhashIterator_step((RHashIterator *)rsi); }
+BLI_INLINE void *BLI_rsetIterator_getKey(RSetIterator *rsi) { return BLI_rhashIterator_getKey((RHashIterator *)rsi); }
+BLI_INLINE bool BLI_rsetIterator_done(RSetIterator *rsi) { return BLI_rhashIterator_done((RHashIterator *)rsi); }
+
+#define RSET_ITER(rs_iter_, rset_) \
+	for (BLI_rsetIterator_init(&rs_iter_, rset_); \
+	     BLI_rsetIterator_done(&rs_iter_) == false; \
+	     BLI_rsetIterator_step(&rs_iter_))
+
+/* For testing, debugging only */
+#ifdef GHASH_INTERNAL_API
+int BLI_rhash_buckets_size(RHash *rh);
+double BLI_rhash_calc_quality_ex(RHash *rh, double *r_load, int *r_probe_max);
+double BLI_rhash_calc_quality(RHash *rh);
+#endif  /* GHASH_INTERNAL_API */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BLI_RHASH_H__ */
@@ -70,6 +70,8 @@ int BLI_task_scheduler_num_threads(TaskScheduler *scheduler);
  * be launched.
  */
 
+/* High priority tasks pushed from a scheduler thread go to its own deque, which
+ * threads look at before the queue. Low priority ones always go to the queue tail. */
 typedef enum TaskPriority {
 	TASK_PRIORITY_LOW,
 	TASK_PRIORITY_HIGH
@@ -94,7 +96,9 @@ void BLI_task_pool_push_from_thread(TaskPool *pool, TaskRunFunction run,
 
 /* work and wait until all tasks are done */
 void BLI_task_pool_work_and_wait(TaskPool *pool);
-/* cancel all tasks, keep worker threads running */
+/* cancel all tasks, keep worker threads running.
+ * Tasks already running, and tasks they push while canceling, run with
+ * BLI_task_pool_canceled() returning true. */
 void BLI_task_pool_cancel(TaskPool *pool);
 
 /* for worker threads, test if canceled */
@@ -141,6 +145,44 @@ void BLI_task_parallel_range_finalize(
         const bool use_threading,
         const bool use_dynamic_scheduling);
 
+/* Parallel reductions, with dynamic scheduling.
+ * Float sums are done on fixed blocks of iterations, giving the same result on every run. */
+typedef float (*TaskParallelRangeFloatFunc)(void *userdata, const int iter);
+typedef int (*TaskParallelRangeIntFunc)(void *userdata, const int iter);
+typedef void (*TaskParallelRangeMinMaxFunc)(void *userdata, const int iter, float r_min[3], float r_max[3]);
+typedef struct TaskParallelConcat TaskParallelConcat;
+typedef void (*TaskParallelRangeConcatFunc)(void *userdata, const int iter, TaskParallelConcat *concat);
+float BLI_task_parallel_range_sum_f(
+        int start, int stop,
+        void *userdata,
+        TaskParallelRangeFloatFunc func,
+        const bool use_threading);
+int BLI_task_parallel_range_sum_i(
+        int start, int stop,
+        void *userdata,
+        TaskParallelRangeIntFunc func,
+        const bool use_threading);
+void BLI_task_parallel_range_minmax_f(
+        int start, int stop,
+        void *userdata,
+        TaskParallelRangeFloatFunc func,
+        float *r_min, float *r_max,
+        const bool use_threading);
+void BLI_task_parallel_range_minmax_v3(
+        int start, int stop,
+        void *userdata,
+        TaskParallelRangeMinMaxFunc func,
+        float r_min[3], float r_max[3],
+        const bool use_threading);
+void *BLI_task_parallel_range_concat(
+        int start, int stop,
+        void *userdata,
+        const size_t elem_size,
+        TaskParallelRangeConcatFunc func,
+        int *r_len,
+        const bool use_threading);
+void *BLI_task_parallel_concat_append(TaskParallelConcat *concat);
+
 typedef void (*TaskParallelListbaseFunc)(void *userdata,
                                          struct Link *iter,
                                          int index);
@@ -196,3 +196,16 @@ void BLI_memarena_clear(MemArena *ma)
 #endif
 
 }
+
+/**
+ * Total size of the buffers held by the arena, to decide if it's worth keeping for reuse.
+ */
+size_t BLI_memarena_size_get(const MemArena *ma)
+{
+	size_t size = 0;
+
+	for (LinkNode *node = ma->bufs; node; node = node->next) {
+		size += MEM_allocN_len(node->link);
+	}
+	return size;
+}
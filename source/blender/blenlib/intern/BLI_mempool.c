@@ -36,6 +36,8 @@
  * - Freeing chunks.
  * - Iterating over allocated chunks
  *   (optionally when using the #BLI_MEMPOOL_ALLOW_ITER flag).
+ * - Allocating from many threads between #BLI_mempool_concurrent_begin & #BLI_mempool_concurrent_end,
+ *   each thread has its own free list and chunks, which are merged into the pool at the end.
  */
 
 #include <string.h>
@@ -47,6 +49,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #include "BLI_strict_flags.h"  /* keep last */
 
 #ifdef WITH_MEM_VALGRIND
@@ -118,6 +122,23 @@ typedef struct BLI_mempool_chunk {
 #endif
 } BLI_mempool_chunk;
 
+/**
+ * Allocation state of one thread between #BLI_mempool_concurrent_begin & #BLI_mempool_concurrent_end.
+ */
+typedef struct BLI_mempool_thread {
+	BLI_freenode *free;
+	/* first node pushed on an empty \a free, so the list can be merged without walking it */
+	BLI_freenode *free_tail;
+	/* chunks acquired by this thread, appended to the pool at the end */
+	BLI_mempool_chunk *chunks;
+	BLI_mempool_chunk *chunk_tail;
+	/* allocs less frees, negative when freeing elements of other threads */
+	int totused;
+
+	/* keep members written by different threads on different cache lines */
+	char _pad[64];
+} BLI_mempool_thread;
+
 /**
  * The mempool, stores and tracks memory \a chunks and elements within those chunks \a free.
  */
@@ -139,6 +160,14 @@ struct BLI_mempool {
 #ifdef USE_TOTALLOC
 	unsigned int totalloc;          /* number of elements allocated in total */
 #endif
+
+	/* concurrent allocation, NULL otherwise */
+	BLI_mempool_thread *threads;
+	unsigned int totthread;
+	/* chunks allocated in advance, taken by threads with an atomic increment of 'chunks_reserve_used' */
+	BLI_mempool_chunk **chunks_reserve;
+	unsigned int chunks_reserve_len;
+	unsigned int chunks_reserve_used;
 };
 
 #define MEMPOOL_ELEM_SIZE_MIN (sizeof(void *) * 2)
@@ -205,6 +234,40 @@ static BLI_mempool_chunk *mempool_chunk_alloc(BLI_mempool *pool)
 	return mpchunk;
 }
 
+/**
+ * Link the elements of \a mpchunk into a free list, starting at ``CHUNK_DATA(mpchunk)``.
+ *
+ * \return The last element of the list.
+ */
+static BLI_freenode *mempool_chunk_init_free(BLI_mempool *pool, BLI_mempool_chunk *mpchunk)
+{
+	const unsigned int esize = pool->esize;
+	BLI_freenode *curnode = CHUNK_DATA(mpchunk);
+	unsigned int j;
+
+	/* loop through the allocated data, building the pointer structures */
+	j = pool->pchunk;
+	if (pool->flag & BLI_MEMPOOL_ALLOW_ITER) {
+		while (j--) {
+			curnode->next = NODE_STEP_NEXT(curnode);
+			curnode->freeword = FREEWORD;
+			curnode = curnode->next;
+		}
+	}
+	else {
+		while (j--) {
+			curnode->next = NODE_STEP_NEXT(curnode);
+			curnode = curnode->next;
+		}
+	}
+
+	/* terminate the list (rewind one) */
+	curnode = NODE_STEP_PREV(curnode);
+	curnode->next = NULL;
+
+	return curnode;
+}
+
 /**
  * Initialize a chunk and add into \a pool->chunks
  *
@@ -217,9 +280,7 @@ static BLI_mempool_chunk *mempool_chunk_alloc(BLI_mempool *pool)
 static BLI_freenode *mempool_chunk_add(BLI_mempool *pool, BLI_mempool_chunk *mpchunk,
                                        BLI_freenode *lasttail)
 {
-	const unsigned int esize = pool->esize;
 	BLI_freenode *curnode = CHUNK_DATA(mpchunk);
-	unsigned int j;
 
 	/* append */
 	if (pool->chunk_tail) {
@@ -237,26 +298,8 @@ static BLI_freenode *mempool_chunk_add(BLI_mempool *pool, BLI_mempool_chunk *mpc
 		pool->free = curnode;
 	}
 
-	/* loop through the allocated data, building the pointer structures */
-	j = pool->pchunk;
-	if (pool->flag & BLI_MEMPOOL_ALLOW_ITER) {
-		while (j--) {
-			curnode->next = NODE_STEP_NEXT(curnode);
-			curnode->freeword = FREEWORD;
-			curnode = curnode->next;
-		}
-	}
-	else {
-		while (j--) {
-			curnode->next = NODE_STEP_NEXT(curnode);
-			curnode = curnode->next;
-		}
-	}
-
-	/* terminate the list (rewind one)
-	 * will be overwritten if 'curnode' gets passed in again as 'lasttail' */
-	curnode = NODE_STEP_PREV(curnode);
-	curnode->next = NULL;
+	/* the terminating NULL will be overwritten if 'curnode' gets passed in again as 'lasttail' */
+	curnode = mempool_chunk_init_free(pool, mpchunk);
 
 #ifdef USE_TOTALLOC
 	pool->totalloc += pool->pchunk;
@@ -335,6 +378,12 @@ BLI_mempool *BLI_mempool_create(unsigned int esize, unsigned int totelem,
 #endif
 	pool->totused = 0;
 
+	pool->threads = NULL;
+	pool->totthread = 0;
+	pool->chunks_reserve = NULL;
+	pool->chunks_reserve_len = 0;
+	pool->chunks_reserve_used = 0;
+
 	if (totelem) {
 		/* allocate the actual chunks */
 		for (i = 0; i < maxchunks; i++) {
@@ -354,6 +403,8 @@ void *BLI_mempool_alloc(BLI_mempool *pool)
 {
 	BLI_freenode *free_pop;
 
+	BLI_assert(pool->threads == NULL);
+
 	if (UNLIKELY(pool->free == NULL)) {
 		/* need to allocate a new chunk */
 		BLI_mempool_chunk *mpchunk = mempool_chunk_alloc(pool);
@@ -394,6 +445,8 @@ void BLI_mempool_free(BLI_mempool *pool, void *addr)
 {
 	BLI_freenode *newhead = addr;
 
+	BLI_assert(pool->threads == NULL);
+
 #ifndef NDEBUG
 	{
 		BLI_mempool_chunk *chunk;
@@ -472,6 +525,225 @@ void BLI_mempool_free(BLI_mempool *pool, void *addr)
 	}
 }
 
+/* Concurrent Allocation
+ *
+ * Between #BLI_mempool_concurrent_begin & #BLI_mempool_concurrent_end,
+ * elements are allocated & freed with the ``_thread`` functions only,
+ * passing the thread index from the task scheduler.
+ *
+ * Threads never share a free list, new chunks come from the reserve
+ * (an atomic increment) or are allocated by the thread itself.
+ * After the end the pool is as if all elements were allocated by #BLI_mempool_alloc,
+ * iteration order follows chunks, not the order elements were allocated in.
+ */
+
+/**
+ * Start concurrent allocation.
+ *
+ * \param num_threads  Number of thread indices used, see #BLI_task_scheduler_num_threads.
+ * \param totelem_reserve  Elements to allocate chunks for in advance,
+ * so threads don't need to allocate memory themselves.
+ */
+void BLI_mempool_concurrent_begin(BLI_mempool *pool, const unsigned int num_threads,
+                                  const unsigned int totelem_reserve)
+{
+	unsigned int i;
+
+	BLI_assert(pool->threads == NULL);
+	BLI_assert(num_threads != 0);
+
+	pool->threads = MEM_callocN(sizeof(*pool->threads) * num_threads, __func__);
+	pool->totthread = num_threads;
+
+	/* free elements stay with the calling thread */
+	if (pool->free) {
+		BLI_freenode *tail = pool->free;
+		while (tail->next) {
+			tail = tail->next;
+		}
+		pool->threads[0].free = pool->free;
+		pool->threads[0].free_tail = tail;
+		pool->free = NULL;
+	}
+
+	pool->chunks_reserve_len = totelem_reserve ? (totelem_reserve / pool->pchunk) + 1 : 0;
+	pool->chunks_reserve_used = 0;
+	if (pool->chunks_reserve_len) {
+		pool->chunks_reserve = MEM_mallocN(sizeof(*pool->chunks_reserve) * pool->chunks_reserve_len, __func__);
+		for (i = 0; i < pool->chunks_reserve_len; i++) {
+			pool->chunks_reserve[i] = mempool_chunk_alloc(pool);
+		}
+	}
+}
+
+static void mempool_thread_chunk_append(BLI_mempool_thread *mpt, BLI_mempool_chunk *mpchunk)
+{
+	mpchunk->next = NULL;
+	if (mpt->chunk_tail) {
+		mpt->chunk_tail->next = mpchunk;
+	}
+	else {
+		mpt->chunks = mpchunk;
+	}
+	mpt->chunk_tail = mpchunk;
+}
+
+/**
+ * Give a new chunk to a thread which used all its free elements.
+ */
+static void mempool_thread_chunk_acquire(BLI_mempool *pool, BLI_mempool_thread *mpt)
+{
+	BLI_mempool_chunk *mpchunk = NULL;
+
+	if (pool->chunks_reserve_used < pool->chunks_reserve_len) {
+		const unsigned int index = atomic_fetch_and_add_u(&pool->chunks_reserve_used, 1);
+		if (index < pool->chunks_reserve_len) {
+			mpchunk = pool->chunks_reserve[index];
+		}
+	}
+	if (mpchunk == NULL) {
+		mpchunk = mempool_chunk_alloc(pool);
+	}
+
+	mempool_thread_chunk_append(mpt, mpchunk);
+
+	BLI_assert(mpt->free == NULL);
+	mpt->free = CHUNK_DATA(mpchunk);
+	mpt->free_tail = mempool_chunk_init_free(pool, mpchunk);
+}
+
+void *BLI_mempool_alloc_thread(BLI_mempool *pool, const int thread_id)
+{
+	BLI_mempool_thread *mpt;
+	BLI_freenode *free_pop;
+
+	BLI_assert(pool->threads && ((unsigned int)thread_id < pool->totthread));
+	mpt = &pool->threads[thread_id];
+
+	if (UNLIKELY(mpt->free == NULL)) {
+		mempool_thread_chunk_acquire(pool, mpt);
+	}
+
+	free_pop = mpt->free;
+
+	if (pool->flag & BLI_MEMPOOL_ALLOW_ITER) {
+		free_pop->freeword = USEDWORD;
+	}
+
+	mpt->free = free_pop->next;
+	mpt->totused++;
+
+#ifdef WITH_MEM_VALGRIND
+	VALGRIND_MEMPOOL_ALLOC(pool, free_pop, pool->esize);
+#endif
+
+	return (void *)free_pop;
+}
+
+void *BLI_mempool_calloc_thread(BLI_mempool *pool, const int thread_id)
+{
+	void *retval = BLI_mempool_alloc_thread(pool, thread_id);
+	memset(retval, 0, (size_t)pool->esize);
+	return retval;
+}
+
+/**
+ * Free an element from any thread, it may have been allocated by another thread.
+ *
+ * \note Unlike #BLI_mempool_free, chunks are never freed here.
+ */
+void BLI_mempool_free_thread(BLI_mempool *pool, void *addr, const int thread_id)
+{
+	BLI_mempool_thread *mpt;
+	BLI_freenode *newhead = addr;
+
+	BLI_assert(pool->threads && ((unsigned int)thread_id < pool->totthread));
+	mpt = &pool->threads[thread_id];
+
+	if (pool->flag & BLI_MEMPOOL_ALLOW_ITER) {
+		/* this will detect double free's */
+		BLI_assert(newhead->freeword != FREEWORD);
+		newhead->freeword = FREEWORD;
+	}
+
+	if (mpt->free == NULL) {
+		mpt->free_tail = newhead;
+	}
+	newhead->next = mpt->free;
+	mpt->free = newhead;
+
+	mpt->totused--;
+
+#ifdef WITH_MEM_VALGRIND
+	VALGRIND_MEMPOOL_FREE(pool, addr);
+#endif
+}
+
+/**
+ * End concurrent allocation, moving the chunks & free elements of all threads into the pool.
+ */
+void BLI_mempool_concurrent_end(BLI_mempool *pool)
+{
+	int totused = (int)pool->totused;
+	unsigned int i;
+
+	BLI_assert(pool->threads != NULL);
+
+	/* reserved chunks no thread took, only free elements */
+	if (pool->chunks_reserve_used < pool->chunks_reserve_len) {
+		BLI_mempool_thread *mpt = &pool->threads[0];
+		for (i = pool->chunks_reserve_used; i < pool->chunks_reserve_len; i++) {
+			BLI_mempool_chunk *mpchunk = pool->chunks_reserve[i];
+			BLI_freenode *tail;
+
+			mempool_thread_chunk_append(mpt, mpchunk);
+			tail = mempool_chunk_init_free(pool, mpchunk);
+			tail->next = mpt->free;
+			if (mpt->free == NULL) {
+				mpt->free_tail = tail;
+			}
+			mpt->free = CHUNK_DATA(mpchunk);
+		}
+	}
+	MEM_SAFE_FREE(pool->chunks_reserve);
+	pool->chunks_reserve_len = 0;
+	pool->chunks_reserve_used = 0;
+
+	for (i = 0; i < pool->totthread; i++) {
+		BLI_mempool_thread *mpt = &pool->threads[i];
+
+		if (mpt->chunks) {
+#ifdef USE_TOTALLOC
+			BLI_mempool_chunk *mpchunk;
+			for (mpchunk = mpt->chunks; mpchunk; mpchunk = mpchunk->next) {
+				pool->totalloc += pool->pchunk;
+			}
+#endif
+			if (pool->chunk_tail) {
+				pool->chunk_tail->next = mpt->chunks;
+			}
+			else {
+				pool->chunks = mpt->chunks;
+			}
+			pool->chunk_tail = mpt->chunk_tail;
+		}
+
+		if (mpt->free) {
+			mpt->free_tail->next = pool->free;
+			pool->free = mpt->free;
+		}
+
+		totused += mpt->totused;
+	}
+
+	BLI_assert(totused >= 0);
+	pool->totused = (unsigned int)totused;
+
+	MEM_freeN(pool->threads);
+	pool->threads = NULL;
+	pool->totthread = 0;
+}
+
 int BLI_mempool_count(BLI_mempool *pool)
 {
 	return (int)pool->totused;
@@ -648,6 +920,8 @@ void BLI_mempool_clear_ex(BLI_mempool *pool, const int totelem_reserve)
 	BLI_mempool_chunk *chunks_temp;
 	BLI_freenode *lasttail = NULL;
 
+	BLI_assert(pool->threads == NULL);
+
 #ifdef WITH_MEM_VALGRIND
 	VALGRIND_DESTROY_MEMPOOL(pool);
 	VALGRIND_CREATE_MEMPOOL(pool, 0, false);
@@ -704,6 +978,8 @@ void BLI_mempool_clear(BLI_mempool *pool)
  */
 void BLI_mempool_destroy(BLI_mempool *pool)
 {
+	BLI_assert(pool->threads == NULL);
+
 	mempool_chunk_free_all(pool->chunks);
 
 #ifdef WITH_MEM_VALGRIND
@@ -0,0 +1,863 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file blender/blenlib/intern/BLI_rhash.c
+ *  \ingroup bli
+ *
+ * A general (pointer -> pointer) open addressing hash table, using robin-hood hashing.
+ *
+ * Buckets only hold the key, its full hash and its probe distance,
+ * so a lookup reads consecutive buckets instead of following #GHash entries,
+ * values are kept in an array aligned with the buckets (not allocated for #RSet).
+ *
+ * - Linear probing, an entry takes the bucket of any entry nearer to its own home bucket,
+ *   this keeps probes short at high loads and lets missing keys stop early.
+ * - Removing shifts the following entries back, there are no tombstones.
+ * - Power of two buckets, the hash is spread with a fibonacci multiply
+ *   so weak hashes (pointers, sequential integers) still use all buckets.
+ *
+ * Hashes created by the ``ptr`` & ``int`` constructors compare keys directly
+ * and hash them inline, without calling back into #GHashHashFP & #GHashCmpFP.
+ */
+
+#include <string.h>
+#include <limits.h>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_sys_types.h"  /* for intptr_t support */
+#include "BLI_utildefines.h"
+
+#define GHASH_INTERNAL_API
+#include "BLI_rhash.h"
+#include "BLI_strict_flags.h"
+
+#define RHASH_BUCKET_BIT_MIN 3
+#define RHASH_BUCKET_BIT_MAX 31
+
+/**
+ * Max load of 3/4 as #GHash, robin-hood hashing would allow higher loads
+ * but inserting gets slower than the memory saved is worth.
+ */
+#define RHASH_LIMIT_GROW(_nbkt) ((_nbkt) - ((_nbkt) >> 2))
+
+#define RHASH_BUCKET_NONE UINT_MAX
+
+enum {
+	RHASH_FLAG_IS_RSET = (1 << 0),  /* No value storage. */
+	RHASH_FLAG_KEY_PTR = (1 << 1),  /* Pointer keys, compared & hashed inline. */
+	RHASH_FLAG_KEY_INT = (1 << 2),  /* Integer keys, compared & hashed inline. */
+};
+
+typedef struct RHashBucket {
+	void *key;
+	unsigned int hash;
+	/* probe distance from the home bucket plus one, zero for empty buckets */
+	unsigned int dist;
+} RHashBucket;
+
+struct RHash {
+	GHashHashFP hashfp;
+	GHashCmpFP cmpfp;
+
+	RHashBucket *buckets;
+	/* aligned with buckets, NULL for RSet */
+	void **vals;
+	unsigned int nbuckets;
+	unsigned int bucket_mask, bucket_shift;
+	unsigned int limit_grow;
+
+	unsigned int nentries;
+	unsigned int flag;
+};
+
+
+/* -------------------------------------------------------------------- */
+/* RHash API */
+
+/** \name Internal Utility API
+ * \{ */
+
+BLI_INLINE unsigned int rhash_keyhash(const RHash *rh, const void *key)
+{
+	if (rh->flag & RHASH_FLAG_KEY_PTR) {
+		/* same as BLI_ghashutil_ptrhash */
+		size_t y = (size_t)key;
+		y = (y >> 4) | (y << (8 * sizeof(void *) - 4));
+		return (unsigned int)y;
+	}
+	else if (rh->flag & RHASH_FLAG_KEY_INT) {
+		/* spread by rhash_bucket_home */
+		return (unsigned int)(uintptr_t)key;
+	}
+	return rh->hashfp(key);
+}
+
+/**
+ * \return true when the keys are equal (unlike #GHashCmpFP).
+ */
+BLI_INLINE bool rhash_keyeq(const RHash *rh, const RHashBucket *b, const void *key, const unsigned int hash)
+{
+	if (rh->flag & (RHASH_FLAG_KEY_PTR | RHASH_FLAG_KEY_INT)) {
+		return (b->key == key);
+	}
+	return (b->hash == hash) && !rh->cmpfp(key, b->key);
+}
+
+BLI_INLINE unsigned int rhash_bucket_home(const RHash *rh, const unsigned int hash)
+{
+	/* fibonacci hashing, keep the high bits which depend on all bits of the hash */
+	return (hash * 2654435769u) >> rh->bucket_shift;
+}
+
+static unsigned int rhash_bucket_bit_for_size(const unsigned int nentries)
+{
+	unsigned int bucket_bit = RHASH_BUCKET_BIT_MIN;
+
+	while ((bucket_bit < RHASH_BUCKET_BIT_MAX) && (RHASH_LIMIT_GROW(1u << bucket_bit) < nentries)) {
+		bucket_bit++;
+	}
+	return bucket_bit;
+}
+
+static void rhash_buckets_alloc(RHash *rh, const unsigned int bucket_bit)
+{
+	rh->nbuckets = 1u << bucket_bit;
+	rh->bucket_mask = rh->nbuckets - 1;
+	rh->bucket_shift = 32 - bucket_bit;
+	rh->limit_grow = RHASH_LIMIT_GROW(rh->nbuckets);
+
+	rh->buckets = MEM_callocN(sizeof(*rh->buckets) * rh->nbuckets, "RHash buckets");
+	if ((rh->flag & RHASH_FLAG_IS_RSET) == 0) {
+		rh->vals = MEM_mallocN(sizeof(*rh->vals) * rh->nbuckets, "RHash values");
+	}
+}
+
+static void rhash_buckets_free(RHash *rh)
+{
+	MEM_freeN(rh->buckets);
+	if (rh->vals) {
+		MEM_freeN(rh->vals);
+		rh->vals = NULL;
+	}
+}
+
+/**
+ * Store an entry known not to be in the hash, entries nearer to their home bucket are moved forward.
+ *
+ * \return the bucket of the new entry.
+ */
+BLI_INLINE unsigned int rhash_insert_entry(RHash *rh, void *key, void *val, const unsigned int hash)
+{
+	RHashBucket entry = {key, hash, 1};
+	unsigned int i = rhash_bucket_home(rh, hash);
+	unsigned int i_result = RHASH_BUCKET_NONE;
+
+	for (;; i = (i + 1) & rh->bucket_mask, entry.dist++) {
+		RHashBucket *b = &rh->buckets[i];
+
+		if (b->dist == 0) {
+			*b = entry;
+			if (rh->vals) {
+				rh->vals[i] = val;
+			}
+			return (i_result != RHASH_BUCKET_NONE) ? i_result : i;
+		}
+		else if (b->dist < entry.dist) {
+			SWAP(RHashBucket, *b, entry);
+			if (rh->vals) {
+				SWAP(void *, rh->vals[i], val);
+			}
+			if (i_result == RHASH_BUCKET_NONE) {
+				i_result = i;
+			}
+		}
+	}
+}
+
+static void rhash_resize(RHash *rh, const unsigned int bucket_bit)
+{
+	RHashBucket *buckets_old = rh->buckets;
+	void **vals_old = rh->vals;
+	const unsigned int nbuckets_old = rh->nbuckets;
+	unsigned int i;
+
+	rh->vals = NULL;
+	rhash_buckets_alloc(rh, bucket_bit);
+
+	/* stored hashes, no need to call the hash function again */
+	for (i = 0; i < nbuckets_old; i++) {
+		if (buckets_old[i].dist) {
+			rhash_insert_entry(rh, buckets_old[i].key, vals_old ? vals_old[i] : NULL, buckets_old[i].hash);
+		}
+	}
+
+	MEM_freeN(buckets_old);
+	if (vals_old) {
+		MEM_freeN(vals_old);
+	}
+}
+
+/**
+ * Grow buckets to store \a nentries.
+ */
+BLI_INLINE void rhash_expand(RHash *rh, const unsigned int nentries)
+{
+	if (UNLIKELY(nentries > rh->limit_grow)) {
+		BLI_assert(rh->nbuckets < (1u << RHASH_BUCKET_BIT_MAX));
+		rhash_resize(rh, rhash_bucket_bit_for_size(nentries));
+	}
+}
+
+/**
+ * \return the bucket of \a key or #RHASH_BUCKET_NONE.
+ */
+BLI_INLINE unsigned int rhash_lookup_bucket(const RHash *rh, const void *key, const unsigned int hash)
+{
+	unsigned int i = rhash_bucket_home(rh, hash);
+	unsigned int dist;
+
+	for (dist = 1; ; i = (i + 1) & rh->bucket_mask, dist++) {
+		const RHashBucket *b = &rh->buckets[i];
+
+		/* empty, or an entry nearer to its home, the key would have taken its bucket */
+		if (b->dist < dist) {
+			return RHASH_BUCKET_NONE;
+		}
+		else if (rhash_keyeq(rh, b, key, hash)) {
+			return i;
+		}
+	}
+}
+
+/**
+ * Remove the entry at \a i, shifting back the following entries not in their home bucket.
+ */
+static void rhash_remove_bucket(RHash *rh, unsigned int i)
+{
+	unsigned int i_next = (i + 1) & rh->bucket_mask;
+
+	while (rh->buckets[i_next].dist > 1) {
+		rh->buckets[i] = rh->buckets[i_next];
+		rh->buckets[i].dist--;
+		if (rh->vals) {
+			rh->vals[i] = rh->vals[i_next];
+		}
+		i = i_next;
+		i_next = (i_next + 1) & rh->bucket_mask;
+	}
+
+	rh->buckets[i].key = NULL;
+	rh->buckets[i].dist = 0;
+	rh->nentries--;
+}
+
+BLI_INLINE void rhash_insert(RHash *rh, void *key, void *val)
+{
+	const unsigned int hash = rhash_keyhash(rh, key);
+
+	BLI_assert(rhash_lookup_bucket(rh, key, hash) == RHASH_BUCKET_NONE);
+
+	rhash_expand(rh, rh->nentries + 1);
+	rhash_insert_entry(rh, key, val, hash);
+	rh->nentries++;
+}
+
+BLI_INLINE bool rhash_insert_safe(
+        RHash *rh, void *key, void *val, const bool override,
+        GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	const unsigned int hash = rhash_keyhash(rh, key);
+	const unsigned int i = rhash_lookup_bucket(rh, key, hash);
+
+	if (i != RHASH_BUCKET_NONE) {
+		if (override) {
+			if (keyfreefp) {
+				keyfreefp(rh->buckets[i].key);
+			}
+			if (valfreefp) {
+				valfreefp(rh->vals[i]);
+			}
+			rh->buckets[i].key = key;
+			if (rh->vals) {
+				rh->vals[i] = val;
+			}
+		}
+		return false;
+	}
+
+	rhash_expand(rh, rh->nentries + 1);
+	rhash_insert_entry(rh, key, val, hash);
+	rh->nentries++;
+	return true;
+}
+
+static void rhash_free_cb(RHash *rh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	unsigned int i;
+
+	BLI_assert(keyfreefp || valfreefp);
+	BLI_assert(!valfreefp || rh->vals);
+
+	for (i = 0; i < rh->nbuckets; i++) {
+		if (rh->buckets[i].dist) {
+			if (keyfreefp) {
+				keyfreefp(rh->buckets[i].key);
+			}
+			if (valfreefp) {
+				valfreefp(rh->vals[i]);
+			}
+		}
+	}
+}
+
+static RHash *rhash_new(
+        GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info,
+        const unsigned int nentries_reserve, const unsigned int flag)
+{
+	RHash *rh = MEM_mallocN(sizeof(*rh), info);
+
+	rh->hashfp = hashfp;
+	rh->cmpfp = cmpfp;
+	rh->vals = NULL;
+	rh->nentries = 0;
+	rh->flag = flag;
+
+	rhash_buckets_alloc(rh, rhash_bucket_bit_for_size(nentries_reserve));
+
+	return rh;
+}
+
+static void rhash_clear(RHash *rh, const unsigned int nentries_reserve)
+{
+	const unsigned int bucket_bit = rhash_bucket_bit_for_size(nentries_reserve);
+
+	if (rh->nbuckets == (1u << bucket_bit)) {
+		memset(rh->buckets, 0, sizeof(*rh->buckets) * rh->nbuckets);
+	}
+	else {
+		rhash_buckets_free(rh);
+		rhash_buckets_alloc(rh, bucket_bit);
+	}
+	rh->nentries = 0;
+}
+
+/** \} */
+
+
+/** \name Public API
+ * \{ */
+
+/**
+ * Creates a new, empty RHash.
+ *
+ * \param hashfp  Hash callback.
+ * \param cmpfp  Comparison callback.
+ * \param info  Identifier string for the RHash.
+ * \param nentries_reserve  Optionally reserve the number of members that the hash will hold.
+ * Use this to avoid resizing buckets if the size is known or can be closely approximated.
+ * \return  An empty RHash.
+ */
+RHash *BLI_rhash_new_ex(GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info,
+                        const unsigned int nentries_reserve)
+{
+	return rhash_new(hashfp, cmpfp, info, nentries_reserve, 0);
+}
+
+/**
+ * Wraps #BLI_rhash_new_ex with zero entries reserved.
+ */
+RHash *BLI_rhash_new(GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info)
+{
+	return BLI_rhash_new_ex(hashfp, cmpfp, info, 0);
+}
+
+/**
+ * Reserve given amount of entries (resize \a rh accordingly if needed).
+ */
+void BLI_rhash_reserve(RHash *rh, const unsigned int nentries_reserve)
+{
+	rhash_expand(rh, nentries_reserve);
+}
+
+/**
+ * \return size of the RHash.
+ */
+unsigned int BLI_rhash_size(RHash *rh)
+{
+	return rh->nentries;
+}
+
+/**
+ * Insert a key/value pair into the \a rh.
+ *
+ * \note Duplicates are not checked,
+ * the caller is expected to ensure elements are unique.
+ */
+void BLI_rhash_insert(RHash *rh, void *key, void *val)
+{
+	rhash_insert(rh, key, val);
+}
+
+/**
+ * Inserts a new value to a key that may already be in the RHash.
+ *
+ * Avoids #BLI_rhash_remove, #BLI_rhash_insert calls (double lookups)
+ *
+ * \returns true if a new key has been added.
+ */
+bool BLI_rhash_reinsert(RHash *rh, void *key, void *val, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	return rhash_insert_safe(rh, key, val, true, keyfreefp, valfreefp);
+}
+
+/**
+ * Lookup the value of \a key in \a rh.
+ *
+ * \note When NULL is a valid value, use #BLI_rhash_lookup_p to differentiate a missing key
+ * from a key with a NULL value. (Avoids calling #BLI_rhash_haskey before #BLI_rhash_lookup)
+ */
+void *BLI_rhash_lookup(RHash *rh, const void *key)
+{
+	const unsigned int i = rhash_lookup_bucket(rh, key, rhash_keyhash(rh, key));
+	BLI_assert(!(rh->flag & RHASH_FLAG_IS_RSET));
+	return (i != RHASH_BUCKET_NONE) ? rh->vals[i] : NULL;
+}
+
+/**
+ * A version of #BLI_rhash_lookup which accepts a fallback argument.
+ */
+void *BLI_rhash_lookup_default(RHash *rh, const void *key, void *val_default)
+{
+	const unsigned int i = rhash_lookup_bucket(rh, key, rhash_keyhash(rh, key));
+	BLI_assert(!(rh->flag & RHASH_FLAG_IS_RSET));
+	return (i != RHASH_BUCKET_NONE) ? rh->vals[i] : val_default;
+}
+
+/**
+ * Lookup a pointer to the value of \a key in \a rh.
+ *
+ * \returns the pointer to value for \a key or NULL.
+ *
+ * \note This has 2 main benefits over #BLI_rhash_lookup.
+ * - A NULL return always means that \a key isn't in \a rh.
+ * - The value can be modified in-place without further function calls (faster).
+ */
+void **BLI_rhash_lookup_p(RHash *rh, const void *key)
+{
+	const unsigned int i = rhash_lookup_bucket(rh, key, rhash_keyhash(rh, key));
+	BLI_assert(!(rh->flag & RHASH_FLAG_IS_RSET));
+	return (i != RHASH_BUCKET_NONE) ? &rh->vals[i] : NULL;
+}
+
+/**
+ * Ensure \a key is exists in \a rh.
+ *
+ * This handles the common situation where the caller needs ensure a key is added to \a rh,
+ * constructing a new value in the case the key isn't found.
+ * Otherwise use the existing value.
+ *
+ * \returns true when the value didn't need to be added.
+ * (when false, the caller _must_ initialize the value).
+ */
+bool BLI_rhash_ensure_p(RHash *rh, void *key, void ***r_val)
+{
+	const unsigned int hash = rhash_keyhash(rh, key);
+	unsigned int i = rhash_lookup_bucket(rh, key, hash);
+	const bool haskey = (i != RHASH_BUCKET_NONE);
+
+	BLI_assert(!(rh->flag & RHASH_FLAG_IS_RSET));
+
+	if (!haskey) {
+		rhash_expand(rh, rh->nentries + 1);
+		i = rhash_insert_entry(rh, key, NULL, hash);
+		rh->nentries++;
+	}
+
+	*r_val = &rh->vals[i];
+	return haskey;
+}
+
+/**
+ * Remove \a key from \a rh, or return false if the key wasn't found.
+ *
+ * \param key  The key to remove.
+ * \param keyfreefp  Optional callback to free the key.
+ * \param valfreefp  Optional callback to free the value.
+ * \return true if \a key was removed from \a rh.
+ */
+bool BLI_rhash_remove(RHash *rh, const void *key, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	const unsigned int i = rhash_lookup_bucket(rh, key, rhash_keyhash(rh, key));
+
+	if (i != RHASH_BUCKET_NONE) {
+		if (keyfreefp) {
+			keyfreefp(rh->buckets[i].key);
+		}
+		if (valfreefp) {
+			valfreefp(rh->vals[i]);
+		}
+		rhash_remove_bucket(rh, i);
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Remove \a key from \a rh, returning the value or NULL if the key wasn't found.
+ *
+ * \param key  The key to remove.
+ * \param keyfreefp  Optional callback to free the key.
+ * \return the value of \a key int \a rh or NULL.
+ */
+void *BLI_rhash_popkey(RHash *rh, const void *key, GHashKeyFreeFP keyfreefp)
+{
+	const unsigned int i = rhash_lookup_bucket(rh, key, rhash_keyhash(rh, key));
+
+	BLI_assert(!(rh->flag & RHASH_FLAG_IS_RSET));
+
+	if (i != RHASH_BUCKET_NONE) {
+		void *val = rh->vals[i];
+		if (keyfreefp) {
+			keyfreefp(rh->buckets[i].key);
+		}
+		rhash_remove_bucket(rh, i);
+		return val;
+	}
+	return NULL;
+}
+
+/**
+ * \return true if the \a key is in \a rh.
+ */
+bool BLI_rhash_haskey(RHash *rh, const void *key)
+{
+	return (rhash_lookup_bucket(rh, key, rhash_keyhash(rh, key)) != RHASH_BUCKET_NONE);
+}
+
+/**
+ * Reset \a rh clearing all entries.
+ *
+ * \param keyfreefp  Optional callback to free the key.
+ * \param valfreefp  Optional callback to free the value.
+ * \param nentries_reserve  Optionally reserve the number of members that the hash will hold.
+ */
+void BLI_rhash_clear_ex(RHash *rh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp,
+                        const unsigned int nentries_reserve)
+{
+	if (keyfreefp || valfreefp) {
+		rhash_free_cb(rh, keyfreefp, valfreefp);
+	}
+	rhash_clear(rh, nentries_reserve);
+}
+
+/**
+ * Wraps #BLI_rhash_clear_ex with zero entries reserved.
+ */
+void BLI_rhash_clear(RHash *rh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	BLI_rhash_clear_ex(rh, keyfreefp, valfreefp, 0);
+}
+
+/**
+ * Frees the RHash and its members.
+ *
+ * \param rh  The RHash to free.
+ * \param keyfreefp  Optional callback to free the key.
+ * \param valfreefp  Optional callback to free the value.
+ */
+void BLI_rhash_free(RHash *rh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	if (keyfreefp || valfreefp) {
+		rhash_free_cb(rh, keyfreefp, valfreefp);
+	}
+	rhash_buckets_free(rh);
+	MEM_freeN(rh);
+}
+
+/** \} */
+
+
+/* -------------------------------------------------------------------- */
+/* RHash Iterator API */
+
+/** \name Iterator API
+ *
+ * \note Iterators are invalidated by changing the hash.
+ * \{ */
+
+/**
+ * Init an already allocated RHashIterator. The hash table must not
+ * be mutated while the iterator is in use, and the iterator will
+ * step exactly BLI_rhash_size(rh) times before becoming done.
+ *
+ * \param rhi The RHashIterator to initialize.
+ * \param rh The RHash to iterate over.
+ */
+void BLI_rhashIterator_init(RHashIterator *rhi, RHash *rh)
+{
+	rhi->rh = rh;
+	rhi->curr_bucket = UINT_MAX;  /* wraps to zero */
+	BLI_rhashIterator_step(rhi);
+}
+
+/**
+ * Steps the iterator to the next index.
+ *
+ * \param rhi The iterator.
+ */
+void BLI_rhashIterator_step(RHashIterator *rhi)
+{
+	const RHash *rh = rhi->rh;
+
+	do {
+		rhi->curr_bucket++;
+	} while ((rhi->curr_bucket < rh->nbuckets) && (rh->buckets[rhi->curr_bucket].dist == 0));
+}
+
+void *BLI_rhashIterator_getKey(RHashIterator *rhi)
+{
+	return rhi->rh->buckets[rhi->curr_bucket].key;
+}
+
+void *BLI_rhashIterator_getValue(RHashIterator *rhi)
+{
+	return rhi->rh->vals[rhi->curr_bucket];
+}
+
+void **BLI_rhashIterator_getValue_p(RHashIterator *rhi)
+{
+	return &rhi->rh->vals[rhi->curr_bucket];
+}
+
+bool BLI_rhashIterator_done(RHashIterator *rhi)
+{
+	return (rhi->curr_bucket >= rhi->rh->nbuckets);
+}
+
+/** \} */
+
+
+/** \name Convenience RHash Creation Functions
+ * \{ */
+
+RHash *BLI_rhash_ptr_new_ex(const char *info, const unsigned int nentries_reserve)
+{
+	return rhash_new(BLI_ghashutil_ptrhash, BLI_ghashutil_ptrcmp, info, nentries_reserve, RHASH_FLAG_KEY_PTR);
+}
+RHash *BLI_rhash_ptr_new(const char *info)
+{
+	return BLI_rhash_ptr_new_ex(info, 0);
+}
+
+RHash *BLI_rhash_int_new_ex(const char *info, const unsigned int nentries_reserve)
+{
+	return rhash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, info, nentries_reserve, RHASH_FLAG_KEY_INT);
+}
+RHash *BLI_rhash_int_new(const char *info)
+{
+	return BLI_rhash_int_new_ex(info, 0);
+}
+
+RHash *BLI_rhash_str_new_ex(const char *info, const unsigned int nentries_reserve)
+{
+	return BLI_rhash_new_ex(BLI_ghashutil_strhash_p, BLI_ghashutil_strcmp, info, nentries_reserve);
+}
+RHash *BLI_rhash_str_new(const char *info)
+{
+	return BLI_rhash_str_new_ex(info, 0);
+}
+
+/** \} */
+
+
+/* -------------------------------------------------------------------- */
+/* RSet API */
+
+/* Use RHash API to give 'set' functionality */
+
+/** \name RSet Functions
+ * \{ */
+RSet *BLI_rset_new_ex(GSetHashFP hashfp, GSetCmpFP cmpfp, const char *info,
+                      const unsigned int nentries_reserve)
+{
+	return (RSet *)rhash_new(hashfp, cmpfp, info, nentries_reserve, RHASH_FLAG_IS_RSET);
+}
+
+RSet *BLI_rset_new(GSetHashFP hashfp, GSetCmpFP cmpfp, const char *info)
+{
+	return BLI_rset_new_ex(hashfp, cmpfp, info, 0);
+}
+
+unsigned int BLI_rset_size(RSet *rs)
+{
+	return ((RHash *)rs)->nentries;
+}
+
+void BLI_rset_reserve(RSet *rs, const unsigned int nentries_reserve)
+{
+	rhash_expand((RHash *)rs, nentries_reserve);
+}
+
+/**
+ * Adds the key to the set (no checks for unique keys!).
+ * Matching #BLI_rhash_insert
+ */
+void BLI_rset_insert(RSet *rs, void *key)
+{
+	rhash_insert((RHash *)rs, key, NULL);
+}
+
+/**
+ * A version of BLI_rset_insert which checks first if the key is in the set.
+ * \returns true if a new key has been added.
+ *
+ * \note RHash has no equivalent to this because typically the value would be different.
+ */
+bool BLI_rset_add(RSet *rs, void *key)
+{
+	return rhash_insert_safe((RHash *)rs, key, NULL, false, NULL, NULL);
+}
+
+/**
+ * Adds the key to the set (duplicates are managed).
+ * Matching #BLI_rhash_reinsert
+ *
+ * \returns true if a new key has been added.
+ */
+bool BLI_rset_reinsert(RSet *rs, void *key, GSetKeyFreeFP keyfreefp)
+{
+	return rhash_insert_safe((RHash *)rs, key, NULL, true, keyfreefp, NULL);
+}
+
+bool BLI_rset_remove(RSet *rs, const void *key, GSetKeyFreeFP keyfreefp)
+{
+	return BLI_rhash_remove((RHash *)rs, key, keyfreefp, NULL);
+}
+
+bool BLI_rset_haskey(RSet *rs, const void *key)
+{
+	return BLI_rhash_haskey((RHash *)rs, key);
+}
+
+void BLI_rset_clear_ex(RSet *rs, GSetKeyFreeFP keyfreefp,
+                       const unsigned int nentries_reserve)
+{
+	BLI_rhash_clear_ex((RHash *)rs, keyfreefp, NULL, nentries_reserve);
+}
+
+void BLI_rset_clear(RSet *rs, GSetKeyFreeFP keyfreefp)
+{
+	BLI_rhash_clear((RHash *)rs, keyfreefp, NULL);
+}
+
+void BLI_rset_free(RSet *rs, GSetKeyFreeFP keyfreefp)
+{
+	BLI_rhash_free((RHash *)rs, keyfreefp, NULL);
+}
+
+/** \} */
+
+
+/** \name Convenience RSet Creation Functions
+ * \{ */
+
+RSet *BLI_rset_ptr_new_ex(const char *info, const unsigned int nentries_reserve)
+{
+	return (RSet *)rhash_new(
+	        BLI_ghashutil_ptrhash, BLI_ghashutil_ptrcmp, info, nentries_reserve,
+	        RHASH_FLAG_IS_RSET | RHASH_FLAG_KEY_PTR);
+}
+RSet *BLI_rset_ptr_new(const char *info)
+{
+	return BLI_rset_ptr_new_ex(info, 0);
+}
+
+RSet *BLI_rset_int_new_ex(const char *info, const unsigned int nentries_reserve)
+{
+	return (RSet *)rhash_new(
+	        BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, info, nentries_reserve,
+	        RHASH_FLAG_IS_RSET | RHASH_FLAG_KEY_INT);
+}
+RSet *BLI_rset_int_new(const char *info)
+{
+	return BLI_rset_int_new_ex(info, 0);
+}
+
+RSet *BLI_rset_str_new_ex(const char *info, const unsigned int nentries_reserve)
+{
+	return BLI_rset_new_ex(BLI_ghashutil_strhash_p, BLI_ghashutil_strcmp, info, nentries_reserve);
+}
+RSet *BLI_rset_str_new(const char *info)
+{
+	return BLI_rset_str_new_ex(info, 0);
+}
+
+/** \} */
+
+
+/** \name Debugging & Introspection
+ * \{ */
+
+/**
+ * \return number of buckets in the RHash.
+ */
+int BLI_rhash_buckets_size(RHash *rh)
+{
+	return (int)rh->nbuckets;
+}
+
+/**
+ * Measure how well the hash function performs, with robin-hood hashing
+ * this is the mean number of buckets read by a successful lookup (1.0 being perfect).
+ *
+ * \param r_load  The load of the hash (entries / buckets).
+ * \param r_probe_max  The longest probe of any entry.
+ */
+double BLI_rhash_calc_quality_ex(RHash *rh, double *r_load, int *r_probe_max)
+{
+	double sum = 0.0;
+	unsigned int probe_max = 0;
+	unsigned int i;
+
+	for (i = 0; i < rh->nbuckets; i++) {
+		const unsigned int dist = rh->buckets[i].dist;
+		sum += (double)dist;
+		if (dist > probe_max) {
+			probe_max = dist;
+		}
+	}
+
+	if (r_load) {
+		*r_load = (double)rh->nentries / (double)rh->nbuckets;
+	}
+	if (r_probe_max) {
+		*r_probe_max = (int)probe_max;
+	}
+
+	return rh->nentries ? sum / (double)rh->nentries : 0.0;
+}
+
+double BLI_rhash_calc_quality(RHash *rh)
+{
+	return BLI_rhash_calc_quality_ex(rh, NULL, NULL);
+}
+
+/** \} */
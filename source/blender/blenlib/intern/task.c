@@ -25,6 +25,7 @@
  */
 
 #include <stdlib.h>
+#include <stddef.h>
 
 #include "MEM_guardedalloc.h"
 
@@ -35,6 +36,8 @@
 #include "BLI_task.h"
 #include "BLI_threads.h"
 
+#include "PIL_time.h"
+
 #include "atomic_ops.h"
 
 /* Define this to enable some detailed statistic print. */
@@ -48,11 +51,13 @@
  */
 #define MEMPOOL_SIZE 256
 
-/* Number of tasks which are pushed directly to local thread queue.
+/* Number of tasks each thread can keep in its own deque, power of two.
  *
- * This allows thread to fetch next task without locking the whole queue.
+ * Tasks pushed from a thread go to its deque without locking, other threads
+ * steal from it when they run out of work. For more details see TaskDeque.
  */
-#define LOCAL_QUEUE_SIZE 1
+#define DEQUE_SIZE 4096
+#define DEQUE_MASK (DEQUE_SIZE - 1)
 
 /* Number of tasks which are allowed to be scheduled in a delayed manner.
  *
@@ -141,12 +146,6 @@ typedef struct TaskThreadLocalStorage {
 	 */
 	TaskMemPool task_mempool;
 
-	/* Local queue keeps thread alive by keeping small amount of tasks ready
-	 * to be picked up without causing global thread locks for synchronization.
-	 */
-	int num_local_queue;
-	Task *local_queue[LOCAL_QUEUE_SIZE];
-
 	/* Thread can be marked for delayed tasks push. This is helpful when it's
 	 * know that lots of subsequent task pushed will happen from the same thread
 	 * without "interrupting" for task execution.
@@ -209,6 +208,12 @@ struct TaskScheduler {
 	int num_threads;
 	bool background_thread_only;
 
+	/* Deques are not used with a background thread only, as it can't run
+	 * any task it would steal. */
+	bool use_deques;
+	/* Number of threads waiting for queue_cond, or about to. */
+	volatile unsigned int num_sleeping;
+
 	ListBase queue;
 	ThreadMutex queue_mutex;
 	ThreadCondition queue_cond;
@@ -219,10 +224,29 @@ struct TaskScheduler {
 	pthread_key_t tls_id_key;
 };
 
+/* Work-stealing deque of a thread (Chase-Lev, fixed size).
+ *
+ * Only the owner thread pushes and pops at the bottom, other threads steal
+ * from the top. Owner and thieves only compete with a compare-and-swap of top
+ * for the last task, so there is no lock at all.
+ *
+ * Thread 0 deque is owned by the main thread, pools created from other threads
+ * which are not scheduler workers don't use any deque.
+ */
+typedef struct TaskDeque {
+	/* Next task to be stolen, only increased. */
+	volatile size_t top;
+	char pad[64 - sizeof(size_t)];
+	/* Next free slot, only changed by the owner. */
+	volatile size_t bottom;
+	Task *tasks[DEQUE_SIZE];
+} TaskDeque;
+
 typedef struct TaskThread {
 	TaskScheduler *scheduler;
 	int id;
 	TaskThreadLocalStorage tls;
+	TaskDeque deque;
 } TaskThread;
 
 /* Helper */
@@ -325,17 +349,105 @@ static void task_free(TaskPool *pool, Task *task, const int thread_id)
 	}
 }
 
+/* Task Deque */
+
+BLI_INLINE void initialize_task_deque(TaskDeque *deque)
+{
+	deque->top = deque->bottom = 0;
+}
+
+/* Only for the owner thread. */
+BLI_INLINE bool task_deque_is_full(const TaskDeque *deque)
+{
+	return (deque->bottom - deque->top) >= DEQUE_SIZE;
+}
+
+/* Only for the owner thread, deque must not be full. */
+static void task_deque_push(TaskDeque *deque, Task *task)
+{
+	const size_t b = deque->bottom;
+	BLI_assert(!task_deque_is_full(deque));
+	deque->tasks[b & DEQUE_MASK] = task;
+	/* Full barrier, task is stored before it can be stolen. */
+	atomic_add_and_fetch_z((size_t *)&deque->bottom, 1);
+}
+
+/* Only for the owner thread, last pushed task is returned first. */
+static Task *task_deque_pop(TaskDeque *deque)
+{
+	/* Full barrier, thieves see the new bottom before top is read. */
+	const size_t b = atomic_sub_and_fetch_z((size_t *)&deque->bottom, 1);
+	const size_t t = deque->top;
+	const ptrdiff_t size = (ptrdiff_t)(b - t);
+	Task *task;
+
+	if (size < 0) {
+		deque->bottom = t;
+		return NULL;
+	}
+
+	task = deque->tasks[b & DEQUE_MASK];
+	if (size > 0) {
+		return task;
+	}
+
+	/* Last task, thieves may be trying to take it too. */
+	if (atomic_cas_z((size_t *)&deque->top, t, t + 1) != t) {
+		task = NULL;
+	}
+	deque->bottom = t + 1;
+	return task;
+}
+
+/* For any thread, first pushed task is returned first. */
+static Task *task_deque_steal(TaskDeque *deque)
+{
+	while (true) {
+		/* Full barrier, top is read before bottom. */
+		const size_t t = atomic_add_and_fetch_z((size_t *)&deque->top, 0);
+		const size_t b = deque->bottom;
+		Task *task;
+
+		if ((ptrdiff_t)(b - t) <= 0) {
+			return NULL;
+		}
+		task = deque->tasks[t & DEQUE_MASK];
+		if (atomic_cas_z((size_t *)&deque->top, t, t + 1) == t) {
+			return task;
+		}
+		/* Lost the task to the owner or another thief, try with the next one. */
+	}
+}
+
 /* Task Scheduler */
 
+static void task_pool_num_notify(TaskPool *pool)
+{
+	BLI_mutex_lock(&pool->num_mutex);
+	BLI_condition_notify_all(&pool->num_cond);
+	BLI_mutex_unlock(&pool->num_mutex);
+}
+
 static void task_pool_num_decrease(TaskPool *pool, size_t done)
 {
+	size_t num = pool->num;
+
+	/* No lock while other tasks are left, the pool can't be freed. */
+	while (num > done) {
+		const size_t num_prev = atomic_cas_z((size_t *)&pool->num, num, num - done);
+		if (num_prev == num) {
+			return;
+		}
+		num = num_prev;
+	}
+
+	/* Last tasks, the pool may be freed as soon as a waiting thread sees it done,
+	 * which can't happen until the lock is released. */
 	BLI_mutex_lock(&pool->num_mutex);
 
 	BLI_assert(pool->num >= done);
 
-	pool->num -= done;
-
-	if (pool->num == 0)
+	if (atomic_sub_and_fetch_z((size_t *)&pool->num, done) == 0)
 		BLI_condition_notify_all(&pool->num_cond);
 
 	BLI_mutex_unlock(&pool->num_mutex);
@@ -343,31 +455,80 @@ static void task_pool_num_decrease(TaskPool *pool, size_t done)
 
 static void task_pool_num_increase(TaskPool *pool, size_t new)
 {
-	BLI_mutex_lock(&pool->num_mutex);
+	atomic_add_and_fetch_z((size_t *)&pool->num, new);
+	/* Waiting threads look for new tasks in the queue. */
+	task_pool_num_notify(pool);
+}
 
-	pool->num += new;
-	BLI_condition_notify_all(&pool->num_cond);
+/**
+ * Deque a thread with \a thread_id pushes to and pops from, NULL when it doesn't own one.
+ */
+BLI_INLINE TaskDeque *task_thread_deque(TaskPool *pool, const int thread_id)
+{
+	TaskScheduler *scheduler = pool->scheduler;
 
-	BLI_mutex_unlock(&pool->num_mutex);
+	if (!scheduler->use_deques || thread_id == -1) {
+		return NULL;
+	}
+	if (thread_id == 0 && (pool->use_local_tls || !BLI_thread_is_main())) {
+		return NULL;
+	}
+	ASSERT_THREAD_ID(scheduler, thread_id);
+	return &scheduler->task_threads[thread_id].deque;
 }
 
-static bool task_scheduler_thread_wait_pop(TaskScheduler *scheduler, Task **task)
+/* Takes a task from any deque but the one of \a thread_id. */
+static Task *task_scheduler_steal(TaskScheduler *scheduler, const int thread_id)
 {
-	bool found_task = false;
+	const int num_deques = scheduler->num_threads + 1;
+
+	for (int i = 1; i < num_deques; i++) {
+		Task *task = task_deque_steal(&scheduler->task_threads[(thread_id + i) % num_deques].deque);
+		if (task) {
+			return task;
+		}
+	}
+	return NULL;
+}
+
+/* Wakes up a thread after pushing to a deque, there is no lock unless some thread sleeps. */
+static void task_scheduler_wake(TaskScheduler *scheduler)
+{
+	if (scheduler->num_sleeping != 0) {
+		BLI_mutex_lock(&scheduler->queue_mutex);
+		BLI_condition_notify_one(&scheduler->queue_cond);
+		BLI_mutex_unlock(&scheduler->queue_mutex);
+	}
+}
+
+/**
+ * Moves a task taken from a deque to the global queue, when the thread
+ * can't run it (it's waiting for another pool).
+ */
+static void task_scheduler_requeue(TaskScheduler *scheduler, Task *task)
+{
+	TaskPool *pool = task->pool;
+
 	BLI_mutex_lock(&scheduler->queue_mutex);
+	BLI_addhead(&scheduler->queue, task);
+	BLI_condition_notify_one(&scheduler->queue_cond);
+	/* The thread waiting for the pool looks for it in the queue,
+	 * notified before the task can be taken (and the pool freed). */
+	task_pool_num_notify(pool);
+	BLI_mutex_unlock(&scheduler->queue_mutex);
+}
 
-	while (!scheduler->queue.first && !scheduler->do_exit)
-		BLI_condition_wait(&scheduler->queue_cond, &scheduler->queue_mutex);
+static bool task_scheduler_thread_wait_pop(TaskScheduler *scheduler, const int thread_id, Task **task)
+{
+	bool found_task = false;
+	BLI_mutex_lock(&scheduler->queue_mutex);
 
 	do {
 		Task *current_task;
 
-		/* Assuming we can only have a void queue in 'exit' case here seems logical (we should only be here after
-		 * our worker thread has been woken up from a condition_wait(), which only happens after a new task was
-		 * added to the queue), but it is wrong.
-		 * Waiting on condition may wake up the thread even if condition is not signaled (spurious wake-ups), and some
-		 * race condition may also empty the queue **after** condition has been signaled, but **before** awoken thread
-		 * reaches this point...
+		/* Waiting on condition may wake up the thread even if condition is not signaled (spurious wake-ups),
+		 * and some race condition may also empty the queue **after** condition has been signaled, but
+		 * **before** awoken thread reaches this point...
 		 * See http://stackoverflow.com/questions/8594591
 		 *
 		 * So we only abort here if do_exit is set.
@@ -392,8 +553,20 @@ static bool task_scheduler_thread_wait_pop(TaskScheduler *scheduler, Task **task
 			BLI_remlink(&scheduler->queue, *task);
 			break;
 		}
-		if (!found_task)
-			BLI_condition_wait(&scheduler->queue_cond, &scheduler->queue_mutex);
+
+		if (!found_task) {
+			/* Deques are pushed to without the lock, so tell pushing threads we might sleep
+			 * before a last look at them: either we see the task or they see us.
+			 */
+			atomic_add_and_fetch_u((unsigned int *)&scheduler->num_sleeping, 1);
+			if (scheduler->use_deques && (*task = task_scheduler_steal(scheduler, thread_id))) {
+				found_task = true;
+			}
+			else {
+				BLI_condition_wait(&scheduler->queue_cond, &scheduler->queue_mutex);
+			}
+			atomic_sub_and_fetch_u((unsigned int *)&scheduler->num_sleeping, 1);
+		}
 	} while (!found_task);
 
 	BLI_mutex_unlock(&scheduler->queue_mutex);
@@ -401,38 +574,31 @@ static bool task_scheduler_thread_wait_pop(TaskScheduler *scheduler, Task **task
 	return true;
 }
 
-BLI_INLINE void handle_local_queue(TaskThreadLocalStorage *tls,
-                                   const int thread_id)
-{
-	BLI_assert(!tls->do_delayed_push);
-	while (tls->num_local_queue > 0) {
-		/* We pop task from queue before handling it so handler of the task can
-		 * push next job to the local queue.
-		 */
-		tls->num_local_queue--;
-		Task *local_task = tls->local_queue[tls->num_local_queue];
-		/* TODO(sergey): Double-check work_and_wait() doesn't handle other's
-		 * pool tasks.
-		 */
-		TaskPool *local_pool = local_task->pool;
-		local_task->run(local_pool, local_task->taskdata, thread_id);
-		task_free(local_pool, local_task, thread_id);
-	}
-	BLI_assert(!tls->do_delayed_push);
-}
-
 static void *task_scheduler_thread_run(void *thread_p)
 {
 	TaskThread *thread = (TaskThread *) thread_p;
 	TaskThreadLocalStorage *tls = &thread->tls;
 	TaskScheduler *scheduler = thread->scheduler;
+	TaskDeque *deque = scheduler->use_deques ? &thread->deque : NULL;
 	int thread_id = thread->id;
 	Task *task;
 
+	UNUSED_VARS_NDEBUG(tls);
+
 	pthread_setspecific(scheduler->tls_id_key, thread);
 
-	/* keep popping off tasks */
-	while (task_scheduler_thread_wait_pop(scheduler, &task)) {
+	/* keep popping off tasks, own ones first, then stolen ones and from the queue */
+	while (true) {
+		task = NULL;
+		if (deque) {
+			if ((task = task_deque_pop(deque)) == NULL) {
+				task = task_scheduler_steal(scheduler, thread_id);
+			}
+		}
+		if (task == NULL && !task_scheduler_thread_wait_pop(scheduler, thread_id, &task)) {
+			break;
+		}
+
 		TaskPool *pool = task->pool;
 
 		/* run task */
@@ -443,9 +609,6 @@ static void *task_scheduler_thread_run(void *thread_p)
 		/* delete task */
 		task_free(pool, task, thread_id);
 
-		/* Handle all tasks from local queue. */
-		handle_local_queue(tls, thread_id);
-
 		/* notify pool task was done */
 		task_pool_num_decrease(pool, 1);
 	}
@@ -479,12 +642,19 @@ TaskScheduler *BLI_task_scheduler_create(int num_threads)
 		num_threads = 1;
 	}
 
+	scheduler->use_deques = !scheduler->background_thread_only;
+
 	scheduler->task_threads = MEM_mallocN(sizeof(TaskThread) * (num_threads + 1),
 	                                      "TaskScheduler task threads");
 
 	/* Initialize TLS for main thread. */
 	initialize_task_tls(&scheduler->task_threads[0].tls);
 
+	/* Threads steal from all deques as soon as they are launched. */
+	for (int i = 0; i < num_threads + 1; i++) {
+		initialize_task_deque(&scheduler->task_threads[i].deque);
+	}
+
 	pthread_key_create(&scheduler->tls_id_key, NULL);
 
 	/* launch threads that will be waiting for work */
@@ -533,11 +703,16 @@ void BLI_task_scheduler_free(TaskScheduler *scheduler)
 		MEM_freeN(scheduler->threads);
 	}
 
-	/* Delete task thread data */
+	/* Delete task thread data and leftover tasks of its deques */
 	if (scheduler->task_threads) {
 		for (int i = 0; i < scheduler->num_threads + 1; ++i) {
 			TaskThreadLocalStorage *tls = &scheduler->task_threads[i].tls;
 			free_task_tls(tls);
+
+			while ((task = task_deque_pop(&scheduler->task_threads[i].deque))) {
+				task_data_free(task, 0);
+				MEM_freeN(task);
+			}
 		}
 
 		MEM_freeN(scheduler->task_threads);
@@ -793,18 +968,9 @@ static void task_pool_push(
 		atomic_fetch_and_add_z(&pool->num_suspended, 1);
 		return;
 	}
-	/* Populate to any local queue first, this is cheapest push ever. */
 	if (task_can_use_local_queues(pool, thread_id)) {
 		ASSERT_THREAD_ID(pool->scheduler, thread_id);
 		TaskThreadLocalStorage *tls = get_task_tls(pool, thread_id);
-		/* Try to push to a local execution queue.
-		 * These tasks will be picked up next.
-		 */
-		if (tls->num_local_queue < LOCAL_QUEUE_SIZE) {
-			tls->local_queue[tls->num_local_queue] = task;
-			tls->num_local_queue++;
-			return;
-		}
 		/* If we are in the delayed tasks push mode, we push tasks to a
 		 * temporary local queue first without any locks, and then move them
 		 * to global execution queue with a single lock.
@@ -815,6 +981,18 @@ static void task_pool_push(
 			return;
 		}
 	}
+	/* Push to the deque of this thread, cheapest push ever: no lock and
+	 * other threads steal from it when they run out of work.
+	 * Deques are looked at before the queue, so only high priority tasks go
+	 * there, low priority ones wait at the queue tail.
+	 */
+	TaskDeque *deque = task_thread_deque(pool, thread_id);
+	if (deque && priority == TASK_PRIORITY_HIGH && !task_deque_is_full(deque)) {
+		atomic_add_and_fetch_z((size_t *)&pool->num, 1);
+		task_deque_push(deque, task);
+		task_scheduler_wake(pool->scheduler);
+		return;
+	}
 	/* Do push to a global execution ppol, slowest possible method,
 	 * causes quite reasonable amount of threading overhead.
 	 */
@@ -840,10 +1018,30 @@ void BLI_task_pool_push_from_thread(TaskPool *pool, TaskRunFunction run,
 	task_pool_push(pool, run, taskdata, free_taskdata, NULL, priority, thread_id);
 }
 
+/**
+ * Pops a task of \a pool from \a deque, tasks of other pools are moved to the queue
+ * (running them could deadlock, as from the queue).
+ */
+static Task *task_deque_pop_for_pool(TaskScheduler *scheduler, TaskDeque *deque, TaskPool *pool)
+{
+	Task *task;
+
+	while ((task = task_deque_pop(deque))) {
+		if (task->pool == pool) {
+			return task;
+		}
+		task_scheduler_requeue(scheduler, task);
+	}
+	return NULL;
+}
+
 void BLI_task_pool_work_and_wait(TaskPool *pool)
 {
 	TaskThreadLocalStorage *tls = get_task_tls(pool, pool->thread_id);
 	TaskScheduler *scheduler = pool->scheduler;
+	TaskDeque *deque = task_thread_deque(pool, pool->thread_id);
+
+	UNUSED_VARS_NDEBUG(tls);
 
 	if (atomic_fetch_and_and_uint8((uint8_t *)&pool->is_suspended, 0)) {
 		if (pool->num_suspended) {
@@ -869,21 +1067,29 @@ void BLI_task_pool_work_and_wait(TaskPool *pool)
 
 		BLI_mutex_unlock(&pool->num_mutex);
 
-		BLI_mutex_lock(&scheduler->queue_mutex);
+		/* Tasks pushed from this thread first, then from the queue. We never wait with
+		 * tasks left in our deque, other threads could be waiting for them. */
+		if (deque && (task = task_deque_pop_for_pool(scheduler, deque, pool))) {
+			work_task = task;
+			found_task = true;
+		}
+		else {
+			BLI_mutex_lock(&scheduler->queue_mutex);
 
-		/* find task from this pool. if we get a task from another pool,
-		 * we can get into deadlock */
+			/* find task from this pool. if we get a task from another pool,
+			 * we can get into deadlock */
 
-		for (task = scheduler->queue.first; task; task = task->next) {
-			if (task->pool == pool) {
-				work_task = task;
-				found_task = true;
-				BLI_remlink(&scheduler->queue, task);
-				break;
+			for (task = scheduler->queue.first; task; task = task->next) {
+				if (task->pool == pool) {
+					work_task = task;
+					found_task = true;
+					BLI_remlink(&scheduler->queue, task);
+					break;
+				}
 			}
-		}
 
-		BLI_mutex_unlock(&scheduler->queue_mutex);
+			BLI_mutex_unlock(&scheduler->queue_mutex);
+		}
 
 		/* if found task, do it, otherwise wait until other tasks are done */
 		if (found_task) {
@@ -893,10 +1099,7 @@ void BLI_task_pool_work_and_wait(TaskPool *pool)
 			BLI_assert(!tls->do_delayed_push);
 
 			/* delete task */
-			task_free(pool, task, pool->thread_id);
-
-			/* Handle all tasks from local queue. */
-			handle_local_queue(tls, pool->thread_id);
+			task_free(pool, work_task, pool->thread_id);
 
 			/* notify pool task was done */
 			task_pool_num_decrease(pool, 1);
@@ -911,15 +1114,63 @@ void BLI_task_pool_work_and_wait(TaskPool *pool)
 	}
 
 	BLI_mutex_unlock(&pool->num_mutex);
-
-	handle_local_queue(tls, pool->thread_id);
 }
 
 void BLI_task_pool_cancel(TaskPool *pool)
 {
+	TaskScheduler *scheduler = pool->scheduler;
+	TaskThread *thread = pthread_getspecific(scheduler->tls_id_key);
+	const int thread_id = thread ? thread->id : 0;
+	TaskDeque *deque = task_thread_deque(pool, thread_id);
+
 	pool->do_cancel = true;
 
-	task_scheduler_clear(pool->scheduler, pool);
+	task_scheduler_clear(scheduler, pool);
+
+	/* free tasks of this pool pushed from this thread */
+	if (deque) {
+		Task *task;
+		size_t done = 0;
+
+		while ((task = task_deque_pop_for_pool(scheduler, deque, pool))) {
+			task_data_free(task, thread_id);
+			MEM_freeN(task);
+			done++;
+		}
+		if (done) {
+			task_pool_num_decrease(pool, done);
+		}
+	}
+
+	/* and from other threads, stealing what their deques had when canceling,
+	 * tasks of other pools are moved to the queue */
+	if (scheduler->use_deques) {
+		const int num_deques = scheduler->num_threads + 1;
+		size_t done = 0;
+
+		for (int i = 0; i < num_deques; i++) {
+			TaskDeque *deque_other = &scheduler->task_threads[i].deque;
+			ptrdiff_t num_tasks = (ptrdiff_t)(deque_other->bottom - deque_other->top);
+			Task *task;
+
+			if (deque_other == deque) {
+				continue;
+			}
+			while (num_tasks-- > 0 && (task = task_deque_steal(deque_other))) {
+				if (task->pool == pool) {
+					task_data_free(task, thread_id);
+					MEM_freeN(task);
+					done++;
+				}
+				else {
+					task_scheduler_requeue(scheduler, task);
+				}
+			}
+		}
+		if (done) {
+			task_pool_num_decrease(pool, done);
+		}
+	}
 
 	/* wait until all entries are cleared */
 	BLI_mutex_lock(&pool->num_mutex);
@@ -988,6 +1239,10 @@ void BLI_task_pool_delayed_push_end(TaskPool *pool, int thread_id)
 #define MALLOCA(_size) ((_size) <= 8192) ? alloca((_size)) : MEM_mallocN((_size), __func__)
 #define MALLOCA_FREE(_mem, _size) if (((_mem) != NULL) && ((_size) > 8192)) MEM_freeN((_mem))
 
+/* Dynamic scheduling tunes chunks to take about this time, in seconds. */
+#define PARALLEL_RANGE_CHUNK_TIME 0.0001
+#define PARALLEL_RANGE_CHUNK_MAX (1 << 16)
+
 typedef struct ParallelRangeState {
 	int start, stop;
 	void *userdata;
@@ -996,22 +1251,73 @@ typedef struct ParallelRangeState {
 	TaskParallelRangeFuncEx func_ex;
 
 	int iter;
+	/* Static chunk size, or the first one of each task with dynamic scheduling. */
 	int chunk_size;
+	bool use_dynamic_scheduling;
+	int num_tasks;
 } ParallelRangeState;
 
 BLI_INLINE bool parallel_range_next_iter_get(
-        ParallelRangeState * __restrict state,
+        ParallelRangeState * __restrict state, const int chunk_size,
         int * __restrict iter, int * __restrict count)
 {
-	uint32_t uval = atomic_fetch_and_add_uint32((uint32_t *)(&state->iter), state->chunk_size);
+	uint32_t uval = atomic_fetch_and_add_uint32((uint32_t *)(&state->iter), chunk_size);
 	int previter = *(int32_t *)&uval;
 
 	*iter = previter;
-	*count = max_ii(0, min_ii(state->chunk_size, state->stop - previter));
+	*count = max_ii(0, min_ii(chunk_size, state->stop - previter));
 
 	return (previter < state->stop);
 }
 
+/**
+ * Size of the next chunk with dynamic scheduling, from the size \a chunk_size tuned for the task.
+ * Remaining iterations are split between all tasks, so no task ends up with a big last chunk
+ * while the others have nothing left to do.
+ */
+BLI_INLINE int parallel_range_dynamic_chunk_size(const ParallelRangeState *state, const int chunk_size)
+{
+	const int remaining = state->stop - *(volatile int *)&state->iter;
+
+	return max_ii(1, min_ii(chunk_size, remaining / state->num_tasks));
+}
+
+/**
+ * Chunk size taking about #PARALLEL_RANGE_CHUNK_TIME, from \a time spent on last chunk of \a count iterations.
+ * Grows at most twice the previous \a chunk_size, next iterations may be much more expensive.
+ */
+BLI_INLINE int parallel_range_dynamic_chunk_tune(const int chunk_size, const int count, const double time)
+{
+	int size = min_ii(chunk_size * 2, PARALLEL_RANGE_CHUNK_MAX);
+
+	/* Under timer resolution, just grow. */
+	if (time > 0.0) {
+		const double size_time = PARALLEL_RANGE_CHUNK_TIME * (double)count / time;
+		if (size_time < (double)size) {
+			size = max_ii(1, (int)size_time);
+		}
+	}
+	return size;
+}
+
+BLI_INLINE void parallel_range_chunk_run(
+        ParallelRangeState * __restrict state, void *userdata_chunk,
+        const int iter, const int count, const int threadid)
+{
+	int i;
+
+	if (state->func_ex) {
+		for (i = 0; i < count; ++i) {
+			state->func_ex(state->userdata, userdata_chunk, iter + i, threadid);
+		}
+	}
+	else {
+		for (i = 0; i < count; ++i) {
+			state->func(state->userdata, iter + i);
+		}
+	}
+}
+
 static void parallel_range_func(
         TaskPool * __restrict pool,
         void *userdata_chunk,
@@ -1020,18 +1326,22 @@ static void parallel_range_func(
 	ParallelRangeState * __restrict state = BLI_task_pool_userdata(pool);
 	int iter, count;
 
-	while (parallel_range_next_iter_get(state, &iter, &count)) {
-		int i;
+	if (state->use_dynamic_scheduling) {
+		int chunk_size = state->chunk_size;
 
-		if (state->func_ex) {
-			for (i = 0; i < count; ++i) {
-				state->func_ex(state->userdata, userdata_chunk, iter + i, threadid);
-			}
+		while (parallel_range_next_iter_get(state, parallel_range_dynamic_chunk_size(state, chunk_size),
+		                                    &iter, &count))
+		{
+			const double time_start = PIL_check_seconds_timer();
+
+			parallel_range_chunk_run(state, userdata_chunk, iter, count, threadid);
+			chunk_size = parallel_range_dynamic_chunk_tune(
+			                 chunk_size, count, PIL_check_seconds_timer() - time_start);
 		}
-		else {
-			for (i = 0; i < count; ++i) {
-				state->func(state->userdata, iter + i);
-			}
+	}
+	else {
+		while (parallel_range_next_iter_get(state, state->chunk_size, &iter, &count)) {
+			parallel_range_chunk_run(state, userdata_chunk, iter, count, threadid);
 		}
 	}
 }
@@ -1116,14 +1426,18 @@ static void task_parallel_range_ex(
 	state.func = func;
 	state.func_ex = func_ex;
 	state.iter = start;
+	state.use_dynamic_scheduling = use_dynamic_scheduling;
 	if (use_dynamic_scheduling) {
-		state.chunk_size = 32;
+		/* Iterations cost is unknown yet, start with the smallest chunks. */
+		state.chunk_size = 1;
 	}
 	else {
 		state.chunk_size = max_ii(1, (stop - start) / (num_tasks));
 	}
 
-	num_tasks = min_ii(num_tasks, (stop - start) / state.chunk_size);
+	/* At least one chunk per task. */
+	num_tasks = max_ii(1, min_ii(num_tasks, (stop - start) / state.chunk_size));
+	state.num_tasks = num_tasks;
 	atomic_fetch_and_add_uint32((uint32_t *)(&state.iter), 0);
 
 	if (use_userdata_chunk) {
@@ -1169,7 +1483,8 @@ static void task_parallel_range_ex(
  * \param func_ex Callback function (advanced version).
  * \param use_threading If \a true, actually split-execute loop in threads, else just do a sequential forloop
  *                      (allows caller to use any kind of test to switch on parallelization or not).
- * \param use_dynamic_scheduling If \a true, the whole range is divided in a lot of small chunks (of size 32 currently),
+ * \param use_dynamic_scheduling If \a true, the whole range is divided in a lot of small chunks, sized from the time
+ *                               spent on previous ones (for iterations of uneven cost),
  *                               otherwise whole range is split in a few big chunks (num_threads * 2 chunks currently).
  */
 void BLI_task_parallel_range_ex(
@@ -1221,7 +1536,8 @@ void BLI_task_parallel_range(
  * useful to finalize accumulative tasks.
  * \param use_threading If \a true, actually split-execute loop in threads, else just do a sequential forloop
  *                      (allows caller to use any kind of test to switch on parallelization or not).
- * \param use_dynamic_scheduling If \a true, the whole range is divided in a lot of small chunks (of size 32 currently),
+ * \param use_dynamic_scheduling If \a true, the whole range is divided in a lot of small chunks, sized from the time
+ *                               spent on previous ones (for iterations of uneven cost),
  *                               otherwise whole range is split in a few big chunks (num_threads * 2 chunks currently).
  */
 void BLI_task_parallel_range_finalize(
@@ -1239,6 +1555,271 @@ void BLI_task_parallel_range_finalize(
 	            use_threading, use_dynamic_scheduling);
 }
 
+/* Parallel range reductions
+ *
+ * Each task reduces its iterations into its own userdata_chunk, merged by the finalize callback
+ * from the calling thread. Iterations are run with dynamic scheduling.
+ *
+ * Float sums depend on the order of additions, so they are done on fixed blocks of iterations
+ * instead, added in order once all are done.
+ */
+
+/* Iterations of each partial sum of BLI_task_parallel_range_sum_f */
+#define PARALLEL_REDUCE_SUM_BLOCK 1024
+
+typedef struct ParallelReduceData {
+	void *userdata;
+	/* Range, for reductions over blocks of iterations. */
+	int start, stop;
+	union {
+		TaskParallelRangeFloatFunc f;
+		TaskParallelRangeIntFunc i;
+		TaskParallelRangeMinMaxFunc minmax;
+		TaskParallelRangeConcatFunc concat;
+	} func;
+	/* Result, chunks are merged into it. */
+	void *result;
+} ParallelReduceData;
+
+struct TaskParallelConcat {
+	char *data;
+	int len, len_alloc;
+	size_t elem_size;
+};
+
+static void parallel_reduce_sum_f_block_cb(void *userdata, const int block)
+{
+	ParallelReduceData *data = userdata;
+	const int start = data->start + block * PARALLEL_REDUCE_SUM_BLOCK;
+	const int stop = min_ii(start + PARALLEL_REDUCE_SUM_BLOCK, data->stop);
+	float sum = 0.0f;
+
+	for (int i = start; i < stop; i++) {
+		sum += data->func.f(data->userdata, i);
+	}
+	((float *)data->result)[block] = sum;
+}
+
+/**
+ * \return the sum of \a func results over the range.
+ * Always the same, whatever the threads and chunks iterations ran on.
+ */
+float BLI_task_parallel_range_sum_f(
+        int start, int stop,
+        void *userdata,
+        TaskParallelRangeFloatFunc func,
+        const bool use_threading)
+{
+	const int num_blocks = (stop > start) ? ((stop - start) + PARALLEL_REDUCE_SUM_BLOCK - 1) / PARALLEL_REDUCE_SUM_BLOCK : 0;
+	float *partials, sum = 0.0f;
+	ParallelReduceData data = {.userdata = userdata, .start = start, .stop = stop, .func.f = func};
+
+	if (num_blocks == 0) {
+		return sum;
+	}
+
+	data.result = partials = MEM_mallocN(sizeof(*partials) * (size_t)num_blocks, __func__);
+	task_parallel_range_ex(
+	            0, num_blocks, &data, NULL, 0, parallel_reduce_sum_f_block_cb, NULL, NULL,
+	            use_threading, true);
+
+	for (int i = 0; i < num_blocks; i++) {
+		sum += partials[i];
+	}
+	MEM_freeN(partials);
+	return sum;
+}
+
+static void parallel_reduce_sum_i_cb(void *userdata, void *userdata_chunk, const int iter, const int UNUSED(thread_id))
+{
+	ParallelReduceData *data = userdata;
+	*(int *)userdata_chunk += data->func.i(data->userdata, iter);
+}
+
+static void parallel_reduce_sum_i_finalize(void *userdata, void *userdata_chunk)
+{
+	ParallelReduceData *data = userdata;
+	*(int *)data->result += *(int *)userdata_chunk;
+}
+
+/**
+ * \return the sum of \a func results over the range, e.g. to count elements.
+ */
+int BLI_task_parallel_range_sum_i(
+        int start, int stop,
+        void *userdata,
+        TaskParallelRangeIntFunc func,
+        const bool use_threading)
+{
+	int sum = 0, sum_chunk = 0;
+	ParallelReduceData data = {.userdata = userdata, .func.i = func, .result = &sum};
+
+	task_parallel_range_ex(
+	            start, stop, &data, &sum_chunk, sizeof(sum_chunk), NULL,
+	            parallel_reduce_sum_i_cb, parallel_reduce_sum_i_finalize, use_threading, true);
+	return sum;
+}
+
+static void parallel_reduce_minmax_f_cb(void *userdata, void *userdata_chunk, const int iter, const int UNUSED(thread_id))
+{
+	ParallelReduceData *data = userdata;
+	float *minmax = userdata_chunk;
+	const float value = data->func.f(data->userdata, iter);
+
+	minmax[0] = min_ff(minmax[0], value);
+	minmax[1] = max_ff(minmax[1], value);
+}
+
+static void parallel_reduce_minmax_f_finalize(void *userdata, void *userdata_chunk)
+{
+	ParallelReduceData *data = userdata;
+	float *minmax = data->result;
+	const float *minmax_chunk = userdata_chunk;
+
+	minmax[0] = min_ff(minmax[0], minmax_chunk[0]);
+	minmax[1] = max_ff(minmax[1], minmax_chunk[1]);
+}
+
+/**
+ * Expands \a r_min and \a r_max with the results of \a func over the range.
+ */
+void BLI_task_parallel_range_minmax_f(
+        int start, int stop,
+        void *userdata,
+        TaskParallelRangeFloatFunc func,
+        float *r_min, float *r_max,
+        const bool use_threading)
+{
+	float minmax[2] = {*r_min, *r_max};
+	float minmax_chunk[2] = {FLT_MAX, -FLT_MAX};
+	ParallelReduceData data = {.userdata = userdata, .func.f = func, .result = minmax};
+
+	task_parallel_range_ex(
+	            start, stop, &data, minmax_chunk, sizeof(minmax_chunk), NULL,
+	            parallel_reduce_minmax_f_cb, parallel_reduce_minmax_f_finalize, use_threading, true);
+
+	*r_min = minmax[0];
+	*r_max = minmax[1];
+}
+
+static void parallel_reduce_minmax_v3_cb(void *userdata, void *userdata_chunk, const int iter, const int UNUSED(thread_id))
+{
+	ParallelReduceData *data = userdata;
+	float (*minmax)[3] = userdata_chunk;
+
+	data->func.minmax(data->userdata, iter, minmax[0], minmax[1]);
+}
+
+static void parallel_reduce_minmax_v3_finalize(void *userdata, void *userdata_chunk)
+{
+	ParallelReduceData *data = userdata;
+	float (*minmax)[3] = data->result;
+	float (*minmax_chunk)[3] = userdata_chunk;
+
+	for (int i = 0; i < 3; i++) {
+		minmax[0][i] = min_ff(minmax[0][i], minmax_chunk[0][i]);
+		minmax[1][i] = max_ff(minmax[1][i], minmax_chunk[1][i]);
+	}
+}
+
+/**
+ * Bounding box of the range, \a func expands the bounds it's given with an iteration.
+ * \a r_min and \a r_max are expanded, initialize them with #INIT_MINMAX.
+ */
+void BLI_task_parallel_range_minmax_v3(
+        int start, int stop,
+        void *userdata,
+        TaskParallelRangeMinMaxFunc func,
+        float r_min[3], float r_max[3],
+        const bool use_threading)
+{
+	float minmax[2][3], minmax_chunk[2][3];
+	ParallelReduceData data = {.userdata = userdata, .func.minmax = func, .result = minmax};
+
+	copy_v3_v3(minmax[0], r_min);
+	copy_v3_v3(minmax[1], r_max);
+	INIT_MINMAX(minmax_chunk[0], minmax_chunk[1]);
+
+	task_parallel_range_ex(
+	            start, stop, &data, minmax_chunk, sizeof(minmax_chunk), NULL,
+	            parallel_reduce_minmax_v3_cb, parallel_reduce_minmax_v3_finalize, use_threading, true);
+
+	copy_v3_v3(r_min, minmax[0]);
+	copy_v3_v3(r_max, minmax[1]);
+}
+
+/**
+ * \return a new element at the end of \a concat, to be filled by the caller.
+ */
+void *BLI_task_parallel_concat_append(TaskParallelConcat *concat)
+{
+	if (concat->len == concat->len_alloc) {
+		concat->len_alloc = max_ii(concat->len_alloc * 2, 64);
+		concat->data = MEM_reallocN(concat->data, concat->elem_size * (size_t)concat->len_alloc);
+	}
+	return concat->data + concat->elem_size * (size_t)concat->len++;
+}
+
+static void parallel_reduce_concat_cb(void *userdata, void *userdata_chunk, const int iter, const int UNUSED(thread_id))
+{
+	ParallelReduceData *data = userdata;
+	data->func.concat(data->userdata, iter, userdata_chunk);
+}
+
+static void parallel_reduce_concat_finalize(void *userdata, void *userdata_chunk)
+{
+	ParallelReduceData *data = userdata;
+	TaskParallelConcat *concat = data->result;
+	TaskParallelConcat *concat_chunk = userdata_chunk;
+
+	if (concat_chunk->len == 0) {
+		return;
+	}
+
+	if (concat->data == NULL) {
+		*concat = *concat_chunk;
+		return;
+	}
+
+	if (concat->len + concat_chunk->len > concat->len_alloc) {
+		concat->len_alloc = concat->len + concat_chunk->len;
+		concat->data = MEM_reallocN(concat->data, concat->elem_size * (size_t)concat->len_alloc);
+	}
+	memcpy(concat->data + concat->elem_size * (size_t)concat->len, concat_chunk->data,
+	       concat->elem_size * (size_t)concat_chunk->len);
+	concat->len += concat_chunk->len;
+
+	MEM_freeN(concat_chunk->data);
+}
+
+/**
+ * Concatenates the elements added by \a func over the range with #BLI_task_parallel_concat_append.
+ * When threaded, elements of an iteration stay together, but iterations are in no particular order.
+ *
+ * \param elem_size Memory size of the elements.
+ * \param r_len Number of elements.
+ * \return an array of the elements, NULL if there are none.
+ */
+void *BLI_task_parallel_range_concat(
+        int start, int stop,
+        void *userdata,
+        const size_t elem_size,
+        TaskParallelRangeConcatFunc func,
+        int *r_len,
+        const bool use_threading)
+{
+	TaskParallelConcat concat = {.elem_size = elem_size};
+	TaskParallelConcat concat_chunk = {.elem_size = elem_size};
+	ParallelReduceData data = {.userdata = userdata, .func.concat = func, .result = &concat};
+
+	task_parallel_range_ex(
+	            start, stop, &data, &concat_chunk, sizeof(concat_chunk), NULL,
+	            parallel_reduce_concat_cb, parallel_reduce_concat_finalize, use_threading, true);
+
+	*r_len = concat.len;
+	return concat.data;
+}
+
 #undef MALLOCA
 #undef MALLOCA_FREE
 
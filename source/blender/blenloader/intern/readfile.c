@@ -4417,6 +4417,38 @@ static void lib_link_customdata_mtpoly(FileData *fd, Mesh *me, CustomData *pdata
 	}
 }
 
+#ifdef WITH_MECHANICAL_MESH_DIMENSIONS
+/**
+ * Packed dimensions are NULL entries of mdim, set from the pool in the same order.
+ * Other entries are ID blocks. Dimensions with missing data are dropped.
+ */
+static void lib_link_mesh_dimensions(FileData *fd, Mesh *me)
+{
+	int k = 0, n = 0;
+
+	for (int i = 0; i < me->totdim; i++) {
+		MDim *mdim = me->mdim[i];
+
+		if (mdim == NULL) {
+			mdim = (k < me->totdim_pool) ? &me->mdim_pool[k++] : NULL;
+			if (mdim && mdim->v == NULL) {
+				mdim = NULL;
+			}
+		}
+		else {
+			mdim = newlibadr_us(fd, me->id.lib, mdim);
+		}
+
+		if (mdim == NULL) {
+			continue;
+		}
+		mdim->ob = newlibadr_us(fd, me->id.lib, mdim->ob);
+		me->mdim[n++] = mdim;
+	}
+	me->totdim = n;
+}
+#endif
+
 static void lib_link_mesh(FileData *fd, Main *main)
 {
 	Mesh *me;
@@ -4452,10 +4484,7 @@ static void lib_link_mesh(FileData *fd, Main *main)
 			}
 
 #ifdef WITH_MECHANICAL_MESH_DIMENSIONS
-			for (i=0;i<me->totdim;i++) {
-				me->mdim[i] = newlibadr_us(fd, me->id.lib, me->mdim[i]);
-				me->mdim[i]->ob = newlibadr_us(fd,me->id.lib, me->mdim[i]->ob);
-			}
+			lib_link_mesh_dimensions(fd, me);
 #endif
 		}
 	}
@@ -4602,6 +4631,92 @@ static void direct_link_customdata(FileData *fd, CustomData *data, int count)
 	CustomData_update_typemap(data);
 }
 
+#ifdef WITH_MECHANICAL_MESH_DIMENSIONS
+/**
+ * Since 2.79.1 packed dimensions are written out of mdim, which only has (and totdim only counts)
+ * ID blocks so older versions can read them. Packed ones are put back on mdim as NULL entries at
+ * the positions of mdim_pool_index, as 2.79.0 files have them.
+ */
+static void direct_link_mesh_dimension_index(FileData *fd, Mesh *mesh)
+{
+	int *index = mesh->mdim_pool_index;
+	const int tot = mesh->totdim + mesh->totdim_pool;
+	MDim **mdim;
+	int k = 0, n = 0;
+
+	if (fd->flags & FD_FLAGS_SWITCH_ENDIAN) {
+		BLI_endian_switch_int32_array(index, mesh->totdim_pool);
+	}
+
+	mdim = MEM_callocN(sizeof(*mdim) * max_ii(tot, 1), "Mesh Dimensions");
+	for (int i = 0; i < tot; i++) {
+		if ((k < mesh->totdim_pool) && (index[k] == i)) {
+			k++;
+		}
+		else if (n < mesh->totdim) {
+			mdim[i] = mesh->mdim[n++];
+		}
+	}
+
+	MEM_SAFE_FREE(mesh->mdim);
+	MEM_freeN(index);
+	mesh->mdim = mdim;
+	mesh->mdim_pool_index = NULL;
+	mesh->totdim = tot;
+}
+
+/**
+ * Dimensions without animation are written packed with the mesh, NULL entries of mdim.
+ * Pool entries get their vertex indices here, mdim entries are set on lib-link
+ * (see #lib_link_mesh_dimensions). Older files only have ID blocks.
+ */
+static void direct_link_mesh_dimension_pool(FileData *fd, Mesh *mesh)
+{
+	unsigned int *verts = mesh->mdim_pool_verts;
+	int totverts = (verts) ? mesh->totdim_pool_verts : 0;
+
+	if (mesh->mdim == NULL) {
+		mesh->totdim = 0;
+	}
+	if (mesh->mdim_pool == NULL) {
+		mesh->totdim_pool = 0;
+	}
+	if (mesh->mdim_pool_index) {
+		direct_link_mesh_dimension_index(fd, mesh);
+	}
+	if (verts && (fd->flags & FD_FLAGS_SWITCH_ENDIAN)) {
+		BLI_endian_switch_int32_array((int *)verts, totverts);
+	}
+
+	for (int k = 0; k < mesh->totdim_pool; k++) {
+		MDim *mdim = &mesh->mdim_pool[k];
+
+		mdim->id.next = mdim->id.prev = NULL;
+		mdim->id.newid = NULL;
+		mdim->id.lib = mesh->id.lib;
+		mdim->id.properties = NULL;
+		mdim->id.tag = LIB_TAG_NO_MAIN | LIB_TAG_NOT_ALLOCATED;
+		mdim->id.us = 1;
+		mdim->adt = NULL;
+
+		if ((mdim->totverts < 0) || (mdim->totverts > totverts)) {
+			// Missing packed data, dropped on lib-link
+			mdim->v = NULL;
+			mdim->ob = NULL;
+			totverts = 0;
+			continue;
+		}
+		mdim->v = MEM_mallocN(sizeof(*mdim->v) * mdim->totverts, "Mesh Dimension index array");
+		memcpy(mdim->v, verts, sizeof(*mdim->v) * mdim->totverts);
+		verts += mdim->totverts;
+		totverts -= mdim->totverts;
+	}
+
+	MEM_SAFE_FREE(mesh->mdim_pool_verts);
+	mesh->totdim_pool_verts = 0;
+}
+#endif
+
 static void direct_link_mesh(FileData *fd, Mesh *mesh)
 {
 	mesh->mat= newdataadr(fd, mesh->mat);
@@ -4622,10 +4737,26 @@ static void direct_link_mesh(FileData *fd, Mesh *mesh)
 	mesh->mselect = newdataadr(fd, mesh->mselect);
 #ifdef WITH_MECHANICAL_MESH_DIMENSIONS
 	mesh->mdim = newdataadr(fd,mesh->mdim);
+	mesh->mdim_pool = newdataadr(fd, mesh->mdim_pool);
+	mesh->mdim_pool_verts = newdataadr(fd, mesh->mdim_pool_verts);
+	mesh->mdim_pool_index = newdataadr(fd, mesh->mdim_pool_index);
+	direct_link_mesh_dimension_pool(fd, mesh);
 #endif
 #ifdef WITH_MECHANICAL_MESH_REFERENCE_OBJECTS
 	mesh->mref = newdataadr(fd, mesh->mref);
 #endif
+#ifdef WITH_MECHANICAL_GEOMETRY
+	mesh->mgeom = newdataadr(fd, mesh->mgeom);
+	mesh->mgeom_index = newdataadr(fd, mesh->mgeom_index);
+	if (mesh->mgeom_index == NULL) {
+		/* stored geometry is only valid with its indices */
+		MEM_SAFE_FREE(mesh->mgeom);
+		mesh->totgeom = mesh->totgeom_index = 0;
+	}
+	else if (fd->flags & FD_FLAGS_SWITCH_ENDIAN) {
+		BLI_endian_switch_int32_array(mesh->mgeom_index, mesh->totgeom_index);
+	}
+#endif
 	
 	/* animdata */
 	mesh->adt = newdataadr(fd, mesh->adt);
@@ -4643,6 +4774,8 @@ static void direct_link_mesh(FileData *fd, Mesh *mesh)
 
 	mesh->bb = NULL;
 	mesh->edit_btmesh = NULL;
+	mesh->dim_bm = NULL;
+	mesh->dim_draw_cache = NULL;
 	
 	/* happens with old files */
 	if (mesh->mselect == NULL) {
@@ -5641,6 +5774,7 @@ static void direct_link_object(FileData *fd, Object *ob)
 	ob->bb = NULL;
 	ob->derivedDeform = NULL;
 	ob->derivedFinal = NULL;
+	ob->dim_eval = NULL;
 	BLI_listbase_clear(&ob->gpulamp);
 	link_list(fd, &ob->pc_ids);
 
@@ -5663,6 +5797,24 @@ static void direct_link_object(FileData *fd, Object *ob)
 
 static void direct_link_dimension (FileData *fd, MDim *mdim) {
 	mdim->v = newdataadr(fd,mdim->v);
+	if (mdim->v && (fd->flags & FD_FLAGS_SWITCH_ENDIAN)) {
+		BLI_endian_switch_int32_array((int *)mdim->v, mdim->totverts);
+	}
+
+	mdim->adt = newdataadr(fd, mdim->adt);
+	direct_link_animdata(fd, mdim->adt);
+}
+
+static void lib_link_dimension(FileData *fd, Main *main)
+{
+	for (MDim *mdim = main->dimensions.first; mdim; mdim = mdim->id.next) {
+		if (mdim->id.tag & LIB_TAG_NEED_LINK) {
+			IDP_LibLinkProperty(mdim->id.properties, fd);
+			lib_link_animdata(fd, &mdim->id, mdim->adt);
+
+			mdim->id.tag &= ~LIB_TAG_NEED_LINK;
+		}
+	}
 }
 
 
@@ -8536,6 +8688,7 @@ static void lib_link_all(FileData *fd, Main *main)
 	lib_link_scene(fd, main);
 	lib_link_object(fd, main);
 	lib_link_mesh(fd, main);
+	lib_link_dimension(fd, main);
 	lib_link_curve(fd, main);
 	lib_link_mball(fd, main);
 	lib_link_material(fd, main);
@@ -1671,6 +1671,11 @@ void blo_do_versions_270(FileData *fd, Library *UNUSED(lib), Main *main)
 			CustomData_set_layer_name(&me->vdata, CD_MDEFORMVERT, 0, "");
 		}
 	}
+
+	/* 2.79.1: dimensions without animation are packed with the mesh, out of Mesh.mdim so older
+	 * versions read the file (without them). Nothing to do here: reading the mesh puts them back,
+	 * and 2.79.0 files with packed dimensions as NULL entries of Mesh.mdim read the same,
+	 * see direct_link_mesh_dimension_pool. */
 }
 
 void do_versions_after_linking_270(Main *main)
@@ -2150,6 +2150,103 @@ static void write_customdata(
 	}
 }
 
+#ifdef WITH_MECHANICAL_MESH_DIMENSIONS
+/* Only animated dimensions are ID blocks, others are packed with the mesh, see write_mesh_dimensions_prepare */
+static void write_dim(WriteData *wd, MDim *mdim) {
+	if (mdim->adt == NULL) {
+		return;
+	}
+
+	/* write LibData */
+	writestruct(wd, ID_DM, MDim, 1, mdim);
+	write_iddata(wd, &mdim->id);
+
+	write_animdata(wd, mdim->adt);
+
+	writedata(wd,DATA,sizeof(*mdim->v)*mdim->totverts,mdim->v);
+}
+
+/**
+ * Replaces dimension arrays of the written \a mesh copy: dimensions without animation are packed on
+ * mdim_pool, with its vertex indices in one block and its position on mdim_pool_index.
+ * Only ID blocks are left on mdim (and counted on totdim), as versions before 2.79.1 read them.
+ */
+static void write_mesh_dimensions_prepare(Mesh *mesh)
+{
+	MDim **mdim = mesh->mdim;
+	const int totdim = mesh->totdim;
+	unsigned int *verts;
+	int totpool = 0, totverts = 0, k = 0, n = 0;
+
+	mesh->mdim_pool = NULL;
+	mesh->mdim_pool_verts = NULL;
+	mesh->mdim_pool_index = NULL;
+	mesh->totdim_pool = mesh->totdim_pool_verts = 0;
+
+	for (int i = 0; i < mesh->totdim; i++) {
+		if (mdim[i]->adt == NULL) {
+			totpool++;
+			totverts += mdim[i]->totverts;
+		}
+	}
+	if (totpool == 0) {
+		return;
+	}
+
+	mesh->mdim = (totdim > totpool) ? MEM_mallocN(sizeof(*mesh->mdim) * (totdim - totpool), __func__) : NULL;
+	mesh->mdim_pool = MEM_mallocN(sizeof(*mesh->mdim_pool) * totpool, __func__);
+	mesh->mdim_pool_verts = verts = (totverts) ? MEM_mallocN(sizeof(*verts) * totverts, __func__) : NULL;
+	mesh->mdim_pool_index = MEM_mallocN(sizeof(*mesh->mdim_pool_index) * totpool, __func__);
+	mesh->totdim = totdim - totpool;
+	mesh->totdim_pool = totpool;
+	mesh->totdim_pool_verts = totverts;
+
+	for (int i = 0; i < totdim; i++) {
+		MDim *mdim_pool;
+
+		if (mdim[i]->adt) {
+			mesh->mdim[n++] = mdim[i];
+			continue;
+		}
+
+		mesh->mdim_pool_index[k] = i;
+		mdim_pool = &mesh->mdim_pool[k++];
+		*mdim_pool = *mdim[i];
+		mdim_pool->id.properties = NULL;
+		mdim_pool->v = NULL;
+		memcpy(verts, mdim[i]->v, sizeof(*verts) * mdim[i]->totverts);
+		verts += mdim[i]->totverts;
+	}
+}
+
+static void write_mesh_dimensions(WriteData *wd, Mesh *mesh)
+{
+	writedata(wd, DATA, sizeof(MDim **) * mesh->totdim, mesh->mdim);
+	writestruct(wd, DATA, MDim, mesh->totdim_pool, mesh->mdim_pool);
+	writedata(wd, DATA, sizeof(*mesh->mdim_pool_verts) * mesh->totdim_pool_verts, mesh->mdim_pool_verts);
+	writedata(wd, DATA, sizeof(*mesh->mdim_pool_index) * mesh->totdim_pool, mesh->mdim_pool_index);
+}
+
+/* Called after all data of \a mesh is written */
+static void write_mesh_dimensions_end(WriteData *wd, Mesh *mesh, Mesh *old_mesh)
+{
+	// Dimensions of a mesh pool animated in this session are not on main
+	for (int i = 0; i < old_mesh->totdim; i++) {
+		MDim *mdim = old_mesh->mdim[i];
+		if (mdim->adt && (mdim->id.tag & LIB_TAG_NO_MAIN)) {
+			write_dim(wd, mdim);
+		}
+	}
+
+	if (mesh->mdim_pool) {
+		MEM_SAFE_FREE(mesh->mdim);
+		MEM_freeN(mesh->mdim_pool);
+		MEM_SAFE_FREE(mesh->mdim_pool_verts);
+		MEM_freeN(mesh->mdim_pool_index);
+	}
+}
+#endif
+
 static void write_mesh(WriteData *wd, Mesh *mesh)
 {
 #ifdef USE_BMESH_SAVE_AS_COMPAT
@@ -2197,6 +2294,10 @@ static void write_mesh(WriteData *wd, Mesh *mesh)
 			CustomData_file_write_prepare(&mesh->ldata, &llayers, llayers_buff, ARRAY_SIZE(llayers_buff));
 			CustomData_file_write_prepare(&mesh->pdata, &players, players_buff, ARRAY_SIZE(players_buff));
 
+#ifdef WITH_MECHANICAL_MESH_DIMENSIONS
+			write_mesh_dimensions_prepare(mesh);
+#endif
+
 			writestruct_at_address(wd, ID_ME, Mesh, 1, old_mesh, mesh);
 			write_iddata(wd, &mesh->id);
 
@@ -2216,13 +2317,21 @@ static void write_mesh(WriteData *wd, Mesh *mesh)
 			write_customdata(wd, &mesh->id, mesh->totpoly, &mesh->pdata, players, -1, 0);
 
 #ifdef WITH_MECHANICAL_MESH_DIMENSIONS
-			// Dimension are pointers
-			writedata(wd, DATA, sizeof(MDim **) * mesh->totdim, mesh->mdim);
+			write_mesh_dimensions(wd, mesh);
 #endif
 
 #ifdef WITH_MECHANICAL_MESH_REFERENCE_OBJECTS
 			writedata(wd, DATA, sizeof(MReference)*mesh->totref, mesh->mref);
 #endif
+
+#ifdef WITH_MECHANICAL_GEOMETRY
+			writestruct(wd, DATA, MGeom, mesh->totgeom, mesh->mgeom);
+			writedata(wd, DATA, sizeof(*mesh->mgeom_index) * mesh->totgeom_index, mesh->mgeom_index);
+#endif
+
+#ifdef WITH_MECHANICAL_MESH_DIMENSIONS
+			write_mesh_dimensions_end(wd, mesh, old_mesh);
+#endif
 			/* restore pointer */
 			mesh = old_mesh;
 		}
@@ -3079,16 +3188,6 @@ static void write_armature(WriteData *wd, bArmature *arm)
 	}
 }
 
-#ifdef WITH_MECHANICAL_MESH_DIMENSIONS
-static void write_dim(WriteData *wd, MDim *mdim) {
-	/* write LibData */
-	writestruct(wd, ID_DM, MDim, 1, mdim);
-	write_iddata(wd, &mdim->id);
-	writedata(wd,DATA,sizeof(MVert*)*mdim->totverts,mdim->v);
-	mdim = mdim->id.next;
-}
-#endif
-
 static void write_text(WriteData *wd, Text *text)
 {
 	if ((text->flags & TXT_ISMEM) && (text->flags & TXT_ISEXT)) {
@@ -185,6 +185,9 @@ typedef struct BMDim {
 
 	struct MDim *mdim;
 
+	/* hash of vertex coordinates and placement used on last data update, 0 when unknown */
+	unsigned int data_hash;
+
 } BMDim;
 
 typedef struct BMDim_OFlag {
@@ -199,6 +202,17 @@ typedef struct BMDim_OFlag {
 #define BM_REFERENCE_TYPE_PLANE 1
 #define BM_REFERENCE_TYPE_AXIS 2
 
+/* Frame derived from reference points, see mesh_references.c */
+typedef struct BMReferenceFrame {
+	float co[4][3];    /* points the frame was computed from, v1..v4 */
+	float mat[3][3];   /* orthonormal basis, x along v1->v2 */
+	float imat[3][3];  /* inverse of mat */
+	float no[3];       /* plane normal, from v1 v2 v3 */
+	float origin[3];   /* median of v1..v4 */
+	float size;        /* v1 to v3 distance */
+	bool valid;
+} BMReferenceFrame;
+
 typedef struct BMReference {
 	BMHeader head;
 	//struct BMFlagLayer *oflags; /* keep after header, an array of flags, mostly used by the operator stack */
@@ -213,6 +227,9 @@ typedef struct BMReference {
 	float v4[3]; //Aux
 
 	float no;
+
+	/* cached, recomputed when points change */
+	BMReferenceFrame frame;
 } BMReference;
 
 typedef struct BMReference_OFlag {
@@ -344,6 +361,8 @@ typedef struct BMesh {
 
 	int toolflag_index;
 	struct BMOperator *currentop;
+	/* arenas of finished operators, reused by next ones */
+	struct BMOpArenaCache *op_arena_cache;
 	
 	CustomData vdata, edata, ldata, pdata;
 
@@ -378,6 +397,15 @@ typedef struct BMesh {
 	BMDim **dtable;
 	int dtable_tot;
 
+	/* vertex arrays of all dimensions converted from a mesh, in one block
+	 * @see BM_dim_verts_free */
+	struct BMVert **dim_verts;
+	int dim_verts_len;
+
+	/* faces & vertices grouped by plane, for dimension plane constraints.
+	 * @see mechanical_plane_index.h */
+	struct MechanicalPlaneIndex *plane_index;
+
 // WITH_MECHANICAL_MESH_REFERENCE_OBJECTS
 	// We are not using custom data for planes
 	struct BLI_mempool *ppool;
@@ -390,6 +418,23 @@ typedef struct BMesh {
 	int totgeom;
 	int totgeomsel;
 	struct BLI_mempool *gpool;
+
+	/* vertex & edge state at the last geometry detection pass,
+	 * used to only update the dirty region. @see mechanical_update_mesh_geometry_dirty */
+	BMVert **geom_vtable;
+	float (*geom_vco)[3];
+	BMEdge **geom_etable;
+	int geom_vtable_tot;
+	int geom_etable_tot;
+
+	/* vertex/edge -> LinkNode list of BMGeom using it, kept in sync by the kill/split
+	 * routines of bmesh_core. @see mechanical_geometry_of_elem */
+	struct GHash *geom_map;
+	struct BLI_mempool *geom_map_pool;
+	/* vertices left by geometry removed between passes */
+	struct GSet *geom_vdirty;
+	/* incremented on any geometry change, for data cached from geometry */
+	unsigned int geom_stamp;
 //
 
 } BMesh;
@@ -49,6 +49,7 @@
 #include "mesh_references.h"
 #include "mechanical_utils.h"
 #include "mechanical_geometry.h"
+#include "mechanical_plane_index.h"
 
 /* use so valgrinds memcheck alerts us when undefined index is used.
  * TESTING ONLY! */
@@ -816,7 +817,10 @@ static void bm_kill_only_vert(BMesh *bm, BMVert *v)
 #endif
 
 #ifdef WITH_MECHANICAL_GEOMETRY
-	mechanical_clean_geometry(bm);
+	mechanical_geometry_elem_kill(bm, v);
+#endif
+#ifdef WITH_MECHANICAL_MESH_DIMENSIONS
+	mechanical_plane_index_free(bm);
 #endif
 
 	bm->totvert--;
@@ -840,6 +844,10 @@ static void bm_kill_only_vert(BMesh *bm, BMVert *v)
  */
 static void bm_kill_only_edge(BMesh *bm, BMEdge *e)
 {
+#ifdef WITH_MECHANICAL_GEOMETRY
+	mechanical_geometry_elem_kill(bm, e);
+#endif
+
 	bm->totedge--;
 	bm->elem_index_dirty |= BM_EDGE;
 	bm->elem_table_dirty |= BM_EDGE;
@@ -861,6 +869,10 @@ static void bm_kill_only_edge(BMesh *bm, BMEdge *e)
  */
 static void bm_kill_only_face(BMesh *bm, BMFace *f)
 {
+#ifdef WITH_MECHANICAL_MESH_DIMENSIONS
+	mechanical_plane_index_free(bm);
+#endif
+
 	if (bm->act_face == f)
 		bm->act_face = NULL;
 
@@ -1689,6 +1701,11 @@ BMVert *bmesh_kernel_split_edge_make_vert(BMesh *bm, BMVert *tv, BMEdge *e, BMEd
 
 	v_old = BM_edge_other_vert(e, tv);
 
+#ifdef WITH_MECHANICAL_GEOMETRY
+	/* 'e' no longer uses 'tv' */
+	mechanical_geometry_elem_kill(bm, e);
+#endif
+
 #ifndef NDEBUG
 	valence1 = bmesh_disk_count(v_old);
 	valence2 = bmesh_disk_count(tv);
@@ -3053,7 +3070,18 @@ void bm_kill_only_dim(BMesh *bm, BMDim *edm)
 		}
 	}
 
-	MEM_freeN(v);  //Free edm->v
+	BM_dim_verts_free(bm, v);  //Free edm->v
+}
+
+/**
+ * Frees a dimension vertex array, unless it's on the block of dimensions converted from a mesh.
+ */
+void BM_dim_verts_free(BMesh *bm, BMVert **v)
+{
+	if (bm->dim_verts && (v >= bm->dim_verts) && (v < bm->dim_verts + bm->dim_verts_len)) {
+		return;
+	}
+	MEM_freeN(v);
 }
 #endif
 
@@ -3097,6 +3125,7 @@ BMDim *BM_dim_create(
 
 	BMDim *edm = BLI_mempool_alloc(bm->dpool);
 	edm->mdim = mdm;
+	edm->data_hash = 0;
 
 	BMReference *erf;
 	BMIter iter;
@@ -3134,10 +3163,16 @@ BMDim *BM_dim_create(
 
 
 	edm->totverts = v_count;
-	edm->v = MEM_mallocN(sizeof(MVert*)*edm->totverts, "Dimension vertex pointer array");
-	for (int n=0;n<edm->totverts;n++){
-		BLI_assert(v[n]->head.htype == BM_VERT);
-		edm->v[n] = v[n];
+	if (create_flag & BM_CREATE_DIM_KEEP_VERTS) {
+		BLI_assert(v >= bm->dim_verts && v + v_count <= bm->dim_verts + bm->dim_verts_len);
+		edm->v = v;
+	}
+	else {
+		edm->v = MEM_mallocN(sizeof(MVert*)*edm->totverts, "Dimension vertex pointer array");
+		for (int n=0;n<edm->totverts;n++){
+			BLI_assert(v[n]->head.htype == BM_VERT);
+			edm->v[n] = v[n];
+		}
 	}
 	if (create_flag & BM_CREATE_USE_SELECT_ORDER) {
 		qsort(edm->v,edm->totverts, sizeof (MVert*), order_select_compare);
@@ -3290,6 +3325,7 @@ BMReference *BM_reference_create(
 	copy_v3_v3(erf->v2,v2);
 	copy_v3_v3(erf->v3,v3);
 	copy_v3_v3(erf->v4,v4);
+	erf->frame.valid = false;
 	if(name == NULL) {
 		BLI_strncpy(def_name, "Reference", MAX_NAME);
 		BLI_uniquename_cb(unique_name_reference_check, bm, def_name, '.', erf->name, 50);
@@ -43,7 +43,9 @@ typedef enum eBMCreateFlag {
 	BM_CREATE_SKIP_CD   = (1 << 2),
 #ifdef WITH_MECHANICAL_MESH_DIMENSIONS
 	BM_CREATE_USE_SELECT_ORDER   = (1 << 3),
-	BM_CREATE_SET_DEFAULT_DATA = (1 << 4)
+	BM_CREATE_SET_DEFAULT_DATA = (1 << 4),
+	/* Dimension keeps the given vertex array, allocated on bm->dim_verts */
+	BM_CREATE_DIM_KEEP_VERTS = (1 << 5)
 #endif
 } eBMCreateFlag;
 
@@ -136,6 +138,7 @@ BMDim *BM_dim_create(
 		const BMDim *d_example, const eBMCreateFlag create_flag, struct MDim *mdm);
 
 void BM_dim_kill(BMesh *bm, BMDim *edm);
+void BM_dim_verts_free(BMesh *bm, BMVert **v);
 void bm_kill_only_dim(BMesh *bm, BMDim *edm);
 #endif
 
@@ -45,6 +45,8 @@
 
 #include "intern/bmesh_private.h"
 
+#include "mechanical_plane_index.h"
+
 /* used as an extern, defined in bmesh.h */
 #ifdef WITH_MECHANICAL_MESH_DIMENSIONS
 // WITH_MECHANICAL_MESH_REFERENCE_OBJECTS
@@ -351,6 +353,16 @@ void BM_mesh_data_free(BMesh *bm)
 	CustomData_free(&bm->ldata, 0);
 	CustomData_free(&bm->pdata, 0);
 
+#ifdef WITH_MECHANICAL_MESH_DIMENSIONS
+	{
+		BMDim *edm;
+		BM_ITER_MESH (edm, &iter, bm, BM_DIMS_OF_MESH) {
+			BM_dim_verts_free(bm, edm->v);
+		}
+		MEM_SAFE_FREE(bm->dim_verts);
+	}
+#endif
+
 	/* destroy element pools */
 	BLI_mempool_destroy(bm->vpool);
 	BLI_mempool_destroy(bm->epool);
@@ -366,8 +378,11 @@ void BM_mesh_data_free(BMesh *bm)
 	if (bm->vtable) MEM_freeN(bm->vtable);
 	if (bm->etable) MEM_freeN(bm->etable);
 	if (bm->ftable) MEM_freeN(bm->ftable);
+
+	BMO_op_arena_cache_free(bm);
 #ifdef WITH_MECHANICAL_MESH_DIMENSIONS
 	if (bm->dtable) MEM_freeN(bm->dtable);
+	mechanical_plane_index_free(bm);
 #endif
 
 #ifdef WITH_MECHANICAL_GEOMETRY
@@ -376,6 +391,16 @@ void BM_mesh_data_free(BMesh *bm)
 		MEM_freeN(egm->e);
 	}
 	BLI_mempool_destroy(bm->gpool);
+	MEM_SAFE_FREE(bm->geom_vtable);
+	MEM_SAFE_FREE(bm->geom_vco);
+	MEM_SAFE_FREE(bm->geom_etable);
+	if (bm->geom_map) {
+		BLI_ghash_free(bm->geom_map, NULL, NULL);
+		BLI_mempool_destroy(bm->geom_map_pool);
+	}
+	if (bm->geom_vdirty) {
+		BLI_gset_free(bm->geom_vdirty, NULL);
+	}
 #endif
 
 	/* destroy flag pool */
@@ -534,6 +559,11 @@ void BM_mesh_normals_update(BMesh *bm)
 {
 	float (*edgevec)[3] = MEM_mallocN(sizeof(*edgevec) * bm->totedge, __func__);
 
+#ifdef WITH_MECHANICAL_MESH_DIMENSIONS
+	/* face normals may change, @see mechanical_plane_index_normals_update */
+	mechanical_plane_index_free(bm);
+#endif
+
 #pragma omp parallel sections if (bm->totvert + bm->totedge + bm->totface >= BM_OMP_LIMIT)
 	{
 #pragma omp section
@@ -85,6 +85,7 @@
 
 #include "BLI_listbase.h"
 #include "BLI_alloca.h"
+#include "BLI_ghash.h"
 #include "BLI_math_vector.h"
 #include "BLI_string.h"
 
@@ -100,6 +101,8 @@
 #include "intern/bmesh_private.h" /* for element checking */
 
 #include "mesh_dimensions.h"
+#include "mesh_dimensions_driven.h"
+#include "mechanical_geometry.h"
 
 /**
  * Currently this is only used for Python scripts
@@ -225,10 +228,12 @@ static void BM_references_from_me_references(BMesh *bm, Mesh *me)
 	BMReference *erf;
 	MReference *mrf;
 	mrf = me->mref;
-	for (int i = 0; i < me->totref; i++, mrf++) {
 
+	if (me->totref) {
 		BM_mesh_elem_toolflags_ensure(bm);
+	}
 
+	for (int i = 0; i < me->totref; i++, mrf++) {
 
 		erf = BM_reference_create(bm, mrf->type, mrf->p1,mrf->p2, mrf->p3, mrf->p4, mrf->name, NULL,BM_CREATE_SKIP_CD);
 
@@ -245,6 +250,36 @@ static void BM_references_from_me_references(BMesh *bm, Mesh *me)
 }
 
 
+#ifdef WITH_MECHANICAL_MESH_DIMENSIONS
+/**
+ * Frees vertex indices of the dimensions removed from the mesh, kept ones reuse them.
+ */
+static void bm_to_me_dims_free_removed(MDim **mdim_old, const int totdim_old, MDim **mdim, const int totdim)
+{
+	GSet *kept;
+	int i;
+
+	/* usually the same dimensions, in the same order */
+	for (i = 0; (i < totdim_old) && (i < totdim) && (mdim_old[i] == mdim[i]); i++) {
+		/* pass */
+	}
+	if (i == totdim_old) {
+		return;
+	}
+
+	kept = BLI_gset_ptr_new_ex(__func__, (unsigned int)(totdim - i));
+	for (int j = i; j < totdim; j++) {
+		BLI_gset_add(kept, mdim[j]);
+	}
+	for (; i < totdim_old; i++) {
+		if (!BLI_gset_haskey(kept, mdim_old[i])) {
+			MEM_SAFE_FREE(mdim_old[i]->v);
+		}
+	}
+	BLI_gset_free(kept, NULL);
+}
+#endif
+
 /**
  * \brief Mesh -> BMesh
  *
@@ -413,22 +448,39 @@ void BM_mesh_bm_from_me(
 
 #ifdef WITH_MECHANICAL_MESH_DIMENSIONS
 	if (me->totdim) {
+		/* Vertex arrays of all dimensions are kept in one block, unless the bmesh has one already */
+		const bool use_verts_block = (bm->dim_verts == NULL);
+		BMVert **v_arr = NULL;
+		int totverts = 0;
+
 		dtable = MEM_mallocN(sizeof(void *) * me->totdim, "mesh to bmesh dtable");
 
 		for (i = 0; i < me->totdim; i++) {
-			BMVert *(*v_arr);
-			mdim = me->mdim[i];
+			totverts += me->mdim[i]->totverts;
+		}
+		if (use_verts_block) {
+			bm->dim_verts = v_arr = MEM_mallocN(sizeof(*v_arr) * totverts, "BMesh dimension vertex arrays");
+			bm->dim_verts_len = totverts;
+		}
+		else {
+			v_arr = MEM_mallocN(sizeof(*v_arr) * totverts, "BMVert temp array");
+		}
+
+		BM_mesh_elem_toolflags_ensure(bm);
 
-			BM_mesh_elem_toolflags_ensure(bm);
+		for (i = 0; i < me->totdim; i++) {
+			mdim = me->mdim[i];
 
-			v_arr = MEM_mallocN(sizeof (BMVert*)*mdim->totverts,"BMVert temp array");
 			for (int k=0;k<mdim->totverts;k++) {
 				v_arr[k] = vtable[mdim->v[k]];
 			}
 
-			d = dtable[i] = BM_dim_create(bm,v_arr,mdim->totverts,mdim->dim_type,NULL,BM_CREATE_SKIP_CD, mdim);
+			d = dtable[i] = BM_dim_create(bm, v_arr, mdim->totverts, mdim->dim_type, NULL,
+			                              BM_CREATE_SKIP_CD | (use_verts_block ? BM_CREATE_DIM_KEEP_VERTS : 0), mdim);
 
-			MEM_freeN (v_arr);
+			if (use_verts_block) {
+				v_arr += mdim->totverts;
+			}
 
 			BM_elem_index_set(d, i); /* set_ok */
 
@@ -439,10 +491,16 @@ void BM_mesh_bm_from_me(
 			if (mdim->flag & SELECT) {
 				BM_dim_select_set(bm, d, true);
 			}
+		}
 
-			dimension_data_update(bm, d, NULL);
+		if (!use_verts_block) {
+			MEM_freeN(v_arr);
 		}
 
+		/* once all are created, updates only depend on its own vertices */
+		dimension_data_update_array(bm, dtable, me->totdim);
+		MEM_freeN(dtable);
+
 		bm->elem_index_dirty &= ~BM_DIM; /* added in order, clear dirty flag */
 	}
 #endif
@@ -570,6 +628,10 @@ void BM_mesh_bm_from_me(
 		}
 	}
 
+#ifdef WITH_MECHANICAL_GEOMETRY
+	mechanical_geometry_from_mesh(bm, me, vtable, etable);
+#endif
+
 	MEM_freeN(vtable);
 	MEM_freeN(etable);
 }
@@ -668,6 +730,8 @@ void BM_mesh_bm_to_me(
 	BMFace *f;
 #ifdef WITH_MECHANICAL_MESH_DIMENSIONS
 	BMDim *edm;
+	MDim **mdim_old;
+	int totdim_old;
 #endif
 #ifdef WITH_MECHANICAL_MESH_REFERENCE_OBJECTS
 	BMReference *erf;
@@ -682,6 +746,11 @@ void BM_mesh_bm_to_me(
 
 	ototvert = me->totvert;
 
+#ifdef WITH_MECHANICAL_MESH_DIMENSIONS
+	// Mesh is rebuilt, the BMesh used for driven dimensions no longer matches it
+	mesh_dimensions_driven_cache_free(me);
+#endif
+
 	/* new vertex block */
 	if (bm->totvert == 0) mvert = NULL;
 	else mvert = MEM_callocN(bm->totvert * sizeof(MVert), "loadeditbMesh vert");
@@ -699,11 +768,10 @@ void BM_mesh_bm_to_me(
 	else mloop = MEM_callocN(bm->totloop * sizeof(MLoop), "loadeditbMesh loop");
 
 #ifdef WITH_MECHANICAL_MESH_DIMENSIONS
-	if (me->totdim) {
-		for (int n=0;n<me->totdim;n++) {
-			MEM_freeN(me->mdim[n]->v);
-		}
-	}
+	/* vertex indices of kept dimensions are reused, see bm_to_me_dims_free_removed */
+	mdim_old = me->mdim;
+	totdim_old = me->totdim;
+
 	/* new dimension block */
 	if (bm->totdim == 0) {
 		me->mdim =  NULL;
@@ -817,22 +885,28 @@ void BM_mesh_bm_to_me(
 
 #ifdef WITH_MECHANICAL_MESH_DIMENSIONS
 	BM_ITER_MESH_INDEX(edm, &iter, bm, BM_DIMS_OF_MESH, i) {
+		MDim *mdim = me->mdim[i] = edm->mdim;
 
-		me->mdim[i] = edm->mdim;
-		me->mdim[i]->totverts = edm->totverts;
-		me->mdim[i]->flag = BM_dimension_flag_to_mflag(edm);
-		me->mdim[i]->v = MEM_callocN(sizeof(int)*edm->totverts, "Mesh Dimension index array");
+		if (mdim->v == NULL || mdim->totverts != edm->totverts) {
+			MEM_SAFE_FREE(mdim->v);
+			mdim->v = MEM_mallocN(sizeof(*mdim->v) * edm->totverts, "Mesh Dimension index array");
+		}
+		mdim->totverts = edm->totverts;
+		mdim->flag = BM_dimension_flag_to_mflag(edm);
 		for (int n=0;n<edm->totverts;n++) {
-			me->mdim[i]->v[n] = BM_elem_index_get(edm->v[n]);
+			mdim->v[n] = BM_elem_index_get(edm->v[n]);
 		}
 
-
-
 		BM_elem_index_set(edm, i); /* set_inline */
 
 		BM_CHECK_ELEMENT(edm);
 	}
 	bm->elem_index_dirty &= ~BM_DIM;
+
+	bm_to_me_dims_free_removed(mdim_old, totdim_old, me->mdim, me->totdim);
+	if (mdim_old) {
+		MEM_freeN(mdim_old);
+	}
 #endif
 #ifdef WITH_MECHANICAL_MESH_REFERENCE_OBJECTS
 	BM_ITER_MESH_INDEX(erf,&iter,bm,BM_REFERENCES_OF_MESH, i) {
@@ -1116,6 +1190,11 @@ void BM_mesh_bm_to_me(
 
 	if (oldverts) MEM_freeN(oldverts);
 
+#ifdef WITH_MECHANICAL_GEOMETRY
+	/* after vertex coordinates are final, the geometry is stored with their hash */
+	mechanical_geometry_to_mesh(bm, me);
+#endif
+
 	/* topology could be changed, ensure mdisps are ok */
 	multires_topology_changed(me);
 }
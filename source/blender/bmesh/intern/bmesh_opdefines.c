@@ -2095,6 +2095,25 @@ static BMOpDefine bmo_dimension_data_def = {
 	(BMO_OPTYPE_FLAG_SELECT_FLUSH),
 };
 
+/*
+ * Applies dimension values.
+ *
+ * Applies the value set on many dimensions in one pass, ordered by dependency.
+ * Only usable from C, python has no dimension elements to fill the dims slot.
+ */
+static BMOpDefine bmo_dimension_apply_def = {
+	"dimension_apply",
+	/* slots_in */
+	{{"dims", BMO_OP_SLOT_ELEMENT_BUF, {BM_DIM}},    /* input dimensions */
+	 {"constraints", BMO_OP_SLOT_INT},    /* constraints of dimensions not overriding them */
+	 {"scene", BMO_OP_SLOT_PTR, {(int)BMO_OP_SLOT_SUBTYPE_PTR_SCENE}},  /* for transform orientation aligned dimensions */
+	 {{'\0'}},
+	},
+	{{{'\0'}}},  /* no output */
+	bmo_dimension_apply_exec,
+	(BMO_OPTYPE_FLAG_NOP),
+};
+
 #endif
 
 #ifdef WITH_MECHANICAL_MESH_REFERENCE_OBJECTS
@@ -2213,6 +2232,7 @@ const BMOpDefine *bmo_opdefines[] = {
 #ifdef WITH_MECHANICAL_MESH_DIMENSIONS
 	&bmo_create_dimension_def,
     &bmo_dimension_data_def,
+	&bmo_dimension_apply_def,
 #endif
 #ifdef WITH_MECHANICAL_MESH_REFERENCE_OBJECTS
     &bmo_create_reference_element_def,
@@ -342,6 +342,10 @@ void BMO_op_exec(BMesh *bm, BMOperator *op);
  * after it finishes executing in BMO_op_exec).*/
 void BMO_op_finish(BMesh *bm, BMOperator *op);
 
+/* temporary memory for an operator exec, freed by BMO_op_finish. */
+void *BMO_op_scratch_alloc(BMOperator *op, const size_t size);
+void *BMO_op_scratch_calloc(BMOperator *op, const size_t size);
+
 /* count the number of elements with the specified flag enabled.
  * type can be a bitmask of BM_FACE, BM_EDGE, or BM_FACE. */
 int BMO_mesh_enabled_flag_count(BMesh *bm, const char htype, const short oflag);
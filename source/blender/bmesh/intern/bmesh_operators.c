@@ -162,6 +162,91 @@ static void bmo_op_slots_free(const BMOSlotType *slot_types, BMOpSlot *slot_args
 	}
 }
 
+/* Operator arenas
+ *
+ * Slot buffers and scratch memory of an operator come from its arena. When the operator finishes
+ * the arena is cleared and kept on the mesh, next operators reuse it instead of allocating again.
+ * Operators called from other operators take their own arena, so a few of them are kept.
+ * Arenas grown by large meshes are freed, clearing would keep their last (large) buffer.
+ */
+
+/* Arenas kept for reuse, deeper nested operators free theirs */
+#define BMO_OP_ARENA_CACHE_SIZE 8
+/* Arenas holding more than this aren't kept */
+#define BMO_OP_ARENA_CACHE_BUFSIZE (BLI_MEMARENA_STD_BUFSIZE * 4)
+
+typedef struct BMOpArenaCache {
+	MemArena *arenas[BMO_OP_ARENA_CACHE_SIZE];
+	int arenas_len;
+} BMOpArenaCache;
+
+static MemArena *bmo_op_arena_get(BMesh *bm)
+{
+	BMOpArenaCache *cache = bm->op_arena_cache;
+
+	if (cache && cache->arenas_len) {
+		return cache->arenas[--cache->arenas_len];
+	}
+	return BLI_memarena_new(BLI_MEMARENA_STD_BUFSIZE, "bmesh operator arena");
+}
+
+static void bmo_op_arena_release(BMesh *bm, MemArena *arena)
+{
+	BMOpArenaCache *cache = bm->op_arena_cache;
+
+	if (cache == NULL) {
+		cache = bm->op_arena_cache = MEM_callocN(sizeof(*cache), __func__);
+	}
+
+	if ((cache->arenas_len == BMO_OP_ARENA_CACHE_SIZE) ||
+	    (BLI_memarena_size_get(arena) > BMO_OP_ARENA_CACHE_BUFSIZE))
+	{
+		BLI_memarena_free(arena);
+		return;
+	}
+
+	/* Not using calloc, only rewinds to the first buffer. */
+	BLI_memarena_clear(arena);
+	cache->arenas[cache->arenas_len++] = arena;
+}
+
+/**
+ * Frees the arenas kept by finished operators.
+ */
+void BMO_op_arena_cache_free(BMesh *bm)
+{
+	BMOpArenaCache *cache = bm->op_arena_cache;
+
+	if (cache == NULL) {
+		return;
+	}
+
+	for (int i = 0; i < cache->arenas_len; i++) {
+		BLI_memarena_free(cache->arenas[i]);
+	}
+	MEM_freeN(cache);
+	bm->op_arena_cache = NULL;
+}
+
+/**
+ * \brief BMESH OPSTACK SCRATCH ALLOC
+ *
+ * Temporary memory for the operator exec, freed all at once on #BMO_op_finish.
+ * Use instead of MEM_mallocN for arrays not outliving the operator.
+ */
+void *BMO_op_scratch_alloc(BMOperator *op, const size_t size)
+{
+	return BLI_memarena_alloc(op->arena, size);
+}
+
+/**
+ * Same as #BMO_op_scratch_alloc, with zeroed memory.
+ */
+void *BMO_op_scratch_calloc(BMOperator *op, const size_t size)
+{
+	return BLI_memarena_calloc(op->arena, size);
+}
+
 /**
  * \brief BMESH OPSTACK INIT OP
  *
@@ -173,8 +258,6 @@ void BMO_op_init(BMesh *bm, BMOperator *op, const int flag, const char *opname)
 
 #ifdef DEBUG
 	BM_ELEM_INDEX_VALIDATE(bm, "pre bmo", opname);
-#else
-	(void)bm;
 #endif
 
 	if (opcode == -1) {
@@ -193,9 +276,8 @@ void BMO_op_init(BMesh *bm, BMOperator *op, const int flag, const char *opname)
 	/* callback */
 	op->exec = bmo_opdefines[opcode]->exec;
 
-	/* memarena, used for operator's slot buffers */
-	op->arena = BLI_memarena_new(BLI_MEMARENA_STD_BUFSIZE, __func__);
-	BLI_memarena_use_calloc(op->arena);
+	/* memarena, used for operator's slot buffers and scratch memory */
+	op->arena = bmo_op_arena_get(bm);
 }
 
 /**
@@ -234,15 +316,13 @@ void BMO_op_finish(BMesh *bm, BMOperator *op)
 	bmo_op_slots_free(bmo_opdefines[op->type]->slot_types_in,  op->slots_in);
 	bmo_op_slots_free(bmo_opdefines[op->type]->slot_types_out, op->slots_out);
 
-	BLI_memarena_free(op->arena);
+	bmo_op_arena_release(bm, op->arena);
 
 #ifdef DEBUG
 	BM_ELEM_INDEX_VALIDATE(bm, "post bmo", bmo_opdefines[op->type]->opname);
 
 	/* avoid accidental re-use */
 	memset(op, 0xff, sizeof(*op));
-#else
-	(void)bm;
 #endif
 }
 
@@ -327,7 +407,7 @@ void _bmo_slot_copy(
 
 			if (slot_dst->len) {
 				const int slot_alloc_size = BMO_OPSLOT_TYPEINFO[slot_dst->slot_type] * slot_dst->len;
-				slot_dst->data.buf = BLI_memarena_alloc(arena_dst, slot_alloc_size);
+				slot_dst->data.buf = BLI_memarena_calloc(arena_dst, slot_alloc_size);
 				if (slot_src->len == slot_dst->len) {
 					memcpy(slot_dst->data.buf, slot_src->data.buf, slot_alloc_size);
 				}
@@ -405,7 +485,7 @@ void BMO_slot_mat_set(BMOperator *op, BMOpSlot slot_args[BMO_OP_MAX_SLOTS], cons
 		return;
 
 	slot->len = 4;
-	slot->data.p = BLI_memarena_alloc(op->arena, sizeof(float) * 4 * 4);
+	slot->data.p = BLI_memarena_calloc(op->arena, sizeof(float) * 4 * 4);
 	
 	if (size == 4) {
 		copy_m4_m4(slot->data.p, (float (*)[4])mat);
@@ -824,7 +904,7 @@ void *BMO_slot_buffer_alloc(BMOperator *op, BMOpSlot slot_args[BMO_OP_MAX_SLOTS]
 	
 	slot->len = len;
 	if (len) {
-		slot->data.buf = BLI_memarena_alloc(op->arena, BMO_OPSLOT_TYPEINFO[slot->slot_type] * len);
+		slot->data.buf = BLI_memarena_calloc(op->arena, BMO_OPSLOT_TYPEINFO[slot->slot_type] * len);
 	}
 	else {
 		slot->data.buf = NULL;
@@ -1015,7 +1095,7 @@ void BMO_slot_buffer_from_single(BMOperator *op, BMOpSlot *slot, BMHeader *ele)
 
 	BLI_assert(slot->slot_subtype.elem & ele->htype);
 
-	slot->data.buf = BLI_memarena_alloc(op->arena, sizeof(void *) * 4);  /* XXX, why 'x4' ? */
+	slot->data.buf = BLI_memarena_calloc(op->arena, sizeof(void *) * 4);  /* XXX, why 'x4' ? */
 	slot->len = 1;
 	*slot->data.buf = ele;
 }
@@ -1027,7 +1107,7 @@ void BMO_slot_buffer_from_array(BMOperator *op, BMOpSlot *slot, BMHeader **ele_b
 	BLI_assert(slot->len == 0 || slot->len == ele_buffer_len);
 
 	if (slot->data.buf == NULL) {
-		slot->data.buf = BLI_memarena_alloc(op->arena, sizeof(*slot->data.buf) * ele_buffer_len);
+		slot->data.buf = BLI_memarena_calloc(op->arena, sizeof(*slot->data.buf) * ele_buffer_len);
 	}
 
 	slot->len = ele_buffer_len;
@@ -1068,7 +1148,7 @@ void _bmo_slot_buffer_append(
 		int elem_size = BMO_OPSLOT_TYPEINFO[slot_dst->slot_type];
 		int alloc_size = elem_size * (slot_dst->len + slot_src->len);
 		/* allocate new buffer */
-		void *buf = BLI_memarena_alloc(arena_dst, alloc_size);
+		void *buf = BLI_memarena_calloc(arena_dst, alloc_size);
 
 		/* copy slot data */
 		memcpy(buf, slot_dst->data.buf, elem_size * slot_dst->len);
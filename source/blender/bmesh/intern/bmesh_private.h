@@ -80,6 +80,9 @@ enum {
 
 void poly_rotate_plane(const float normal[3], float (*verts)[3], unsigned const int nverts);
 
+/* bmesh_operators.c */
+void BMO_op_arena_cache_free(BMesh *bm);
+
 /* include the rest of our private declarations */
 #include "bmesh_structure.h"
 
@@ -232,7 +232,7 @@ static void dimension_data_reset(BMesh *bm, BMOperator *op) {
 				BMO_vert_flag_enable(bm, edm->v[i], EXT_OUT);
 			}
 		}
-		MEM_freeN(edm->v);
+		BM_dim_verts_free(bm, edm->v);
 		edm->v = vv;
 		edm->totverts = count;
 	}
@@ -282,7 +282,7 @@ static void dimension_data_set(BMesh *bm, BMOperator *op) {
 
 		}
 
-		MEM_freeN(edm->v);
+		BM_dim_verts_free(bm, edm->v);
 		edm->v = vv;
 		edm->totverts = total;
 	}
@@ -315,3 +315,31 @@ void bmo_dimension_data_exec(BMesh *bm, BMOperator *op)
 
 
 }
+
+/*
+ * Dimension apply operator
+ *
+ */
+
+void bmo_dimension_apply_exec(BMesh *bm, BMOperator *op)
+{
+	int tot;
+	BMDim **dims = BMO_slot_as_arrayN(op->slots_in, "dims", &tot);
+	Scene *scene = BMO_slot_ptr_get(op->slots_in, "scene");
+
+	// Dimensions aligned to the transform orientation are measured on the scene orientation
+	if (scene == NULL) {
+		for (int i = 0; i < tot; i++) {
+			if (dims[i]->mdim->dimension_flag & DIMENSION_FLAG_TS_ALIGNED) {
+				BMO_error_raise(bm, op, BMERR_INVALID_SELECTION,
+				                "Dimensions aligned to the transform orientation need a scene");
+				MEM_freeN(dims);
+				return;
+			}
+		}
+	}
+
+	apply_dimension_values(bm, dims, tot, BMO_slot_int_get(op->slots_in, "constraints"), scene);
+
+	MEM_freeN(dims);
+}
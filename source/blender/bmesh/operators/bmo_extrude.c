@@ -567,7 +567,7 @@ void bmo_extrude_face_region_exec(BMesh *bm, BMOperator *op)
  * Note that this does not work so well for non-manifold
  * regions.
  */
-static void calc_solidify_normals(BMesh *bm)
+static void calc_solidify_normals(BMesh *bm, BMOperator *op)
 {
 	BMIter viter, eiter, fiter;
 	BMVert *v;
@@ -577,7 +577,7 @@ static void calc_solidify_normals(BMesh *bm)
 	int i;
 
 	/* can't use BM_edge_face_count because we need to count only marked faces */
-	int *edge_face_count = MEM_callocN(sizeof(int) * bm->totedge, __func__);
+	int *edge_face_count = BMO_op_scratch_calloc(op, sizeof(int) * bm->totedge);
 
 	BM_ITER_MESH (v, &viter, bm, BM_VERTS_OF_MESH) {
 		BM_elem_flag_enable(v, BM_ELEM_TAG);
@@ -616,7 +616,6 @@ static void calc_solidify_normals(BMesh *bm)
 			BMO_vert_flag_enable(bm, e->v2, VERT_NONMAN);
 		}
 	}
-	MEM_freeN(edge_face_count);
 	edge_face_count = NULL; /* don't re-use */
 
 	BM_ITER_MESH (v, &viter, bm, BM_VERTS_OF_MESH) {
@@ -712,13 +711,13 @@ static void calc_solidify_normals(BMesh *bm)
 	}
 }
 
-static void solidify_add_thickness(BMesh *bm, const float dist)
+static void solidify_add_thickness(BMesh *bm, BMOperator *op, const float dist)
 {
 	BMFace *f;
 	BMVert *v;
 	BMLoop *l;
 	BMIter iter, loopIter;
-	float *vert_angles = MEM_callocN(sizeof(float) * bm->totvert * 2, "solidify"); /* 2 in 1 */
+	float *vert_angles = BMO_op_scratch_calloc(op, sizeof(float) * bm->totvert * 2); /* 2 in 1 */
 	float *vert_accum = vert_angles + bm->totvert;
 	int i, index;
 
@@ -761,8 +760,6 @@ static void solidify_add_thickness(BMesh *bm, const float dist)
 			madd_v3_v3fl(v->co, v->no, dist * (vert_angles[index] / vert_accum[index]));
 		}
 	}
-
-	MEM_freeN(vert_angles);
 }
 
 void bmo_solidify_face_region_exec(BMesh *bm, BMOperator *op)
@@ -789,8 +786,8 @@ void bmo_solidify_face_region_exec(BMesh *bm, BMOperator *op)
 
 	/* Push the verts of the extruded faces inward to create thickness */
 	BMO_slot_buffer_flag_enable(bm, extrudeop.slots_out, "geom.out", BM_FACE, FACE_MARK);
-	calc_solidify_normals(bm);
-	solidify_add_thickness(bm, thickness);
+	calc_solidify_normals(bm, op);
+	solidify_add_thickness(bm, op, thickness);
 
 	BMO_slot_copy(&extrudeop, slots_out, "geom.out",
 	              op,         slots_out, "geom.out");
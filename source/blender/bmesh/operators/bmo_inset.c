@@ -694,9 +694,9 @@ void bmo_inset_region_exec(BMesh *bm, BMOperator *op)
 	int i, k;
 
 	if (use_interpolate) {
-		interp_arena = BLI_memarena_new(BLI_MEMARENA_STD_BUFSIZE, __func__);
+		interp_arena = op->arena;
 		/* warning, we could be more clever here and not over alloc */
-		iface_array = MEM_callocN(sizeof(*iface_array) * bm->totface, __func__);
+		iface_array = BMO_op_scratch_calloc(op, sizeof(*iface_array) * bm->totface);
 		iface_array_len = bm->totface;
 	}
 
@@ -738,7 +738,7 @@ void bmo_inset_region_exec(BMesh *bm, BMOperator *op)
 	}
 	bm->elem_index_dirty |= BM_EDGE;
 
-	edge_info = MEM_mallocN(edge_info_len * sizeof(SplitEdgeInfo), __func__);
+	edge_info = BMO_op_scratch_alloc(op, edge_info_len * sizeof(SplitEdgeInfo));
 
 	/* fill in array and initialize tagging */
 	es = edge_info;
@@ -1268,9 +1268,6 @@ void bmo_inset_region_exec(BMesh *bm, BMOperator *op)
 				bm_interp_face_free(iface_array[i], bm);
 			}
 		}
-
-		BLI_memarena_free(interp_arena);
-		MEM_freeN(iface_array);
 	}
 
 	/* we could flag new edges/verts too, is it useful? */
@@ -1317,7 +1314,7 @@ void bmo_inset_region_exec(BMesh *bm, BMOperator *op)
 		 * which BM_vert_calc_shell_factor uses. */
 
 		/* over allocate */
-		varr_co = MEM_callocN(sizeof(*varr_co) * bm->totvert, __func__);
+		varr_co = BMO_op_scratch_calloc(op, sizeof(*varr_co) * bm->totvert);
 
 		BM_ITER_MESH_INDEX (v, &iter, bm, BM_VERTS_OF_MESH, i) {
 			if (BM_elem_flag_test(v, BM_ELEM_TAG)) {
@@ -1333,8 +1330,5 @@ void bmo_inset_region_exec(BMesh *bm, BMOperator *op)
 				copy_v3_v3(v->co, varr_co[i]);
 			}
 		}
-		MEM_freeN(varr_co);
 	}
-
-	MEM_freeN(edge_info);
 }
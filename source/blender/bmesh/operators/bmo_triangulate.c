@@ -118,7 +118,7 @@ void bmo_triangle_fill_exec(BMesh *bm, BMOperator *op)
 		uint i;
 		bool is_degenerate = true;
 
-		nors = MEM_mallocN(sizeof(*nors) * nors_tot, __func__);
+		nors = BMO_op_scratch_alloc(op, sizeof(*nors) * nors_tot);
 
 		for (sf_vert = sf_ctx.fillvertbase.first, i = 0; sf_vert; sf_vert = sf_vert->next, i++) {
 			BMVert *v = sf_vert->tmp.p;
@@ -178,8 +178,6 @@ void bmo_triangle_fill_exec(BMesh *bm, BMOperator *op)
 			}
 			normalize_v3(normal);
 		}
-
-		MEM_freeN(nors);
 	}
 	else {
 		calc_winding = false;
@@ -74,6 +74,7 @@
 #include "bmesh_tools.h"
 
 #include "mesh_dimensions.h"
+#include "mechanical_geometry.h"
 
 #include "mesh_intern.h"  /* own include */
 
@@ -2214,16 +2215,10 @@ bool EDBM_select_pick(bContext *C, const int mval[2], bool extend, bool deselect
 		}
 #ifdef WITH_MECHANICAL_GEOMETRY
 		else if (eed && vc.em->selectmode == SCE_SELECT_GEOMETRY) {
-			BMGeom *egm;
-			BMIter iter;
- 			int i =0;
 			// Look for geom element
-			BM_ITER_MESH (egm, &iter, vc.em->bm, BM_GEOMETRY_OF_MESH ) {
-				for (i=0; (egm->e[i] != eed) && (i < egm->totedges); i++);
-				if (i < egm->totedges) {
-					EDBM_select_pick_geometry(vc.em, egm, extend, deselect, toggle);
-					break;
-				}
+			LinkNode *link = mechanical_geometry_of_elem(vc.em->bm, eed);
+			if (link) {
+				EDBM_select_pick_geometry(vc.em, link->link, extend, deselect, toggle);
 			}
 		}
 #endif
@@ -237,6 +237,10 @@ static void join_mesh_single(
 #ifdef WITH_MECHANICAL_MESH_DIMENSIONS
 	if (me->totdim) {
 		for (a = 0; a < me->totdim; a++) {
+			if (me != ob_dst->data) {
+				// Packed dimensions are freed with its mesh
+				BKE_mesh_dimension_pool_to_main(bmain, me, a);
+			}
 			mdim[a+(*dimofs)] = me->mdim[a];
 			for (int i=0;i<me->mdim[a]->totverts;i++) {
 				mdim[a+(*dimofs)]->v[i] = me->mdim[a]->v[i] += (*vertofs);
@@ -48,6 +48,7 @@
 #include "BLI_string.h"
 #include "BLI_math.h"
 #include "BLI_memarena.h"
+#include "BLI_hash_mm2a.h"
 
 #include "BKE_anim.h"  /* for the where_on_path function */
 #include "BKE_armature.h"
@@ -88,6 +89,7 @@
 #include "BIF_gl.h"
 #include "BIF_glutil.h"
 
+#include "GPU_buffers.h"
 #include "GPU_draw.h"
 #include "GPU_select.h"
 #include "GPU_basic_shader.h"
@@ -2883,35 +2885,217 @@ static void draw_angle_3p_dimension(float *center, float *start, float *end, flo
 /**
  * /Brief Draw dimensions in ObjectMode
  *
-*/
-static void draw_om_dim(MDim *mdm,DerivedMesh *dm)
+ * Lines and points of all mesh dimensions are kept on one buffer and labels are formatted once,
+ * both rebuilt only when dimension data or its vertices change. Evaluated vertices of dimensions
+ * are read from Object.dim_eval, filled once the derived mesh is built.
+ */
+
+typedef struct DimDrawLabel {
+	float co[3];
+	float xoffs;
+	char str[32];
+	int str_len;
+} DimDrawLabel;
+
+typedef struct DimDrawCache {
+	unsigned int hash;
+
+	/* lines, followed by points */
+	float (*co)[3];
+	GPUBuffer *vbo;
+	int lines_tot, points_tot;
+
+	DimDrawLabel *labels;
+	int labels_tot;
+} DimDrawCache;
+
+/* Segments of angle dimension arc, as mechanical_draw_circle */
+#define DIM_DRAW_ARC_SEGMENTS 32
+
+static void draw_ob_dims_cache_free(Mesh *me)
 {
+	DimDrawCache *cache = me->dim_draw_cache;
 
-	switch (mdm->dim_type) {
-		case DIM_TYPE_LINEAR:
-			draw_linear_dimension (CDDM_get_vert(dm,mdm->v[0])->co,
-								   CDDM_get_vert(dm,mdm->v[1])->co,
-								   mdm->start,
-								   mdm->end,
-								   mdm->dpos,
-								   false,
-									NULL, NULL);
-			break;
-		case DIM_TYPE_DIAMETER:
-			draw_diameter_dimension(mdm->start, mdm->end, mdm->dpos, false);
-			break;
-		case DIM_TYPE_RADIUS:
-			draw_radius_dimension(mdm->start, mdm->end, mdm->dpos, false);
-			break;
-		case DIM_TYPE_ANGLE_3P:
-		case DIM_TYPE_ANGLE_4P:
-			draw_angle_3p_dimension(
-			            mdm->center, mdm->start, mdm->end, mdm->dpos, false);
-			break;
-		default:
-			BLI_assert(0);
+	GPU_buffer_free(cache->vbo);
+	MEM_SAFE_FREE(cache->co);
+	MEM_SAFE_FREE(cache->labels);
+	MEM_freeN(cache);
+	me->dim_draw_cache = NULL;
+}
+
+static unsigned int draw_ob_dims_hash(Mesh *me, const MeshDimEval *eval)
+{
+	BLI_HashMurmur2A mm2;
+
+	BLI_hash_mm2a_init(&mm2, 0);
+	BLI_hash_mm2a_add_int(&mm2, me->totdim);
+	// Labels size
+	BLI_hash_mm2a_add_int(&mm2, U.widget_unit);
+	// Evaluated vertices of linear dimensions, hashed once evaluated
+	BLI_hash_mm2a_add_int(&mm2, (int)eval->hash);
+
+	for (int i = 0; i < me->totdim; i++) {
+		MDim *mdm = me->mdim[i];
+		BLI_hash_mm2a_add_int(&mm2, mdm->dim_type);
+		BLI_hash_mm2a_add(&mm2, (const unsigned char *)mdm->start, sizeof(float[3]));
+		BLI_hash_mm2a_add(&mm2, (const unsigned char *)mdm->end, sizeof(float[3]));
+		BLI_hash_mm2a_add(&mm2, (const unsigned char *)mdm->center, sizeof(float[3]));
+		BLI_hash_mm2a_add(&mm2, (const unsigned char *)mdm->dpos, sizeof(float[3]));
 	}
 
+	return BLI_hash_mm2a_end(&mm2);
+}
+
+static void draw_ob_dims_label_add(DimDrawLabel *label, const float co[3], const float value)
+{
+	float w, h;
+
+	copy_v3_v3(label->co, co);
+	label->str_len = BLI_snprintf_rlen(label->str, sizeof(label->str), "%.6g", value);
+	BLF_width_and_height(UIFONT_DEFAULT, label->str, sizeof(label->str), &w, &h);
+	label->xoffs = -w / 2;
+}
+
+static void draw_ob_dims_cache_build(DimDrawCache *cache, Mesh *me, const MeshDimEval *eval)
+{
+	float (*lines)[3], (*points)[3];
+	int lines_tot = 0, points_tot = 0;
+
+	// Count
+	for (int i = 0; i < me->totdim; i++) {
+		switch (me->mdim[i]->dim_type) {
+			case DIM_TYPE_LINEAR:
+				lines_tot += 6;
+				break;
+			case DIM_TYPE_DIAMETER:
+			case DIM_TYPE_RADIUS:
+				lines_tot += 2;
+				break;
+			case DIM_TYPE_ANGLE_3P:
+			case DIM_TYPE_ANGLE_4P:
+				lines_tot += DIM_DRAW_ARC_SEGMENTS * 2 + 4;
+				break;
+		}
+		points_tot += 2;
+	}
+
+	MEM_SAFE_FREE(cache->co);
+	MEM_SAFE_FREE(cache->labels);
+	cache->co = MEM_mallocN(sizeof(*cache->co) * (lines_tot + points_tot), __func__);
+	cache->labels = MEM_mallocN(sizeof(*cache->labels) * me->totdim, __func__);
+	cache->lines_tot = lines_tot;
+	cache->points_tot = points_tot;
+	cache->labels_tot = me->totdim;
+
+	lines = cache->co;
+	points = cache->co + lines_tot;
+
+	for (int i = 0; i < me->totdim; i++) {
+		MDim *mdm = me->mdim[i];
+		DimDrawLabel *label = &cache->labels[i];
+
+		copy_v3_v3(*points++, mdm->start);
+		copy_v3_v3(*points++, mdm->end);
+
+		switch (mdm->dim_type) {
+			case DIM_TYPE_LINEAR:
+			{
+				copy_v3_v3(*lines++, eval->vco[i][0]);
+				copy_v3_v3(*lines++, mdm->start);
+				copy_v3_v3(*lines++, eval->vco[i][1]);
+				copy_v3_v3(*lines++, mdm->end);
+				copy_v3_v3(*lines++, mdm->start);
+				copy_v3_v3(*lines++, mdm->end);
+				draw_ob_dims_label_add(label, mdm->dpos, len_v3v3(mdm->start, mdm->end));
+				break;
+			}
+			case DIM_TYPE_DIAMETER:
+			case DIM_TYPE_RADIUS:
+				copy_v3_v3(*lines++, mdm->start);
+				copy_v3_v3(*lines++, mdm->end);
+				draw_ob_dims_label_add(label, mdm->dpos, len_v3v3(mdm->start, mdm->end));
+				break;
+			case DIM_TYPE_ANGLE_3P:
+			case DIM_TYPE_ANGLE_4P:
+			{
+				float vr1[3], vr2[3], axis[3], pos[3], prev[3];
+				float dim_angle, step;
+
+				sub_v3_v3v3(vr1, mdm->start, mdm->center);
+				normalize_v3(vr1);
+				sub_v3_v3v3(vr2, mdm->end, mdm->center);
+				normalize_v3(vr2);
+				cross_v3_v3v3(axis, vr1, vr2);
+				dim_angle = RAD2DEG(acos(dot_v3v3(vr1, vr2)));
+				step = dim_angle / (float)DIM_DRAW_ARC_SEGMENTS;
+
+				sub_v3_v3v3(vr1, mdm->start, mdm->center);
+				add_v3_v3v3(prev, vr1, mdm->center);
+				for (int j = 1; j <= DIM_DRAW_ARC_SEGMENTS; j++) {
+					rotate_v3_v3v3fl(pos, vr1, axis, DEG2RAD(step * j));
+					add_v3_v3(pos, mdm->center);
+					copy_v3_v3(*lines++, prev);
+					copy_v3_v3(*lines++, pos);
+					copy_v3_v3(prev, pos);
+				}
+
+				copy_v3_v3(*lines++, mdm->center);
+				copy_v3_v3(*lines++, mdm->start);
+				copy_v3_v3(*lines++, mdm->center);
+				copy_v3_v3(*lines++, mdm->end);
+				draw_ob_dims_label_add(label, mdm->dpos, dim_angle);
+				break;
+			}
+			default:
+				BLI_assert(0);
+				zero_v3(*lines++);
+				zero_v3(*lines++);
+				draw_ob_dims_label_add(label, mdm->dpos, 0.0f);
+				break;
+		}
+	}
+
+	// Upload, drawn from client memory when not possible
+	GPU_buffer_free(cache->vbo);
+	cache->vbo = GPU_buffer_alloc(sizeof(*cache->co) * (lines_tot + points_tot));
+	if (cache->vbo) {
+		void *varray = GPU_buffer_lock(cache->vbo, GPU_BINDING_ARRAY);
+		if (varray) {
+			memcpy(varray, cache->co, sizeof(*cache->co) * (lines_tot + points_tot));
+			GPU_buffer_unlock(cache->vbo, GPU_BINDING_ARRAY);
+		}
+		else {
+			GPU_buffer_unbind(cache->vbo, GPU_BINDING_ARRAY);
+			GPU_buffer_free(cache->vbo);
+			cache->vbo = NULL;
+		}
+	}
+}
+
+static DimDrawCache *draw_ob_dims_cache_ensure(Object *ob, DerivedMesh *dm)
+{
+	Mesh *me = ob->data;
+	DimDrawCache *cache = me->dim_draw_cache;
+	unsigned int hash;
+
+	// Filled after building the derived mesh, also done here for other derived meshes
+	if (ob->dim_eval == NULL || ob->dim_eval->totdim != me->totdim || dm != ob->derivedFinal) {
+		BKE_mesh_dim_eval_update(ob, dm);
+	}
+	hash = draw_ob_dims_hash(me, ob->dim_eval);
+
+	if (cache && cache->hash == hash) {
+		return cache;
+	}
+
+	if (cache == NULL) {
+		BKE_mesh_dim_draw_cache_free_cb = draw_ob_dims_cache_free;
+		cache = me->dim_draw_cache = MEM_callocN(sizeof(*cache), __func__);
+	}
+	draw_ob_dims_cache_build(cache, me, ob->dim_eval);
+	cache->hash = hash;
+
+	return cache;
 }
 #endif
 
@@ -3027,8 +3211,37 @@ static void draw_em_dims(BMEditMesh *em, RegionView3D *rv3d, Object *obedit, Sce
 static void draw_ob_dims(Object *ob, DerivedMesh *dm)
 {
 	Mesh *me = ob->data;
-	for (int i=0;i<me->totdim;i++) {
-		draw_om_dim(me->mdim[i], dm);
+	DimDrawCache *cache;
+	unsigned char col[4], tcol[4];
+
+	if (me->totdim == 0) {
+		return;
+	}
+
+	cache = draw_ob_dims_cache_ensure(ob, dm);
+	get_dimension_theme_values(false, col, tcol);
+
+	glColor3ubv(col);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	if (cache->vbo) {
+		GPU_buffer_bind(cache->vbo, GPU_BINDING_ARRAY);
+		glVertexPointer(3, GL_FLOAT, 0, NULL);
+	}
+	else {
+		glVertexPointer(3, GL_FLOAT, 0, cache->co);
+	}
+	glDrawArrays(GL_LINES, 0, cache->lines_tot);
+	glPointSize(2);
+	glDrawArrays(GL_POINTS, cache->lines_tot, cache->points_tot);
+	if (cache->vbo) {
+		GPU_buffer_unbind(cache->vbo, GPU_BINDING_ARRAY);
+	}
+	glDisableClientState(GL_VERTEX_ARRAY);
+
+	for (int i = 0; i < cache->labels_tot; i++) {
+		DimDrawLabel *label = &cache->labels[i];
+		view3d_cached_text_draw_add(label->co, label->str, label->str_len, label->xoffs,
+		                            V3D_CACHE_TEXT_LOCALCLIP | V3D_CACHE_TEXT_ASCII, tcol);
 	}
 }
 
@@ -2928,7 +2928,7 @@ int transformEnd(bContext *C, TransInfo *t)
 				em = BKE_editmesh_from_object(t->obedit);
 			}
 			if (em && t->scene->geom_enabled && t->obedit->geom_enabled) {
-				mechanical_update_mesh_geometry(em->bm);
+				mechanical_update_mesh_geometry_dirty(em->bm);
 			}
 		}
 #endif
@@ -76,9 +76,30 @@ typedef struct SnapObjectData_Mesh {
 
 } SnapObjectData_Mesh;
 
+/* Circle or arc giving snap points depending on snap target (ortho and tangent points) */
+typedef struct SnapGeomCircle {
+	BMGeom *egm;
+	float radius;
+} SnapGeomCircle;
+
+/* Object space snap points of the mesh geometry not depending on snap target
+ * (end, mid and center points), rebuilt only when geometry or snap options change.
+ * Circles are kept to compute its target dependent points only when near the cursor. */
+typedef struct SnapGeomData {
+	BVHTree *tree;
+	float (*points)[3];
+	int points_tot;
+	SnapGeomCircle *circles;
+	int circles_tot;
+	int max_points;
+	short snap_options;
+	unsigned int geom_stamp;
+} SnapGeomData;
+
 typedef struct SnapObjectData_EditMesh {
 	SnapObjectData sd;
 	BVHTreeFromEditMesh *bvh_trees[2];
+	SnapGeomData *geom_data;
 
 } SnapObjectData_EditMesh;
 
@@ -340,11 +361,10 @@ static int snap_geom_ortho(const ARegion *ar,  BMGeom *egm, float obmat[4][4], s
 	return 0;
 
 }
-static int snap_geom_ortho_circle(const ARegion *ar,  BMGeom *egm, float obmat[4][4], snap_geom_point *(*p), float *snap_target){
+static int snap_geom_ortho_circle(const ARegion *ar,  BMGeom *egm, float radius, float obmat[4][4], snap_geom_point *(*p), float *snap_target){
 
 	if(snap_target){
 		float v1[3];
-		float radius= len_v3v3(egm->center, egm->v[0]->co);
 		isect_ortho_line_circl(radius, egm->center, snap_target, v1);
 		return snap_geom_point_values(ar, v1, p, obmat);
 	}
@@ -352,7 +372,7 @@ static int snap_geom_ortho_circle(const ARegion *ar,  BMGeom *egm, float obmat[4
 
 }
 
-static int snap_geom_tangent(const ARegion *ar, BMGeom *egm, float obmat[4][4], snap_geom_point *(*p), float *snap_target)
+static int snap_geom_tangent(const ARegion *ar, BMGeom *egm, float radius, float obmat[4][4], snap_geom_point *(*p), float *snap_target)
 {
 	int n_geom_points = 0;
 	if(snap_target) {
@@ -361,7 +381,7 @@ static int snap_geom_tangent(const ARegion *ar, BMGeom *egm, float obmat[4][4],
 		float c2[3];
 		int a = 0;
 		copy_v3_v3(c2, snap_target);
-		r1=len_v3v3(egm->center, egm->v[0]->co);
+		r1=radius;
 		float dist= len_v3v3(c2, egm->center);
 		r2= sqrt(dist*dist-r1*r1);
 		a = isect_circle_circle(r1, egm->center, r2, c2, egm->axis, isect1, isect2);
@@ -377,98 +397,315 @@ static int snap_geom_tangent(const ARegion *ar, BMGeom *egm, float obmat[4][4],
 }
 
 
-static int init_geom_snap_data (const ARegion *ar, BMEditMesh *em, float obmat[4][4], snap_geom_point **points, float *snap_target, Scene *scene) {
-	int max_geom_points = get_max_geom_points(em->bm);
+static short snap_geom_options(BMEditMesh *em, Scene *scene)
+{
+	return (em->snap_options == GEOM_DEFAULT) ? scene->geomsnapflag : em->snap_options;
+}
+
+/**
+ * Fills \a r_points with the object space points not depending on snap target.
+ * \a r_points has to be sized to #get_max_geom_points.
+ */
+static int snap_geom_fixed_points(BMesh *bm, short snap_options, float (*r_points)[3])
+{
+	int n_geom_points = 0;
+	BMGeom *egm;
+	BMIter iter;
+	const bool snap_end = (snap_options & GEOM_LINE_END_POINT) != 0;
+	const bool snap_mid_line = (snap_options & GEOM_LINE_MID_POINT) != 0;
+	const bool snap_mid_arc = (snap_options & GEOM_ARC_MID_POINT) != 0;
+	const bool snap_center_arc_circle = (snap_options & GEOM_CENTER_POINT) != 0;
+
+	BM_ITER_MESH (egm, &iter, bm, BM_GEOMETRY_OF_MESH) {
+		switch (egm->geometry_type) {
+			case BM_GEOMETRY_TYPE_LINE:
+				if (snap_end) {
+					copy_v3_v3(r_points[n_geom_points++], egm->start);
+					copy_v3_v3(r_points[n_geom_points++], egm->end);
+				}
+				if (snap_mid_line) {
+					copy_v3_v3(r_points[n_geom_points++], egm->mid);
+				}
+				break;
+			case BM_GEOMETRY_TYPE_CIRCLE:
+				if (snap_center_arc_circle) {
+					copy_v3_v3(r_points[n_geom_points++], egm->center);
+				}
+				break;
+			case BM_GEOMETRY_TYPE_ARC:
+				if (snap_center_arc_circle) {
+					copy_v3_v3(r_points[n_geom_points++], egm->center);
+				}
+				if (snap_end) {
+					copy_v3_v3(r_points[n_geom_points++], egm->start);
+					copy_v3_v3(r_points[n_geom_points++], egm->end);
+				}
+				if (snap_mid_arc) {
+					copy_v3_v3(r_points[n_geom_points++], egm->mid);
+				}
+				break;
+		}
+	}
+	return n_geom_points;
+}
+
+static void snap_geom_data_free(SnapGeomData *sgd)
+{
+	if (sgd->tree) {
+		BLI_bvhtree_free(sgd->tree);
+		sgd->tree = NULL;
+	}
+	MEM_SAFE_FREE(sgd->points);
+	sgd->points_tot = 0;
+	MEM_SAFE_FREE(sgd->circles);
+	sgd->circles_tot = 0;
+}
+
+static void snap_geom_circles_ensure(SnapGeomData *sgd, BMesh *bm)
+{
+	BMGeom *egm;
+	BMIter iter;
+
+	if (sgd->circles) {
+		return;
+	}
+
+	sgd->circles = MEM_mallocN(sizeof(*sgd->circles) * max_ii(bm->totgeom, 1), __func__);
+	BM_ITER_MESH (egm, &iter, bm, BM_GEOMETRY_OF_MESH) {
+		if (ELEM(egm->geometry_type, BM_GEOMETRY_TYPE_CIRCLE, BM_GEOMETRY_TYPE_ARC)) {
+			SnapGeomCircle *circle = &sgd->circles[sgd->circles_tot++];
+			circle->egm = egm;
+			circle->radius = len_v3v3(egm->center, egm->v[0]->co);
+		}
+	}
+}
+
+/* Fewer fixed points are tested one by one, building and walking a tree costs more */
+#define SNAP_GEOM_TREE_MIN_POINTS 64
+
+/**
+ * \param use_tree: Build a tree of the points, only worth it when \a sgd is kept between events.
+ */
+static void snap_geom_data_ensure(SnapGeomData *sgd, BMesh *bm, short snap_options, const bool use_tree)
+{
+	if (sgd->points && sgd->geom_stamp == bm->geom_stamp && sgd->snap_options == snap_options) {
+		return;
+	}
+
+	snap_geom_data_free(sgd);
+
+	sgd->snap_options = snap_options;
+	sgd->geom_stamp = bm->geom_stamp;
+	sgd->max_points = get_max_geom_points(bm);
+	sgd->points = MEM_mallocN(sizeof(*sgd->points) * max_ii(sgd->max_points, 1), __func__);
+	sgd->points_tot = snap_geom_fixed_points(bm, snap_options, sgd->points);
+
+	if (use_tree && sgd->points_tot >= SNAP_GEOM_TREE_MIN_POINTS) {
+		sgd->tree = BLI_bvhtree_new(sgd->points_tot, 0.0f, 2, 6);
+		for (int i = 0; i < sgd->points_tot; i++) {
+			BLI_bvhtree_insert(sgd->tree, i, sgd->points[i], 1);
+		}
+		BLI_bvhtree_balance(sgd->tree);
+	}
+}
+
+/* Screen radius of a circle is taken from the pixel size at its center,
+ * larger as the size changes along the circle on perspective views. */
+#define SNAP_GEOM_CIRCLE_CULL_MARGIN 2.0f
+
+/**
+ * \return false when no point of the circle can be inside \a dist_px of \a mval_fl.
+ */
+static bool snap_geom_circle_near(
+        const ARegion *ar, const SnapGeomCircle *circle, float obmat[4][4], const float obscale,
+        const float mval_fl[2], const float dist_px)
+{
+	float center[3], screen_center[2];
+	float pixel_size, radius_px;
+
+	mul_v3_m4v3(center, obmat, circle->egm->center);
+	if (ED_view3d_project_float_global(ar, center, screen_center, V3D_PROJ_TEST_NOP) != V3D_PROJ_RET_OK) {
+		return true;
+	}
+	pixel_size = ED_view3d_pixel_size(ar->regiondata, center);
+	if (pixel_size <= 0.0f) {
+		return true;
+	}
+	radius_px = (circle->radius * obscale / pixel_size) * SNAP_GEOM_CIRCLE_CULL_MARGIN;
+
+	return len_v2v2(mval_fl, screen_center) <= radius_px + dist_px;
+}
+
+/**
+ * Points depending on \a snap_target (ortho and tangent points), computed on each call.
+ * Points of circles and arcs are only computed when they may be inside \a dist_px.
+ */
+static int init_geom_snap_data (
+        const ARegion *ar, BMEditMesh *em, SnapGeomData *sgd, float obmat[4][4], snap_geom_point **points,
+        float *snap_target, short snap_options, const float mval_fl[2], const float dist_px)
+{
 	int n_geom_points = 0;
 	BMGeom *egm;
 	BMIter iter;
-	bool snap_end_line = false;
-	bool snap_mid_line = false;
-	bool snap_end_arc = false;
-	bool snap_mid_arc = false;
-	bool snap_center_arc_circle = false;
 	bool snap_ortho = false;
 	bool snap_tangents=false;
+	float obscale;
 
-	short snap_options = (em->snap_options == GEOM_DEFAULT) ? scene->geomsnapflag : em->snap_options;
-
-	if(snap_options & GEOM_LINE_END_POINT) snap_end_line = true;
-	if(snap_options & GEOM_LINE_MID_POINT) snap_mid_line = true;
-	if(snap_options & GEOM_LINE_END_POINT) snap_end_arc = true;
-	if(snap_options & GEOM_ARC_MID_POINT) snap_mid_arc = true;
-	if(snap_options & GEOM_CENTER_POINT) snap_center_arc_circle = true;
 	if(snap_options & GEOM_ORTHO_POINT) snap_ortho = true;
 	if(snap_options & GEOM_TANGENT_POINT) snap_tangents = true;
-	else if(snap_options) BLI_assert(false);
 
-	*points = MEM_callocN(sizeof(snap_geom_point)*max_geom_points, "Snap points array");
+	if (!(snap_target && (snap_ortho || snap_tangents))) {
+		*points = NULL;
+		return 0;
+	}
+
+	*points = MEM_callocN(sizeof(snap_geom_point) * max_ii(sgd->max_points, 1), "Snap points array");
 	snap_geom_point *p = *points;
-	BM_ITER_MESH (egm, &iter, em->bm, BM_GEOMETRY_OF_MESH) {
-			switch (egm->geometry_type) {
-				case BM_GEOMETRY_TYPE_LINE:
-					if(snap_end_line) {
-						n_geom_points +=  snap_geom_point_values(ar, egm->start, &p, obmat);
-						n_geom_points +=  snap_geom_point_values(ar, egm->end, &p, obmat);
-					}
-					if(snap_mid_line) {
-						n_geom_points += snap_geom_point_values(ar, egm->mid, &p, obmat);
-					}
-					if(snap_ortho){
-						n_geom_points += snap_geom_ortho(ar, egm, obmat, &p, snap_target);
-					}
-				break;
-				case BM_GEOMETRY_TYPE_CIRCLE:
-					if(snap_center_arc_circle) {
-						n_geom_points +=  snap_geom_point_values(ar, egm->center, &p, obmat);
-					}
-					if(snap_ortho && point_on_plane(egm->center, egm->axis, snap_target)){
-						n_geom_points += snap_geom_ortho_circle(ar, egm, obmat, &p, snap_target);
-					}
-					if (snap_tangents && point_on_plane(egm->center, egm->axis, snap_target)) {
-						n_geom_points += snap_geom_tangent(ar, egm, obmat, &p, snap_target);
-					}
-				break;
-				case BM_GEOMETRY_TYPE_ARC:
-					if(snap_center_arc_circle) {
-						n_geom_points +=  snap_geom_point_values(ar, egm->center, &p, obmat);
-					}
-					if(snap_end_arc) {
-						n_geom_points +=  snap_geom_point_values(ar, egm->start, &p, obmat);
-						n_geom_points +=  snap_geom_point_values(ar, egm->end, &p, obmat);
-					}
-					if(snap_mid_arc) {
-						n_geom_points += snap_geom_point_values(ar, egm->mid, &p, obmat);
-					}
-					if (snap_tangents && point_on_plane(egm->center, egm->axis, snap_target)) {
-						n_geom_points += snap_geom_tangent(ar, egm, obmat, &p, snap_target);
-					}
-					if(snap_ortho && point_on_plane(egm->center, egm->axis, snap_target)){
-						n_geom_points += snap_geom_ortho_circle(ar, egm, obmat, &p, snap_target);
-					}
-				break;
+
+	if (snap_ortho) {
+		BM_ITER_MESH (egm, &iter, em->bm, BM_GEOMETRY_OF_MESH) {
+			if (egm->geometry_type == BM_GEOMETRY_TYPE_LINE) {
+				n_geom_points += snap_geom_ortho(ar, egm, obmat, &p, snap_target);
 			}
+		}
+	}
 
+	snap_geom_circles_ensure(sgd, em->bm);
+	obscale = mat4_to_scale(obmat);
 
+	for (int i = 0; i < sgd->circles_tot; i++) {
+		const SnapGeomCircle *circle = &sgd->circles[i];
+		egm = circle->egm;
+
+		if (!point_on_plane(egm->center, egm->axis, snap_target) ||
+		    !snap_geom_circle_near(ar, circle, obmat, obscale, mval_fl, dist_px))
+		{
+			continue;
+		}
+		if (snap_ortho) {
+			n_geom_points += snap_geom_ortho_circle(ar, egm, circle->radius, obmat, &p, snap_target);
+		}
+		if (snap_tangents) {
+			n_geom_points += snap_geom_tangent(ar, egm, circle->radius, obmat, &p, snap_target);
+		}
 	}
 
 	return n_geom_points;
 
 }
 
-static bool snapGeom(const ARegion *ar, BMEditMesh *em, float obmat[4][4],  const float mval_fl[2], float *dist_px, float r_loc[3], float UNUSED(r_no[3]), float *snap_target, Scene *scene )
+/* Nearest fixed point on screen, found walking the tree of SnapGeomData */
+typedef struct SnapGeomNearest {
+	const ARegion *ar;
+	float (*points)[3];
+	float (*obmat)[4];
+	const float *mval;
+	float dist_px;
+	snap_geom_point point;
+	bool found;
+} SnapGeomNearest;
+
+/* Skips nodes whose screen bounds are farther than the nearest point found so far. */
+static bool snap_geom_walk_parent_cb(const BVHTreeAxisRange *bounds, void *userdata)
+{
+	SnapGeomNearest *data = userdata;
+	float rect_min[2] = {FLT_MAX, FLT_MAX}, rect_max[2] = {-FLT_MAX, -FLT_MAX};
+	float dx, dy;
+
+	for (int i = 0; i < 8; i++) {
+		float co[3], co_px[2];
+		co[0] = (i & 1) ? bounds[0].max : bounds[0].min;
+		co[1] = (i & 2) ? bounds[1].max : bounds[1].min;
+		co[2] = (i & 4) ? bounds[2].max : bounds[2].min;
+		mul_m4_v3(data->obmat, co);
+		// Bounds crossing the view plane don't project to a rectangle
+		if (ED_view3d_project_float_global(data->ar, co, co_px, V3D_PROJ_TEST_CLIP_NEAR) != V3D_PROJ_RET_OK) {
+			return true;
+		}
+		minmax_v2v2_v2(rect_min, rect_max, co_px);
+	}
+
+	dx = max_fff(rect_min[0] - data->mval[0], data->mval[0] - rect_max[0], 0.0f);
+	dy = max_fff(rect_min[1] - data->mval[1], data->mval[1] - rect_max[1], 0.0f);
+	return (dx + dy) < data->dist_px;
+}
+
+static bool snap_geom_nearest_test(SnapGeomNearest *data, float co[3])
+{
+	snap_geom_point point, *p = &point;
+	float dist;
+
+	if (!snap_geom_point_values(data->ar, co, &p, data->obmat)) {
+		return true;
+	}
+	dist = len_manhattan_v2v2(data->mval, point.mval);
+	if (dist < data->dist_px) {
+		data->dist_px = dist;
+		data->point = point;
+		data->found = true;
+	}
+	return (dist != 0.0f);
+}
+
+static bool snap_geom_walk_leaf_cb(const BVHTreeAxisRange *UNUSED(bounds), int index, void *userdata)
+{
+	SnapGeomNearest *data = userdata;
+	return snap_geom_nearest_test(data, data->points[index]);
+}
+
+static bool snap_geom_walk_order_cb(const BVHTreeAxisRange *UNUSED(bounds), char UNUSED(axis), void *UNUSED(userdata))
+{
+	return true;
+}
+
+/**
+ * Fixed points inside \a dist_px are looked up on a BVH tree of them, skipping parts of the tree
+ * out of \a dist_px on screen. \a sgd may be NULL when the snap context doesn't cache data,
+ * then all points are tested without a tree.
+ */
+static bool snapGeom(
+        const ARegion *ar, BMEditMesh *em, SnapGeomData *sgd, float obmat[4][4], const float mval_fl[2], float *dist_px,
+        float r_loc[3], float UNUSED(r_no[3]), float *snap_target, Scene *scene )
 {
 	snap_geom_point *points, *found = NULL;
+	SnapGeomData sgd_stack = {NULL};
+	SnapGeomNearest nearest;
 	bool retval = false;
 	int num_geom_points = 0;
 	int i =0;
+	const short snap_options = snap_geom_options(em, scene);
+	const bool use_cache = (sgd != NULL);
 
 	float dist = 0;
 
+	if (sgd == NULL) {
+		sgd = &sgd_stack;
+	}
+	snap_geom_data_ensure(sgd, em->bm, snap_options, use_cache);
+
+	nearest.ar = ar;
+	nearest.points = sgd->points;
+	nearest.obmat = obmat;
+	nearest.mval = mval_fl;
+	nearest.dist_px = *dist_px;
+	nearest.found = false;
+	if (sgd->tree) {
+		BLI_bvhtree_walk_dfs(sgd->tree, snap_geom_walk_parent_cb, snap_geom_walk_leaf_cb,
+		                     snap_geom_walk_order_cb, &nearest);
+	}
+	else {
+		for (i = 0; i < sgd->points_tot; i++) {
+			if (!snap_geom_nearest_test(&nearest, sgd->points[i])) {
+				break;
+			}
+		}
+	}
+	if (nearest.found) {
+		*dist_px = nearest.dist_px;
+		found = &nearest.point;
+	}
 
-	//**********************
-	num_geom_points = init_geom_snap_data(ar, em, obmat, &points, snap_target, scene);
-
-
+	num_geom_points = init_geom_snap_data(ar, em, sgd, obmat, &points, snap_target, snap_options, mval_fl, *dist_px);
 
 	// Search Data
 	for (i=0;i<num_geom_points;i++) {
@@ -491,7 +728,12 @@ static bool snapGeom(const ARegion *ar, BMEditMesh *em, float obmat[4][4],  cons
 	}
 
 	// Free data
-	MEM_freeN(points);
+	if (points) {
+		MEM_freeN(points);
+	}
+	if (sgd == &sgd_stack) {
+		snap_geom_data_free(sgd);
+	}
 
 
 	return retval;
@@ -1457,7 +1699,16 @@ static bool snapEditMesh(
 			case SCE_SNAP_MODE_GEOM:
 			{
 
-				retval |= snapGeom(ar, em, obmat,  mval, dist_px, r_loc, r_no, snap_target, scene);
+				SnapGeomData *sgd = NULL;
+				if (sod) {
+					if (sod->geom_data == NULL) {
+						sod->geom_data = BLI_memarena_calloc(sctx->cache.mem_arena, sizeof(*sod->geom_data));
+					}
+					sgd = sod->geom_data;
+				}
+				retval |= snapGeom(
+				        ar, em, sgd, obmat, mval, dist_px,
+				        r_loc, r_no, snap_target, scene);
 				break;
 			}
 		}
@@ -1760,6 +2011,9 @@ static void snap_object_data_free(void *sod_v)
 					free_bvhtree_from_editmesh(sod->bvh_trees[i]);
 				}
 			}
+			if (sod->geom_data) {
+				snap_geom_data_free(sod->geom_data);
+			}
 			break;
 		}
 	}
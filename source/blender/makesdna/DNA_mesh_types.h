@@ -52,6 +52,7 @@ struct Material;
 struct Mesh;
 struct Multires;
 struct MDim;
+struct MGeom;
 
 typedef struct Mesh {
 	ID id;
@@ -134,6 +135,19 @@ typedef struct Mesh {
 	int totdim, totref;
 	struct MReference *mref;
 	struct MDim **mdim;	/* array of pointers to dimensions */
+	struct MDim *mdim_pool;	/* dimensions without animation, packed in one block instead of an ID each */
+	unsigned int *mdim_pool_verts;	/* file only, vertex indices of packed dimensions */
+	int *mdim_pool_index;	/* file only, position of each packed dimension on mdim */
+	struct BMesh *dim_bm;	/* not saved in file! used to apply driven dimensions out of edit mode */
+	void *dim_draw_cache;	/* not saved in file! dimensions drawn out of edit mode */
+	int totdim_pool, totdim_pool_verts;
+
+// WITH_MECHANICAL_GEOMETRY
+	struct MGeom *mgeom;	/* geometry detected in edit mode */
+	int *mgeom_index;	/* vertex and edge indices of mgeom */
+	int totgeom, totgeom_index;
+	unsigned int geom_hash;	/* hash of edges and vertex coordinates mgeom was detected on, 0 when not set */
+	int pad_geom;
 	/* */
 
 /**/
@@ -128,6 +128,23 @@ typedef struct MDim {
 } MDim;
 /* */
 
+// WITH_MECHANICAL_GEOMETRY
+/* Geometry detected in edit mode, kept on the mesh. Same data than BMGeom,
+ * its vertex indices then edge indices are on Mesh.mgeom_index from index_start */
+typedef struct MGeom {
+	int geometry_type;
+	int totverts, totedges;
+	int index_start;
+
+	float center[3];
+	float axis[3];
+	float start[3];
+	float end[3];
+	float mid[3];
+	int pad;
+} MGeom;
+/* */
+
 // WITH_MECHANICAL_MESH_REFERENCE_OBJECTS
 typedef struct MReference {
 	unsigned int type;
@@ -53,6 +53,7 @@ struct SoftBody;
 struct FluidsimSettings;
 struct ParticleSystem;
 struct DerivedMesh;
+struct MeshDimEval;
 struct SculptSession;
 struct bGPdata;
 struct RigidBodyOb;
@@ -318,6 +319,9 @@ typedef struct Object {
 // WITH_MECHANICAL_GEOMETRY
 	int geom_enabled;
 	char pad3[4];
+
+// WITH_MECHANICAL_MESH_DIMENSIONS
+	struct MeshDimEval *dim_eval;	/* runtime, evaluated dimension data for drawing */
 } Object;
 
 /* Warning, this is not used anymore because hooks are now modifiers */
@@ -7,6 +7,16 @@
 
 
 #include "BLI_math.h"
+#include "BLI_bitmap.h"
+#include "BLI_ghash.h"
+#include "BLI_linklist.h"
+#include "BLI_mempool.h"
+#include "BLI_array.h"
+#include "BLI_hash_mm2a.h"
+#include "BLI_task.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
 
 
 #include "mechanical_utils.h"
@@ -28,22 +38,16 @@ static void mechanical_find_edge_loop_start(BMesh *bm,
 	BMIter iter;
 
 	while (current && current != first) {
-		BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
+		/* Walk the disk cycle of current vertex, no need to scan all mesh edges */
+		BM_ITER_ELEM (e, &iter, current, BM_EDGES_OF_VERT) {
 			if (BM_elem_flag_test (e, BM_ELEM_TAG)) {
 				continue;
 			}
 			if (e == e_prev || e == e_curr) {
 				continue;
 			}
-
-			if (e->v1 == current) {
-				current = e->v2;
-				break;
-			}
-			if (e->v2 == current) {
-				current = e->v1;
-				break;
-			}
+			current = BM_edge_other_vert(e, current);
+			break;
 		}
 		if (current != first) {
 			if (e && mechanical_follow_edge_loop_test_func(bm, e,*v1,*v2,current,data)) {
@@ -69,15 +73,14 @@ static void mechanical_find_edge_loop_start(BMesh *bm,
 }
 
 
-static bool mechanical_check_edge_line (BMesh *UNUSED(bm), BMEdge *e) {
+/**
+ * False when faces of \a e are coplanar or tangent, so the edge is not a visible line.
+ */
+static bool mechanical_check_edge_faces (BMEdge *e) {
 	BMIter iter;
 	BMFace *efa;
 	float *prev_fno = NULL;
 
-	if (eq_v3v3_prec(e->v1->co, e->v2->co)) {
-		return false;
-	}
-
 	BM_ITER_ELEM(efa, &iter, e, BM_FACES_OF_EDGE) {
 		if (prev_fno && parallel_v3u_v3u(efa->no,prev_fno)) {
 			break;
@@ -96,6 +99,10 @@ static bool mechanical_check_edge_line (BMesh *UNUSED(bm), BMEdge *e) {
 	return (efa == NULL);
 }
 
+static bool mechanical_check_edge_line (BMesh *UNUSED(bm), BMEdge *e) {
+	return !eq_v3v3_prec(e->v1->co, e->v2->co) && mechanical_check_edge_faces(e);
+}
+
 static bool mechanical_follow_edge_loop_test_circle(BMesh *UNUSED(bm), BMEdge *e, BMVert *v1, BMVert *v2, BMVert *current, void *data) {
 	test_circle_data *cdata = data;
 	float *center = cdata->center;
@@ -147,21 +154,14 @@ static BMVert* mechanical_follow_edge_loop(BMesh *bm, BMEdge *e1, BMEdge *e2, BM
 	BM_elem_flag_enable(e1, BM_ELEM_TAG);
 	BM_elem_flag_enable(e2, BM_ELEM_TAG);
 	while (current && current != first) {
-		BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
+		BM_ITER_ELEM (e, &iter, current, BM_EDGES_OF_VERT) {
 			if (BM_elem_flag_test (e, BM_ELEM_TAG)) {
 				continue;
 			}
-			if (e->v1 == current) {
-				BM_elem_flag_enable(e, BM_ELEM_TAG);
-				r_eoutput[(*r_ecount)] = e;
-				current = e->v2;
-				break;
-			} else if (e->v2 == current) {
-				BM_elem_flag_enable(e, BM_ELEM_TAG);
-				r_eoutput[(*r_ecount)] = e;
-				current = e->v1;
-				break;
-			}
+			BM_elem_flag_enable(e, BM_ELEM_TAG);
+			r_eoutput[(*r_ecount)] = e;
+			current = BM_edge_other_vert(e, current);
+			break;
 		}
 		if (current != first) {
 			if (e && mechanical_follow_edge_loop_test_func (bm, e, v1,v2,current,data)) {
@@ -271,105 +271,529 @@ static int mechanical_geometry_follow_data(BMesh *bm, BMEdge *e1, BMEdge *e2, BM
 	return type;
 }
 
-static void mechanical_calc_edit_mesh_geometry(BMesh *bm)
+/**
+ * Tries to start a geometry from \a e1 and any untagged edge sharing one of its vertices.
+ * Only edges after \a e1 (by index) are considered, as previous ones already had their chance.
+ *
+ * \return the geometry type found, 0 if none.
+ */
+static int mechanical_geometry_follow_edge_pair(BMesh *bm, BMEdge *e1,
+                                                BMVert* *r_voutput, int* r_vcount, BMEdge* *r_eoutput, int* r_ecount,
+                                                float r_center[])
 {
-	BMEdge *e1;
+	BMVert *v_shared = e1->v1;
 	BMEdge *e2;
-	BMIter iter1;
-	BMIter iter2;
+	BMIter iter;
+	int type = 0;
+
+	for (int i = 0; i < 2; i++, v_shared = e1->v2) {
+		BM_ITER_ELEM (e2, &iter, v_shared, BM_EDGES_OF_VERT) {
+			if (e2 == e1 || BM_elem_index_get(e2) < BM_elem_index_get(e1)) {
+				continue;
+			}
+			if (BM_elem_flag_test (e2, BM_ELEM_TAG)) {
+				continue;
+			}
+			type = mechanical_geometry_follow_data(bm, e1, e2,
+			                                       BM_edge_other_vert(e1, v_shared), v_shared,
+			                                       BM_edge_other_vert(e2, v_shared),
+			                                       r_voutput, r_vcount, r_eoutput, r_ecount, r_center);
+			if (type) {
+				return type;
+			}
+		}
+	}
+	return type;
+}
+
+/* Reverse lookup, from BMVert/BMEdge to the BMGeom using them
+ *
+ * bm->geom_map stores a LinkNode list of geometries for each element, nodes are allocated on
+ * bm->geom_map_pool. Kept in sync with geometry creation/removal and BMesh kill/split functions.
+ */
+
+static void mechanical_geometry_map_add_elem(BMesh *bm, void *ele, BMGeom *egm)
+{
+	void **val_p;
+	if (!BLI_ghash_ensure_p(bm->geom_map, ele, &val_p)) {
+		*val_p = NULL;
+	}
+	BLI_linklist_prepend_pool((LinkNode **)val_p, egm, bm->geom_map_pool);
+}
+
+static void mechanical_geometry_map_remove_elem(BMesh *bm, void *ele, BMGeom *egm)
+{
+	LinkNode **val_p = (LinkNode **)BLI_ghash_lookup_p(bm->geom_map, ele);
+	LinkNode *link;
+
+	if (val_p == NULL) {
+		BLI_assert(0);
+		return;
+	}
+
+	for (; (link = *val_p); val_p = &link->next) {
+		if (link->link == egm) {
+			*val_p = link->next;
+			BLI_mempool_free(bm->geom_map_pool, link);
+			break;
+		}
+	}
+	if (BLI_ghash_lookup(bm->geom_map, ele) == NULL) {
+		BLI_ghash_remove(bm->geom_map, ele, NULL, NULL);
+	}
+}
+
+static void mechanical_geometry_map_add(BMesh *bm, BMGeom *egm)
+{
+	bm->geom_stamp++;
+	if (bm->geom_map == NULL) {
+		bm->geom_map = BLI_ghash_ptr_new(__func__);
+		bm->geom_map_pool = BLI_mempool_create(sizeof(LinkNode), 0, 512, BLI_MEMPOOL_NOP);
+	}
+	for (int i = 0; i < egm->totverts; i++) {
+		mechanical_geometry_map_add_elem(bm, egm->v[i], egm);
+	}
+	for (int i = 0; i < egm->totedges; i++) {
+		mechanical_geometry_map_add_elem(bm, egm->e[i], egm);
+	}
+}
+
+static void mechanical_geometry_map_remove(BMesh *bm, BMGeom *egm)
+{
+	bm->geom_stamp++;
+	for (int i = 0; i < egm->totverts; i++) {
+		mechanical_geometry_map_remove_elem(bm, egm->v[i], egm);
+	}
+	for (int i = 0; i < egm->totedges; i++) {
+		mechanical_geometry_map_remove_elem(bm, egm->e[i], egm);
+	}
+}
+
+static void mechanical_geometry_map_free(BMesh *bm)
+{
+	bm->geom_stamp++;
+	if (bm->geom_map) {
+		BLI_ghash_free(bm->geom_map, NULL, NULL);
+		BLI_mempool_destroy(bm->geom_map_pool);
+		bm->geom_map = NULL;
+		bm->geom_map_pool = NULL;
+	}
+	if (bm->geom_vdirty) {
+		BLI_gset_free(bm->geom_vdirty, NULL);
+		bm->geom_vdirty = NULL;
+	}
+}
+
+/**
+ * \return the list of geometry using \a ele (a BMVert or BMEdge), NULL if none.
+ */
+LinkNode *mechanical_geometry_of_elem(BMesh *bm, const void *ele)
+{
+	return bm->geom_map ? BLI_ghash_lookup(bm->geom_map, ele) : NULL;
+}
+
+static void mechanical_remove_geometry (BMesh *bm, BMGeom *egm) {
+	mechanical_geometry_map_remove(bm, egm);
+	MEM_freeN(egm->v);
+	MEM_freeN(egm->e);
+	BLI_mempool_free(bm->gpool, egm);
+	bm->totgeom--;
+}
+
+/**
+ * Removes the geometry using \a ele (a BMVert or BMEdge), to be called before it's killed or its
+ * topology changes. Other vertices of removed geometry are detected again on next update.
+ */
+void mechanical_geometry_elem_kill(BMesh *bm, void *ele)
+{
+	LinkNode *link;
+
+	if (bm->geom_vdirty && ((BMElem *)ele)->head.htype == BM_VERT) {
+		BLI_gset_remove(bm->geom_vdirty, ele, NULL);
+	}
+
+	while ((link = mechanical_geometry_of_elem(bm, ele))) {
+		BMGeom *egm = link->link;
+		if (bm->geom_vdirty == NULL) {
+			bm->geom_vdirty = BLI_gset_ptr_new(__func__);
+		}
+		for (int i = 0; i < egm->totverts; i++) {
+			if (egm->v[i] != ele) {
+				BLI_gset_add(bm->geom_vdirty, egm->v[i]);
+			}
+		}
+		mechanical_remove_geometry(bm, egm);
+	}
+}
+
+/**
+ * Detects the geometry starting at \a e1, its vertices and edges are written on \a verts and \a edges.
+ * Only reads the mesh and writes tags of untagged edges connected to \a e1.
+ *
+ * \return the geometry type found, 0 if none.
+ */
+static int mechanical_detect_edge_geometry(BMesh *bm, BMEdge *e1, BMVert **verts, int *r_vcount,
+                                           BMEdge **edges, int *r_ecount, float r_center[3])
+{
 	int type;
 
-	// Max size is total count of verts
-	BMVert *(*verts) = MEM_callocN(sizeof(BMVert*)*bm->totvert,"mechanical_circle_output");
-	BMEdge *(*edges) = MEM_callocN(sizeof(BMEdge*)*bm->totedge,"mechanical_circle_output");
-	int vcount=0, ecount=0;
+	*r_vcount = 0;
+	*r_ecount = 0;
+
+	// Continue the edge
+	type = mechanical_geometry_follow_edge_pair(bm, e1, verts, r_vcount, edges, r_ecount, r_center);
+
+	if (type == 0) {
+		// No conection Consider line
+		// Check the face normals
+		if (mechanical_check_edge_line(bm, e1)) {
+			verts[0] = e1->v1;
+			verts[1] = e1->v2;
+			edges[0] = e1;
+
+			*r_vcount = 2;
+			*r_ecount = 1;
+			type = BM_GEOMETRY_TYPE_LINE;
+		}
+	}
+	return type;
+}
+
+/**
+ * Adds a geometry to bm->gpool, taking ownership of \a verts and \a edges arrays.
+ */
+static void mechanical_geometry_add(BMesh *bm, int type, BMVert **verts, int vcount, BMEdge **edges, int ecount,
+                                    const float center[3])
+{
+	BMGeom *egm = BLI_mempool_alloc(bm->gpool);
+	bm->totgeom++;
+
+	egm->head.htype = BM_GEOMETRY;
+	egm->head.hflag = 0;
+	egm->head.bm = bm;
+
+	egm->totverts = vcount;
+	egm->totedges = ecount;
+	egm->v = verts;
+	egm->e = edges;
+	egm->geometry_type = type;
+
+	switch (type) {
+		case BM_GEOMETRY_TYPE_CIRCLE:
+		{
+			copy_v3_v3(egm->center,center);
+			normal_tri_v3(egm->axis, egm->v[0]->co, egm->v[1]->co, egm->v[2]->co);
+			break;
+		}
+		case BM_GEOMETRY_TYPE_ARC:
+		{
+			copy_v3_v3(egm->center,center);
+			normal_tri_v3(egm->axis, egm->v[0]->co, egm->v[1]->co, egm->v[2]->co);
+			copy_v3_v3(egm->start, egm->v[0]->co);
+			copy_v3_v3(egm->end, egm->v[egm->totverts-1]->co);
+			arc_mid_point(egm);
+
+			break;
+		}
+		case BM_GEOMETRY_TYPE_LINE:
+		{
+			sub_v3_v3v3(egm->axis,egm->v[0]->co,egm->v[1]->co);
+			normalize_v3(egm->axis);
+			copy_v3_v3(egm->start, egm->v[0]->co);
+			copy_v3_v3(egm->end, egm->v[(egm->totverts)-1]->co);
+			mid_of_2_points(egm->mid, egm->start, egm->end);
+			break;
+		}
+		default:
+			// Not valid
+			break;
+	}
+
+	mechanical_geometry_map_add(bm, egm);
+}
+
+/**
+ * Detects the geometry starting at \a e1 and adds it to bm->gpool.
+ * \a verts and \a edges are working buffers, sized to total verts and edges.
+ */
+static void mechanical_calc_edge_geometry(BMesh *bm, BMEdge *e1, BMVert **verts, BMEdge **edges)
+{
+	int vcount, ecount;
 	float center[3];
+	int type;
 
-	BM_ITER_MESH (e1, &iter1, bm, BM_EDGES_OF_MESH) {
-		if (!BM_elem_flag_test (e1, BM_ELEM_TAG)) {
-			memcpy(&iter2,&iter1, sizeof (BMIter));
-			type = 0;
-			// Continue the edge
-			while (!type && (e2 = BM_iter_step(&iter2))) {
-				if (!BM_elem_flag_test (e2, BM_ELEM_TAG)) {
-					if (e2->v1 == e1->v1) {
-						type = mechanical_geometry_follow_data(bm,e1, e2, e1->v2, e1->v1, e2->v2,
-														&(*verts), &vcount, &(*edges), &ecount, center);
-					}else if (e2->v1 == e1->v2) {
-						type = mechanical_geometry_follow_data(bm,e1, e2, e1->v1, e1->v2, e2->v2,
-						                                &(*verts), &vcount, &(*edges), &ecount, center);
-					}else if (e2->v2 == e1->v1) {
-						type = mechanical_geometry_follow_data(bm,e1, e2, e1->v2, e1->v1, e2->v1,
-						                                &(*verts), &vcount, &(*edges), &ecount, center);
-					}else if (e2->v2 == e1->v2) {
-						type = mechanical_geometry_follow_data(bm,e1, e2, e1->v1, e1->v2, e2->v1,
-						                                &(*verts), &vcount, &(*edges), &ecount, center);
-					}
-				}
-			}
+	type = mechanical_detect_edge_geometry(bm, e1, verts, &vcount, edges, &ecount, center);
 
-			if (e2 == NULL) {
-				// No conection Consider line
-				// Check the face normals
-				if (mechanical_check_edge_line(bm, e1)) {
-					verts[0] = e1->v1;
-					verts[1] = e1->v2;
-					edges[0] = e1;
-
-					vcount = 2;
-					ecount = 1;
-					type = BM_GEOMETRY_TYPE_LINE;
-				}
-			}
+	if (type) {
+		BMVert **v = MEM_mallocN(sizeof(BMVert*)*vcount,"geometry vertex pointer array");
+		BMEdge **e = MEM_mallocN(sizeof(BMEdge*)*ecount,"geometry edge pointer array");
+		memcpy(v, verts, vcount*sizeof(BMVert*));
+		memcpy(e, edges, ecount*sizeof(BMEdge*));
+		mechanical_geometry_add(bm, type, v, vcount, e, ecount, center);
+	}
+}
 
-			if (type) {
+/* Parallel detection
+ *
+ * Detection only walks untagged edges sharing a vertex, so untagged edges are split in connected
+ * groups detected on threads, each one in edge index order. Geometry found is added in a final
+ * serial step sorted by its starting edge, same result than the serial detection.
+ */
 
-				BMGeom *egm = BLI_mempool_alloc(bm->gpool);
-				bm->totgeom++;
-
-				egm->head.htype = BM_GEOMETRY;
-				egm->head.hflag = 0;
-				egm->head.bm = bm;
-
-				egm->totverts = vcount;
-				egm->totedges = ecount;
-				egm->v = MEM_callocN(sizeof(BMVert*)*egm->totverts,"geometry vertex pointer array");
-				egm->e = MEM_callocN(sizeof(BMEdge*)*egm->totedges,"geometry edge pointer array");
-				egm->geometry_type = type;
-				memcpy(egm->v,verts,egm->totverts*sizeof(BMVert*));
-				memcpy(egm->e,edges,egm->totedges*sizeof(BMEdge*));
-
-				switch (type) {
-					case BM_GEOMETRY_TYPE_CIRCLE:
-					{
-						copy_v3_v3(egm->center,center);
-						normal_tri_v3(egm->axis, egm->v[0]->co, egm->v[1]->co, egm->v[2]->co);
-						break;
-					}
-					case BM_GEOMETRY_TYPE_ARC:
-					{
-						copy_v3_v3(egm->center,center);
-						normal_tri_v3(egm->axis, egm->v[0]->co, egm->v[1]->co, egm->v[2]->co);
-						copy_v3_v3(egm->start, egm->v[0]->co);
-						copy_v3_v3(egm->end, egm->v[egm->totverts-1]->co);
-						arc_mid_point(egm);
+/* Candidate edges to detect on threads */
+#define GEOMETRY_DETECT_THREAD_MIN 10000
 
-						break;
-					}
-					case BM_GEOMETRY_TYPE_LINE:
-					{
-						sub_v3_v3v3(egm->axis,egm->v[0]->co,egm->v[1]->co);
-						normalize_v3(egm->axis);
-						copy_v3_v3(egm->start, egm->v[0]->co);
-						copy_v3_v3(egm->end, egm->v[(egm->totverts)-1]->co);
-						mid_of_2_points(egm->mid, egm->start, egm->end);
-						break;
-					}
-					default:
-						// Not valid
-						break;
+typedef struct GeometryFound {
+	int seed;	/* index of the starting edge, sort key */
+	int type;
+	BMVert **v;
+	BMEdge **e;
+	int totverts, totedges;
+	float center[3];
+} GeometryFound;
+
+typedef struct GeometryDetectData {
+	BMesh *bm;
+	/* seeds grouped by connected group, each group in index order */
+	BMEdge **seeds;
+	int *group_start;	/* group i seeds are from group_start[i] to group_start[i + 1] */
+
+	GeometryFound *found;
+	int found_tot;
+} GeometryDetectData;
+
+/* Per thread */
+typedef struct GeometryDetectChunk {
+	BMVert **verts;
+	BMEdge **edges;
+	int buf_len;
+
+	GeometryFound *found;
+	int found_tot, found_len;
+} GeometryDetectChunk;
+
+static int mechanical_geometry_group_find(int *parent, int i)
+{
+	int root = i;
+	while (parent[root] != root) {
+		root = parent[root];
+	}
+	// Path compression
+	while (parent[i] != root) {
+		const int next = parent[i];
+		parent[i] = root;
+		i = next;
+	}
+	return root;
+}
+
+/**
+ * Sorts \a seeds (in index order) by group of connected seeds, keeping index order on each group.
+ * \return the groups, with the start of each one plus one past the end.
+ */
+static int *mechanical_geometry_seed_groups(BMesh *bm, BMEdge **seeds, const int seeds_tot, int *r_groups_tot)
+{
+	int *parent = MEM_mallocN(sizeof(*parent) * bm->totvert, __func__);
+	int *group_of_root = MEM_mallocN(sizeof(*group_of_root) * bm->totvert, __func__);
+	int *seed_group = MEM_mallocN(sizeof(*seed_group) * seeds_tot, __func__);
+	BMEdge **seeds_sorted;
+	int *group_start;
+	int groups_tot = 0;
+	int i;
+
+	for (i = 0; i < bm->totvert; i++) {
+		parent[i] = i;
+		group_of_root[i] = -1;
+	}
+	for (i = 0; i < seeds_tot; i++) {
+		const int r1 = mechanical_geometry_group_find(parent, BM_elem_index_get(seeds[i]->v1));
+		const int r2 = mechanical_geometry_group_find(parent, BM_elem_index_get(seeds[i]->v2));
+		if (r1 != r2) {
+			parent[r2] = r1;
+		}
+	}
+	for (i = 0; i < seeds_tot; i++) {
+		const int root = mechanical_geometry_group_find(parent, BM_elem_index_get(seeds[i]->v1));
+		if (group_of_root[root] == -1) {
+			group_of_root[root] = groups_tot++;
+		}
+		seed_group[i] = group_of_root[root];
+	}
+
+	// Counting sort, stable so each group keeps index order
+	group_start = MEM_callocN(sizeof(*group_start) * (groups_tot + 1), __func__);
+	for (i = 0; i < seeds_tot; i++) {
+		group_start[seed_group[i] + 1]++;
+	}
+	for (i = 0; i < groups_tot; i++) {
+		group_start[i + 1] += group_start[i];
+	}
+	seeds_sorted = MEM_mallocN(sizeof(*seeds_sorted) * seeds_tot, __func__);
+	for (i = 0; i < seeds_tot; i++) {
+		seeds_sorted[group_start[seed_group[i]]++] = seeds[i];
+	}
+	// Restore starts, moved to next group start by the sort
+	for (i = groups_tot; i > 0; i--) {
+		group_start[i] = group_start[i - 1];
+	}
+	group_start[0] = 0;
+	memcpy(seeds, seeds_sorted, sizeof(*seeds) * seeds_tot);
+
+	MEM_freeN(seeds_sorted);
+	MEM_freeN(seed_group);
+	MEM_freeN(group_of_root);
+	MEM_freeN(parent);
+
+	*r_groups_tot = groups_tot;
+	return group_start;
+}
+
+static void mechanical_geometry_detect_task_cb(void *userdata, void *userdata_chunk, const int group,
+                                               const int UNUSED(thread_id))
+{
+	GeometryDetectData *data = userdata;
+	GeometryDetectChunk *chunk = userdata_chunk;
+	const int start = data->group_start[group];
+	const int end = data->group_start[group + 1];
+	int vcount, ecount;
+	float center[3];
+	int type;
+
+	// A walk uses each edge of the group once, plus one closing vertex
+	if (chunk->buf_len < end - start + 1) {
+		chunk->buf_len = end - start + 1;
+		MEM_SAFE_FREE(chunk->verts);
+		MEM_SAFE_FREE(chunk->edges);
+		chunk->verts = MEM_mallocN(sizeof(*chunk->verts) * chunk->buf_len, __func__);
+		chunk->edges = MEM_mallocN(sizeof(*chunk->edges) * chunk->buf_len, __func__);
+	}
+
+	for (int i = start; i < end; i++) {
+		BMEdge *e1 = data->seeds[i];
+		GeometryFound *found;
+
+		if (BM_elem_flag_test(e1, BM_ELEM_TAG)) {
+			continue;
+		}
+		type = mechanical_detect_edge_geometry(data->bm, e1, chunk->verts, &vcount, chunk->edges, &ecount, center);
+		if (type == 0) {
+			continue;
+		}
+
+		if (chunk->found_tot == chunk->found_len) {
+			chunk->found_len = max_ii(chunk->found_len * 2, 64);
+			chunk->found = MEM_reallocN(chunk->found, sizeof(*chunk->found) * chunk->found_len);
+		}
+		found = &chunk->found[chunk->found_tot++];
+		found->seed = BM_elem_index_get(e1);
+		found->type = type;
+		found->totverts = vcount;
+		found->totedges = ecount;
+		found->v = MEM_mallocN(sizeof(BMVert*)*vcount,"geometry vertex pointer array");
+		found->e = MEM_mallocN(sizeof(BMEdge*)*ecount,"geometry edge pointer array");
+		memcpy(found->v, chunk->verts, vcount*sizeof(BMVert*));
+		memcpy(found->e, chunk->edges, ecount*sizeof(BMEdge*));
+		copy_v3_v3(found->center, center);
+	}
+}
+
+static void mechanical_geometry_detect_finalize(void *userdata, void *userdata_chunk)
+{
+	GeometryDetectData *data = userdata;
+	GeometryDetectChunk *chunk = userdata_chunk;
+
+	if (chunk->found_tot) {
+		memcpy(&data->found[data->found_tot], chunk->found, sizeof(*chunk->found) * chunk->found_tot);
+		data->found_tot += chunk->found_tot;
+	}
+	MEM_SAFE_FREE(chunk->found);
+	MEM_SAFE_FREE(chunk->verts);
+	MEM_SAFE_FREE(chunk->edges);
+}
+
+static int mechanical_geometry_found_cmp(const void *a, const void *b)
+{
+	const int s_a = ((const GeometryFound *)a)->seed;
+	const int s_b = ((const GeometryFound *)b)->seed;
+	return (s_a > s_b) - (s_a < s_b);
+}
+
+/**
+ * Detects geometry starting from \a seeds (untagged edges in index order) on threads.
+ * Reorders \a seeds.
+ */
+static void mechanical_calc_edit_mesh_geometry_threaded(BMesh *bm, BMEdge **seeds, int seeds_tot)
+{
+	GeometryDetectData data = {NULL};
+	GeometryDetectChunk chunk = {NULL};
+	int groups_tot;
+
+	data.bm = bm;
+	data.seeds = seeds;
+	data.group_start = mechanical_geometry_seed_groups(bm, seeds, seeds_tot, &groups_tot);
+	// Each geometry starts on a different seed
+	data.found = MEM_mallocN(sizeof(*data.found) * max_ii(seeds_tot, 1), __func__);
+
+	BLI_task_parallel_range_finalize(0, groups_tot, &data, &chunk, sizeof(chunk),
+	                                 mechanical_geometry_detect_task_cb, mechanical_geometry_detect_finalize,
+	                                 true, false);
+
+	// Same order than serial detection, whatever the threads used
+	qsort(data.found, data.found_tot, sizeof(*data.found), mechanical_geometry_found_cmp);
+	for (int i = 0; i < data.found_tot; i++) {
+		GeometryFound *found = &data.found[i];
+		mechanical_geometry_add(bm, found->type, found->v, found->totverts, found->e, found->totedges, found->center);
+	}
+
+	MEM_freeN(data.found);
+	MEM_freeN(data.group_start);
+}
+
+/**
+ * Detects new geometry on all untagged edges, or only starting from \a seeds if given.
+ * With \a use_threading, many candidates are detected on threads.
+ */
+static void mechanical_calc_edit_mesh_geometry(BMesh *bm, BMEdge **seeds, int seeds_tot, const bool use_threading)
+{
+	BMEdge *e1;
+	BMIter iter1;
+	BMVert *(*verts);
+	BMEdge *(*edges);
+
+	BM_mesh_elem_index_ensure(bm, BM_VERT | BM_EDGE);
+
+	if (use_threading) {
+		if (seeds) {
+			mechanical_calc_edit_mesh_geometry_threaded(bm, seeds, seeds_tot);
+		}
+		else {
+			seeds = MEM_mallocN(sizeof(*seeds) * bm->totedge, __func__);
+			BM_ITER_MESH (e1, &iter1, bm, BM_EDGES_OF_MESH) {
+				if (!BM_elem_flag_test (e1, BM_ELEM_TAG)) {
+					seeds[seeds_tot++] = e1;
 				}
 			}
+			mechanical_calc_edit_mesh_geometry_threaded(bm, seeds, seeds_tot);
+			MEM_freeN(seeds);
+		}
+		return;
+	}
+
+	// Max size is total count of verts
+	verts = MEM_callocN(sizeof(BMVert*)*bm->totvert,"mechanical_circle_output");
+	edges = MEM_callocN(sizeof(BMEdge*)*bm->totedge,"mechanical_circle_output");
+
+	if (seeds) {
+		for (int i = 0; i < seeds_tot; i++) {
+			if (!BM_elem_flag_test (seeds[i], BM_ELEM_TAG)) {
+				mechanical_calc_edge_geometry(bm, seeds[i], verts, edges);
+			}
+		}
+	} else {
+		BM_ITER_MESH (e1, &iter1, bm, BM_EDGES_OF_MESH) {
+			if (!BM_elem_flag_test (e1, BM_ELEM_TAG)) {
+				mechanical_calc_edge_geometry(bm, e1, verts, edges);
+			}
 		}
 	}
 	MEM_freeN(&(*verts));
@@ -404,29 +828,30 @@ static bool mechanical_check_geometry(BMesh *bm, BMGeom *egm, bool (*mechanical_
 		BM_elem_flag_enable(v2, BM_ELEM_TAG);
 
 		for (i=2;current && i<egm->totverts;i++) {
+			current = egm->v[i];
 			if (mechanical_geometry_func(v1, v2, current, data))
 			{
 				BM_elem_flag_enable(current, BM_ELEM_TAG);
-				current++;
 			} else {
 				current = NULL;
 			}
 		}
-		if (current) {
-			// check for edge expanding the new geometry
+		if (current && egm->geometry_type != BM_GEOMETRY_TYPE_CIRCLE) {
+			// check for edge expanding the new geometry, only edges on its end points may do it
+			BMVert *v_end[2] = {egm->v[0], egm->v[egm->totverts-1]};
+			BMVert *v_other;
 			BMEdge *e;
 			BMIter iter;
-			BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
-				if (BM_elem_flag_test (e, BM_ELEM_TAG)) {
-					continue;
-				}
-				if (e->v1 == egm->v[0] || e->v1 == egm->v[egm->totverts-1]) {
-					if (mechanical_geometry_func(v1, v2, e->v1, data)) {
-						current =NULL;
+			for (int j = 0; current && j < 2; j++) {
+				BM_ITER_ELEM (e, &iter, v_end[j], BM_EDGES_OF_VERT) {
+					v_other = BM_edge_other_vert(e, v_end[j]);
+					if (BM_elem_flag_test (v_other, BM_ELEM_TAG)) {
+						// Vertex on this geometry or other valid one
+						continue;
 					}
-				} else if (e->v2 == egm->v[0] || e->v2 == egm->v[egm->totverts-1]) {
-					if (mechanical_geometry_func(v1, v2, e->v2, data)) {
-						current =NULL;
+					if (mechanical_check_edge_line(bm, e) && mechanical_geometry_func(v1, v2, v_other, data)) {
+						current = NULL;
+						break;
 					}
 				}
 			}
@@ -445,11 +870,47 @@ static bool mechanical_check_geometry(BMesh *bm, BMGeom *egm, bool (*mechanical_
 	}
 }
 
-static void mechanical_remove_geometry (BMesh *bm, BMGeom *egm) {
-	MEM_freeN(egm->v);
-	MEM_freeN(egm->e);
-	BLI_mempool_free(bm->gpool, egm);
-	bm->totgeom--;
+/**
+ * Lines and arcs remain valid when moved along its axis or rotated around its center,
+ * keep its end points updated.
+ */
+static void mechanical_geometry_points_update(BMesh *bm, BMGeom *egm)
+{
+	const float *start = egm->v[0]->co;
+	const float *end = egm->v[egm->totverts-1]->co;
+
+	if (equals_v3v3(egm->start, start) && equals_v3v3(egm->end, end)) {
+		return;
+	}
+
+	copy_v3_v3(egm->start, start);
+	copy_v3_v3(egm->end, end);
+	if (egm->geometry_type == BM_GEOMETRY_TYPE_ARC) {
+		arc_mid_point(egm);
+	}
+	else {
+		mid_of_2_points(egm->mid, egm->start, egm->end);
+	}
+	bm->geom_stamp++;
+}
+
+static bool mechanical_check_geometry_type(BMesh *bm, BMGeom *egm)
+{
+	bool valid = false;
+	switch (egm->geometry_type) {
+		case BM_GEOMETRY_TYPE_CIRCLE:
+			return mechanical_check_geometry(bm, egm, mechanical_test_circle, egm->center);
+		case BM_GEOMETRY_TYPE_ARC:
+			valid = mechanical_check_geometry(bm, egm, mechanical_test_circle, egm->center);
+			break;
+		case BM_GEOMETRY_TYPE_LINE:
+			valid = mechanical_check_geometry(bm, egm, mechanical_test_line, egm->axis);
+			break;
+	}
+	if (valid) {
+		mechanical_geometry_points_update(bm, egm);
+	}
+	return valid;
 }
 
 /*
@@ -460,13 +921,24 @@ void mechanical_clean_geometry (BMesh *bm) {
 	BMGeom *egm;
 	BMIter iter;
 
+	// Next update has to be a full one
+	mechanical_geometry_snapshot_free(bm);
+
 	if (bm->totgeom > 0) {
 		BM_ITER_MESH (egm, &iter, bm, BM_GEOMETRY_OF_MESH) {
-			mechanical_remove_geometry(bm,egm);
+			MEM_freeN(egm->v);
+			MEM_freeN(egm->e);
 		}
+		// Freeing the last element frees pool chunks, not possible while iterating
+		BLI_mempool_clear(bm->gpool);
+		bm->totgeom = 0;
 	}
+	mechanical_geometry_map_free(bm);
 }
 
+/**
+ * Removes geometry no longer valid, vertices of valid geometry are tagged.
+ */
 static void mechanical_check_mesh_geometry(BMesh *bm)
 {
 	BMGeom *egm;
@@ -474,22 +946,11 @@ static void mechanical_check_mesh_geometry(BMesh *bm)
 	BMGeom *(*rem_egm);
 	int rem_egm_count =0;
 	BMIter iter;
-	bool valid;
 
 	rem_egm = MEM_callocN(sizeof (BMGeom*)*BLI_mempool_count(bm->gpool), "geometry to be removed");
 
 	BM_ITER_MESH (egm, &iter, bm, BM_GEOMETRY_OF_MESH) {
-		valid = false;
-		switch (egm->geometry_type) {
-			case BM_GEOMETRY_TYPE_CIRCLE:
-			case BM_GEOMETRY_TYPE_ARC:
-				valid = mechanical_check_geometry(bm, egm, mechanical_test_circle, egm->center);
-				break;
-			case BM_GEOMETRY_TYPE_LINE:
-				valid = mechanical_check_geometry(bm, egm, mechanical_test_line, egm->axis);
-				break;
-		}
-		if (valid) {
+		if (mechanical_check_geometry_type(bm, egm)) {
 			// Edges will be tagged according to vertex
 		} else {
 			// Remove!
@@ -510,46 +971,577 @@ static void mechanical_check_mesh_geometry(BMesh *bm)
 	MEM_freeN(rem_egm);
 }
 
+/**
+ * Tags vertices connected to the end points of \a egm which are used by geometry not being checked,
+ * so as in a full pass they are known to be on other valid geometry and don't expand \a egm.
+ */
+static void mechanical_geometry_tag_valid_neighbors(BMesh *bm, BMGeom *egm)
+{
+	BMVert *v_end[2] = {egm->v[0], egm->v[egm->totverts - 1]};
+	BMVert *v_other;
+	BMEdge *e;
+	BMIter iter;
+	LinkNode *link;
+
+	for (int j = 0; j < 2; j++) {
+		BM_ITER_ELEM (e, &iter, v_end[j], BM_EDGES_OF_VERT) {
+			v_other = BM_edge_other_vert(e, v_end[j]);
+			for (link = mechanical_geometry_of_elem(bm, v_other); link; link = link->next) {
+				if (!BM_elem_flag_test((BMGeom *)link->link, BM_ELEM_TAG)) {
+					BM_elem_flag_enable(v_other, BM_ELEM_TAG);
+					break;
+				}
+			}
+		}
+	}
+}
 
-void mechanical_update_mesh_geometry(BMesh *bm)
+/**
+ * Only checks geometry using a vertex on \a dirty_verts, found with the reverse lookup,
+ * other geometry is considered valid. Vertices of removed geometry are added to \a dirty_verts.
+ */
+static void mechanical_check_mesh_geometry_dirty(BMesh *bm, BLI_bitmap *dirty_verts)
+{
+	BMGeom *egm;
+	BMGeom *(*check_egm) = NULL;
+	BLI_array_declare(check_egm);
+	BMVert *v;
+	BMIter iter;
+	LinkNode *link;
+	int i;
+
+	BM_ITER_MESH_INDEX (v, &iter, bm, BM_VERTS_OF_MESH, i) {
+		if (!BLI_BITMAP_TEST(dirty_verts, i)) {
+			continue;
+		}
+		for (link = mechanical_geometry_of_elem(bm, v); link; link = link->next) {
+			egm = link->link;
+			if (!BM_elem_flag_test(egm, BM_ELEM_TAG)) {
+				BM_elem_flag_enable(egm, BM_ELEM_TAG);
+				BLI_array_append(check_egm, egm);
+			}
+		}
+	}
+
+	// Geometry being checked is still tagged
+	for (i = 0; i < BLI_array_count(check_egm); i++) {
+		mechanical_geometry_tag_valid_neighbors(bm, check_egm[i]);
+	}
+
+	for (i = 0; i < BLI_array_count(check_egm); i++) {
+		egm = check_egm[i];
+		BM_elem_flag_disable(egm, BM_ELEM_TAG);
+		if (!mechanical_check_geometry_type(bm, egm)) {
+			// Freed vertices have to be detected again
+			for (int j = 0; j < egm->totverts; j++) {
+				BLI_BITMAP_ENABLE(dirty_verts, BM_elem_index_get(egm->v[j]));
+			}
+			mechanical_remove_geometry(bm, egm);
+		}
+	}
+
+	BLI_array_free(check_egm);
+}
+
+/* Dirty region tracking
+ *
+ * The state of vertices and edges at the end of a detection pass is stored on the BMesh, so next
+ * pass is able to find the vertices moved or created since then and only work around them.
+ */
+
+void mechanical_geometry_snapshot_free(BMesh *bm)
+{
+	MEM_SAFE_FREE(bm->geom_vtable);
+	MEM_SAFE_FREE(bm->geom_vco);
+	MEM_SAFE_FREE(bm->geom_etable);
+	bm->geom_vtable_tot = 0;
+	bm->geom_etable_tot = 0;
+}
+
+static void mechanical_geometry_snapshot_store(BMesh *bm)
+{
+	BMVert *v;
+	BMEdge *e;
+	BMIter iter;
+	int i;
+
+	if (bm->geom_vtable_tot != bm->totvert || bm->geom_etable_tot != bm->totedge) {
+		mechanical_geometry_snapshot_free(bm);
+		bm->geom_vtable = MEM_mallocN(sizeof(*bm->geom_vtable) * bm->totvert, __func__);
+		bm->geom_vco = MEM_mallocN(sizeof(*bm->geom_vco) * bm->totvert, __func__);
+		bm->geom_etable = MEM_mallocN(sizeof(*bm->geom_etable) * bm->totedge, __func__);
+		bm->geom_vtable_tot = bm->totvert;
+		bm->geom_etable_tot = bm->totedge;
+	}
+
+	BM_ITER_MESH_INDEX (v, &iter, bm, BM_VERTS_OF_MESH, i) {
+		bm->geom_vtable[i] = v;
+		copy_v3_v3(bm->geom_vco[i], v->co);
+	}
+	BM_ITER_MESH_INDEX (e, &iter, bm, BM_EDGES_OF_MESH, i) {
+		bm->geom_etable[i] = e;
+	}
+
+	if (bm->geom_vdirty) {
+		BLI_gset_clear(bm->geom_vdirty, NULL);
+	}
+}
+
+static int mechanical_geometry_dirty_vert_enable(BLI_bitmap *dirty_verts, BMVert *v)
 {
+	const int index = BM_elem_index_get(v);
+	if (!BLI_BITMAP_TEST(dirty_verts, index)) {
+		BLI_BITMAP_ENABLE(dirty_verts, index);
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * Enables \a dirty_verts for vertices moved or created since last snapshot, vertices of created
+ * edges and vertices of geometry removed by topology changes.
+ *
+ * \return number of dirty vertices.
+ */
+static int mechanical_geometry_dirty_verts(BMesh *bm, BLI_bitmap *dirty_verts)
+{
+	BMVert *v;
+	BMEdge *e;
+	BMIter iter;
+	int i, tot = 0;
 
+	BM_ITER_MESH_INDEX (v, &iter, bm, BM_VERTS_OF_MESH, i) {
+		if (i >= bm->geom_vtable_tot || bm->geom_vtable[i] != v || !equals_v3v3(bm->geom_vco[i], v->co)) {
+			BLI_BITMAP_ENABLE(dirty_verts, i);
+			tot++;
+		}
+	}
+	BM_ITER_MESH_INDEX (e, &iter, bm, BM_EDGES_OF_MESH, i) {
+		if (i >= bm->geom_etable_tot || bm->geom_etable[i] != e) {
+			tot += mechanical_geometry_dirty_vert_enable(dirty_verts, e->v1);
+			tot += mechanical_geometry_dirty_vert_enable(dirty_verts, e->v2);
+		}
+	}
+	if (bm->geom_vdirty) {
+		GSetIterator gs_iter;
+		GSET_ITER (gs_iter, bm->geom_vdirty) {
+			tot += mechanical_geometry_dirty_vert_enable(dirty_verts, BLI_gsetIterator_getKey(&gs_iter));
+		}
+	}
+	return tot;
+}
+
+/**
+ * Adds to \a dirty_verts the vertices sharing an edge or a face with a dirty one. Moving a vertex
+ * changes the normals of its faces, and may let geometry ending next to it grow, so geometry on
+ * them has to be checked again.
+ */
+static void mechanical_geometry_dirty_verts_expand(BMesh *bm, BLI_bitmap *dirty_verts)
+{
+	BLI_bitmap *dirty_verts_orig = MEM_dupallocN(dirty_verts);
+	BMVert *v;
 	BMEdge *e;
+	BMFace *f;
+	BMLoop *l_iter, *l_first;
+	BMIter iter, eiter;
+	int i;
+
+	BM_ITER_MESH_INDEX (v, &iter, bm, BM_VERTS_OF_MESH, i) {
+		if (!BLI_BITMAP_TEST(dirty_verts_orig, i)) {
+			continue;
+		}
+		BM_ITER_ELEM (e, &eiter, v, BM_EDGES_OF_VERT) {
+			BLI_BITMAP_ENABLE(dirty_verts, BM_elem_index_get(BM_edge_other_vert(e, v)));
+		}
+		BM_ITER_ELEM (f, &eiter, v, BM_FACES_OF_VERT) {
+			l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+			do {
+				BLI_BITMAP_ENABLE(dirty_verts, BM_elem_index_get(l_iter->v));
+			} while ((l_iter = l_iter->next) != l_first);
+		}
+	}
+
+	MEM_freeN(dirty_verts_orig);
+}
+
+static int mechanical_edge_index_cmp(const void *a, const void *b)
+{
+	const int i_a = BM_elem_index_get(*(BMEdge **)a);
+	const int i_b = BM_elem_index_get(*(BMEdge **)b);
+	return (i_a > i_b) - (i_a < i_b);
+}
+
+static void mechanical_geometry_tags_clear(BMesh *bm)
+{
 	BMVert *v;
+	BMEdge *e;
 	BMIter iter;
 
-	BM_ITER_MESH (v, &iter, bm, BM_EDGES_OF_MESH) {
+	BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
+		BM_elem_flag_disable(e, BM_ELEM_TAG);
+	}
+	BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
 		BM_elem_flag_disable(v, BM_ELEM_TAG);
 	}
+}
+
+/**
+ * Quantised coordinates of all vertices, by index. Used to discard zero length edges
+ * without quantising each vertex once per edge.
+ */
+static int (*mechanical_vert_prec_keys(BMesh *bm))[4]
+{
+	float (*co)[3] = MEM_mallocN(sizeof(*co) * bm->totvert, __func__);
+	int (*keys)[4] = MEM_mallocN(sizeof(*keys) * bm->totvert, __func__);
+	BMVert *v;
+	BMIter iter;
+	int i;
+
+	BM_ITER_MESH_INDEX (v, &iter, bm, BM_VERTS_OF_MESH, i) {
+		copy_v3_v3(co[i], v->co);
+	}
+	quantize_v3_prec_array(keys, (const float (*)[3])co, bm->totvert);
+	MEM_freeN(co);
+
+	return keys;
+}
+
+/**
+ * Edges failing #mechanical_check_edge_line or starting on existing geometry are not candidates
+ * for new geometry.
+ */
+static bool mechanical_edge_is_candidate(BMesh *bm, BMEdge *e, int (*vkeys)[4])
+{
+	const int *k1 = vkeys[BM_elem_index_get(e->v1)];
+	const int *k2 = vkeys[BM_elem_index_get(e->v2)];
+
+	return (mechanical_geometry_of_elem(bm, e->v1) == NULL) &&
+	       !((k1[0] == k2[0]) && (k1[1] == k2[1]) && (k1[2] == k2[2])) &&
+	       mechanical_check_edge_faces(e);
+}
+
+/**
+ * Checks existing geometry and detects new one on the whole mesh.
+ * With \a use_threading detection runs on threads, with the same result.
+ */
+void mechanical_update_mesh_geometry_ex(BMesh *bm, const bool use_threading)
+{
+
+	BMEdge *e;
+	BMIter iter;
+	int (*vkeys)[4];
+
+	mechanical_geometry_tags_clear(bm);
 
 	mechanical_check_mesh_geometry(bm);
 
+	BM_mesh_elem_index_ensure(bm, BM_VERT);
+	vkeys = mechanical_vert_prec_keys(bm);
 	BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
+		BM_elem_flag_set(e, BM_ELEM_TAG, !mechanical_edge_is_candidate(bm, e, vkeys));
+	}
+	MEM_freeN(vkeys);
 
-		if (!mechanical_check_edge_line(bm,e)) {
-			// Ignore not valid edges
-			BM_elem_flag_enable(e, BM_ELEM_TAG);
-			continue;
+	mechanical_calc_edit_mesh_geometry(bm, NULL, 0, use_threading);
+
+	mechanical_geometry_tags_clear(bm);
+
+	mechanical_geometry_snapshot_store(bm);
+}
+
+void mechanical_update_mesh_geometry(BMesh *bm)
+{
+	mechanical_update_mesh_geometry_ex(bm, bm->totedge >= GEOMETRY_DETECT_THREAD_MIN);
+}
+
+/**
+ * Same as #mechanical_update_mesh_geometry, but only geometry around vertices moved or created since
+ * last pass is checked, and new geometry is only detected among candidate edges connected to them.
+ * Falls back to a full update when there is no previous pass to compare with.
+ */
+void mechanical_update_mesh_geometry_dirty(BMesh *bm)
+{
+	BLI_bitmap *dirty_verts;
+	BMEdge *(*seeds);
+	int seeds_tot = 0;
+	BMVert *v, **vtable, **stack;
+	int stack_tot = 0;
+	BMEdge *e;
+	BMIter iter, eiter;
+	int (*vkeys)[4];
+	int i;
+
+	if (bm->geom_vtable == NULL) {
+		mechanical_update_mesh_geometry(bm);
+		return;
+	}
+
+	BM_mesh_elem_index_ensure(bm, BM_VERT | BM_EDGE);
+
+	dirty_verts = BLI_BITMAP_NEW(bm->totvert, __func__);
+	if (mechanical_geometry_dirty_verts(bm, dirty_verts) == 0) {
+		MEM_freeN(dirty_verts);
+		return;
+	}
+
+	mechanical_geometry_tags_clear(bm);
+
+	mechanical_geometry_dirty_verts_expand(bm, dirty_verts);
+
+	mechanical_check_mesh_geometry_dirty(bm, dirty_verts);
+
+	// Only candidates connected to the dirty region are untagged, others are left tagged
+	BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
+		BM_elem_flag_enable(e, BM_ELEM_TAG);
+	}
+
+	BM_mesh_elem_table_ensure(bm, BM_VERT);
+	vtable = bm->vtable;
+	vkeys = mechanical_vert_prec_keys(bm);
+	seeds = MEM_mallocN(sizeof(BMEdge*)*bm->totedge, __func__);
+	stack = MEM_mallocN(sizeof(*stack) * bm->totvert, __func__);
+	for (i = 0; i < bm->totvert; i++) {
+		if (BLI_BITMAP_TEST(dirty_verts, i)) {
+			stack[stack_tot++] = vtable[i];
 		}
+	}
 
-		// edges verts are set as OK if checked
-		if (BM_elem_flag_test (e->v1, BM_ELEM_TAG)) {
-			BM_elem_flag_enable(e, BM_ELEM_TAG);
-		} else {
+	/* A full pass walks chains of candidate edges, which may go out of the dirty region,
+	 * so candidates are flooded from it (vertices reached are enabled on dirty_verts). */
+	while (stack_tot) {
+		v = stack[--stack_tot];
+		BM_ITER_ELEM (e, &eiter, v, BM_EDGES_OF_VERT) {
+			BMVert *v_other;
+			if (!BM_elem_flag_test(e, BM_ELEM_TAG)) {
+				// Already a candidate
+				continue;
+			}
+			if (!mechanical_edge_is_candidate(bm, e, vkeys)) {
+				continue;
+			}
 			BM_elem_flag_disable(e, BM_ELEM_TAG);
+			seeds[seeds_tot++] = e;
+
+			v_other = BM_edge_other_vert(e, v);
+			i = BM_elem_index_get(v_other);
+			if (!BLI_BITMAP_TEST(dirty_verts, i)) {
+				BLI_BITMAP_ENABLE(dirty_verts, i);
+				stack[stack_tot++] = v_other;
+			}
 		}
 	}
+	MEM_freeN(stack);
 
-	mechanical_calc_edit_mesh_geometry(bm);
+	// Keep same detection order than a full update
+	qsort(seeds, seeds_tot, sizeof(*seeds), mechanical_edge_index_cmp);
 
-	BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
-		BM_elem_flag_disable(e, BM_ELEM_TAG);
+	mechanical_calc_edit_mesh_geometry(bm, seeds, seeds_tot, seeds_tot >= GEOMETRY_DETECT_THREAD_MIN);
+
+	MEM_freeN(seeds);
+	MEM_freeN(vkeys);
+	MEM_freeN(dirty_verts);
+
+	mechanical_geometry_tags_clear(bm);
+
+	mechanical_geometry_snapshot_store(bm);
+}
+
+/* Geometry stored on the mesh
+ *
+ * Detected geometry is kept on the Mesh when leaving edit mode, with a hash of the edges and
+ * vertex coordinates it was detected on. Entering edit mode restores it while the hash matches,
+ * instead of a full detection pass.
+ */
+
+/**
+ * Hash of mesh edges and vertex coordinates, never 0.
+ */
+unsigned int mechanical_geometry_mesh_hash(const Mesh *me)
+{
+	BLI_HashMurmur2A mm2;
+	unsigned int hash;
+	int i;
+
+	BLI_hash_mm2a_init(&mm2, 0);
+	BLI_hash_mm2a_add_int(&mm2, me->totvert);
+	BLI_hash_mm2a_add_int(&mm2, me->totedge);
+	for (i = 0; i < me->totedge; i++) {
+		BLI_hash_mm2a_add_int(&mm2, (int)me->medge[i].v1);
+		BLI_hash_mm2a_add_int(&mm2, (int)me->medge[i].v2);
 	}
-	BM_ITER_MESH (v, &iter, bm, BM_EDGES_OF_MESH) {
-		BM_elem_flag_disable(v, BM_ELEM_TAG);
+	for (i = 0; i < me->totvert; i++) {
+		BLI_hash_mm2a_add(&mm2, (const unsigned char *)me->mvert[i].co, sizeof(float[3]));
 	}
+	hash = BLI_hash_mm2a_end(&mm2);
+
+	return hash ? hash : 1;
+}
+
+void mechanical_geometry_mesh_free(Mesh *me)
+{
+	MEM_SAFE_FREE(me->mgeom);
+	MEM_SAFE_FREE(me->mgeom_index);
+	me->totgeom = me->totgeom_index = 0;
+	me->geom_hash = 0;
 }
 
+/**
+ * Stores geometry of \a bm on \a me, once \a me vertices and edges are set.
+ * Nothing is stored when the geometry is not up to date with \a bm vertices.
+ * BMesh vertex and edge indices have to match the mesh ones.
+ */
+void mechanical_geometry_to_mesh(BMesh *bm, Mesh *me)
+{
+	BLI_bitmap *dirty_verts;
+	BMGeom *egm;
+	BMIter iter;
+	int *index;
+	int i, dirty_tot;
+
+	mechanical_geometry_mesh_free(me);
+
+	if (bm->geom_vtable == NULL || me->totvert != bm->totvert || me->totedge != bm->totedge) {
+		return;
+	}
+
+	dirty_verts = BLI_BITMAP_NEW(bm->totvert, __func__);
+	dirty_tot = mechanical_geometry_dirty_verts(bm, dirty_verts);
+	MEM_freeN(dirty_verts);
+	if (dirty_tot) {
+		return;
+	}
+
+	if (bm->totgeom) {
+		me->mgeom = MEM_mallocN(sizeof(*me->mgeom) * bm->totgeom, "Mesh geometry");
+		BM_ITER_MESH (egm, &iter, bm, BM_GEOMETRY_OF_MESH) {
+			me->totgeom_index += egm->totverts + egm->totedges;
+		}
+		me->mgeom_index = index = MEM_mallocN(sizeof(*index) * me->totgeom_index, "Mesh geometry indices");
+
+		BM_ITER_MESH_INDEX (egm, &iter, bm, BM_GEOMETRY_OF_MESH, i) {
+			MGeom *mgm = &me->mgeom[i];
+
+			mgm->geometry_type = egm->geometry_type;
+			mgm->totverts = egm->totverts;
+			mgm->totedges = egm->totedges;
+			mgm->index_start = (int)(index - me->mgeom_index);
+			copy_v3_v3(mgm->center, egm->center);
+			copy_v3_v3(mgm->axis, egm->axis);
+			copy_v3_v3(mgm->start, egm->start);
+			copy_v3_v3(mgm->end, egm->end);
+			copy_v3_v3(mgm->mid, egm->mid);
+			mgm->pad = 0;
+
+			for (int j = 0; j < egm->totverts; j++) {
+				*index++ = BM_elem_index_get(egm->v[j]);
+			}
+			for (int j = 0; j < egm->totedges; j++) {
+				*index++ = BM_elem_index_get(egm->e[j]);
+			}
+		}
+		me->totgeom = bm->totgeom;
+	}
 
+	// Also stored without geometry, no need to detect it again
+	me->geom_hash = mechanical_geometry_mesh_hash(me);
+}
 
+/**
+ * Stored geometry comes from files, check it only uses existing vertices and edges.
+ */
+static bool mechanical_geometry_mesh_elem_valid(const Mesh *me, const MGeom *mgm)
+{
+	const int *index;
+	int j;
+
+	if (!ELEM(mgm->geometry_type, BM_GEOMETRY_TYPE_CIRCLE, BM_GEOMETRY_TYPE_ARC, BM_GEOMETRY_TYPE_LINE) ||
+	    mgm->totverts < 2 || mgm->totedges < 1 ||
+	    mgm->index_start < 0 || mgm->index_start > me->totgeom_index ||
+	    mgm->totverts > me->totgeom_index - mgm->index_start ||
+	    mgm->totedges > me->totgeom_index - mgm->index_start - mgm->totverts)
+	{
+		return false;
+	}
 
+	index = &me->mgeom_index[mgm->index_start];
+	for (j = 0; j < mgm->totverts; j++, index++) {
+		if (*index < 0 || *index >= me->totvert) {
+			return false;
+		}
+	}
+	for (j = 0; j < mgm->totedges; j++, index++) {
+		if (*index < 0 || *index >= me->totedge) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Restores geometry stored on \a me to \a bm, just converted from it, if still valid.
+ * \a vtable and \a etable are the BMesh vertices and edges by mesh index.
+ * Invalid entries are dropped, then the next update is a full one.
+ *
+ * \return true when restored, next update only looks at changes since now.
+ */
+bool mechanical_geometry_from_mesh(BMesh *bm, const Mesh *me, BMVert **vtable, BMEdge **etable)
+{
+	bool valid = true;
+
+	if (me->geom_hash == 0 || bm->totgeom || bm->totvert != me->totvert || bm->totedge != me->totedge) {
+		return false;
+	}
+	if (me->totgeom && (me->mgeom == NULL || me->mgeom_index == NULL)) {
+		return false;
+	}
+	if (me->geom_hash != mechanical_geometry_mesh_hash(me)) {
+		return false;
+	}
+
+	for (int i = 0; i < me->totgeom; i++) {
+		const MGeom *mgm = &me->mgeom[i];
+		const int *index;
+		BMGeom *egm;
+
+		if (!mechanical_geometry_mesh_elem_valid(me, mgm)) {
+			valid = false;
+			continue;
+		}
+		index = &me->mgeom_index[mgm->index_start];
+
+		egm = BLI_mempool_alloc(bm->gpool);
+		bm->totgeom++;
+
+		egm->head.htype = BM_GEOMETRY;
+		egm->head.hflag = 0;
+		egm->head.bm = bm;
+
+		egm->geometry_type = mgm->geometry_type;
+		egm->totverts = mgm->totverts;
+		egm->totedges = mgm->totedges;
+		egm->v = MEM_mallocN(sizeof(BMVert*)*egm->totverts,"geometry vertex pointer array");
+		egm->e = MEM_mallocN(sizeof(BMEdge*)*egm->totedges,"geometry edge pointer array");
+		for (int j = 0; j < egm->totverts; j++) {
+			egm->v[j] = vtable[*index++];
+		}
+		for (int j = 0; j < egm->totedges; j++) {
+			egm->e[j] = etable[*index++];
+		}
+		copy_v3_v3(egm->center, mgm->center);
+		copy_v3_v3(egm->axis, mgm->axis);
+		copy_v3_v3(egm->start, mgm->start);
+		copy_v3_v3(egm->end, mgm->end);
+		copy_v3_v3(egm->mid, mgm->mid);
+
+		mechanical_geometry_map_add(bm, egm);
+	}
+
+	if (!valid) {
+		// Without snapshot, geometry of dropped entries is detected again
+		return false;
+	}
+
+	mechanical_geometry_snapshot_store(bm);
+
+	return true;
+}
@@ -0,0 +1,352 @@
+/*
+ * Planar region index
+ *
+ * Faces are grouped by its quantised normal, so coplanar faces to a direction are found looking
+ * only at the groups around that direction. Vertices are grouped by its offset along the last
+ * direction queried, finding the vertices on a plane normal to it looking at the groups around
+ * the plane offset.
+ *
+ * The index only limits the elements tested, exact tests are the same than testing all of them.
+ */
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_utildefines.h"
+#include "BLI_math.h"
+#include "BLI_ghash.h"
+
+#include "DNA_mesh_types.h"
+
+#include "bmesh.h"
+
+#include "mesh_dimensions.h"
+#include "mechanical_utils.h"
+#include "mechanical_plane_index.h"
+
+/* Cells per unit of normal component, a cell is larger than the angle accepted as parallel
+ * by parallel_v3u_v3u, so neighbour cells are enough */
+#define PLANE_INDEX_NORMAL_CELLS 10.0f
+/* Size of vertex offset cells, distance accepted by point_on_plane_prec */
+#define PLANE_INDEX_OFFSET_CELL 0.1f
+/* Neighbour offset cells to look at, covers the precision loss of point_on_plane_prec */
+#define PLANE_INDEX_OFFSET_RANGE 2
+
+typedef struct MechanicalPlaneIndex {
+	/* quantised normal (int[4]) -> GSet of BMFace */
+	GHash *face_clusters;
+	/* face key, by index */
+	int (*face_keys)[4];
+	int totface;
+
+	/* offset cell along dir -> GSet of BMVert */
+	GHash *vert_cells;
+	/* vertex cell, by index */
+	int *vert_cell;
+	float dir[3];
+	int totvert;
+
+	/* vertices moved since last normals update */
+	GSet *moved_verts;
+} MechanicalPlaneIndex;
+
+static void plane_index_normal_key(int r_key[4], const float no[3])
+{
+	r_key[0] = (int)floorf(no[0] * PLANE_INDEX_NORMAL_CELLS);
+	r_key[1] = (int)floorf(no[1] * PLANE_INDEX_NORMAL_CELLS);
+	r_key[2] = (int)floorf(no[2] * PLANE_INDEX_NORMAL_CELLS);
+	r_key[3] = 0;
+}
+
+static int plane_index_vert_cell(const MechanicalPlaneIndex *pi, const float co[3])
+{
+	return (int)floorf(dot_v3v3(co, pi->dir) / PLANE_INDEX_OFFSET_CELL);
+}
+
+static void plane_index_gset_free(void *gs)
+{
+	BLI_gset_free(gs, NULL);
+}
+
+/* Face clusters */
+
+static void plane_index_face_add(MechanicalPlaneIndex *pi, BMFace *f)
+{
+	const int *key = pi->face_keys[BM_elem_index_get(f)];
+	void **key_p, **val_p;
+
+	if (!BLI_ghash_ensure_p_ex(pi->face_clusters, key, &key_p, &val_p)) {
+		int *key_new = MEM_mallocN(sizeof(int[4]), __func__);
+		copy_v4_v4_int(key_new, key);
+		*key_p = key_new;
+		*val_p = BLI_gset_ptr_new(__func__);
+	}
+	BLI_gset_add(*val_p, f);
+}
+
+static void plane_index_face_update(MechanicalPlaneIndex *pi, BMFace *f)
+{
+	int *key = pi->face_keys[BM_elem_index_get(f)];
+	int key_new[4];
+	GSet *cluster;
+
+	plane_index_normal_key(key_new, f->no);
+	if ((key[0] == key_new[0]) && (key[1] == key_new[1]) && (key[2] == key_new[2])) {
+		return;
+	}
+
+	cluster = BLI_ghash_lookup(pi->face_clusters, key);
+	if (cluster) {
+		BLI_gset_remove(cluster, f, NULL);
+	}
+	copy_v4_v4_int(key, key_new);
+	plane_index_face_add(pi, f);
+}
+
+/* Vertex cells */
+
+static void plane_index_vert_add(MechanicalPlaneIndex *pi, BMVert *v)
+{
+	void **val_p;
+	const int cell = pi->vert_cell[BM_elem_index_get(v)];
+
+	if (!BLI_ghash_ensure_p(pi->vert_cells, SET_INT_IN_POINTER(cell), &val_p)) {
+		*val_p = BLI_gset_ptr_new(__func__);
+	}
+	BLI_gset_add(*val_p, v);
+}
+
+static void plane_index_vert_update(MechanicalPlaneIndex *pi, BMVert *v)
+{
+	int *cell = &pi->vert_cell[BM_elem_index_get(v)];
+	const int cell_new = plane_index_vert_cell(pi, v->co);
+	GSet *verts;
+
+	if (*cell == cell_new) {
+		return;
+	}
+
+	verts = BLI_ghash_lookup(pi->vert_cells, SET_INT_IN_POINTER(*cell));
+	if (verts) {
+		BLI_gset_remove(verts, v, NULL);
+	}
+	*cell = cell_new;
+	plane_index_vert_add(pi, v);
+}
+
+static void plane_index_verts_free(MechanicalPlaneIndex *pi)
+{
+	if (pi->vert_cells) {
+		BLI_ghash_free(pi->vert_cells, NULL, plane_index_gset_free);
+		pi->vert_cells = NULL;
+	}
+	MEM_SAFE_FREE(pi->vert_cell);
+}
+
+/**
+ * Groups vertices by offset along \a dir, unless already done for it or its opposite.
+ */
+static void plane_index_verts_ensure(MechanicalPlaneIndex *pi, BMesh *bm, const float dir[3])
+{
+	BMVert *v;
+	BMIter iter;
+	int i;
+
+	if (pi->vert_cells) {
+		float dir_neg[3];
+		negate_v3_v3(dir_neg, dir);
+		if (equals_v3v3(pi->dir, dir) || equals_v3v3(pi->dir, dir_neg)) {
+			return;
+		}
+		plane_index_verts_free(pi);
+	}
+
+	copy_v3_v3(pi->dir, dir);
+	pi->vert_cells = BLI_ghash_int_new(__func__);
+	pi->vert_cell = MEM_mallocN(sizeof(*pi->vert_cell) * bm->totvert, __func__);
+
+	BM_ITER_MESH_INDEX (v, &iter, bm, BM_VERTS_OF_MESH, i) {
+		pi->vert_cell[i] = plane_index_vert_cell(pi, v->co);
+		plane_index_vert_add(pi, v);
+	}
+}
+
+void mechanical_plane_index_free(BMesh *bm)
+{
+	MechanicalPlaneIndex *pi = bm->plane_index;
+
+	if (pi == NULL) {
+		return;
+	}
+
+	BLI_ghash_free(pi->face_clusters, MEM_freeN, plane_index_gset_free);
+	MEM_freeN(pi->face_keys);
+	plane_index_verts_free(pi);
+	BLI_gset_free(pi->moved_verts, NULL);
+	MEM_freeN(pi);
+
+	bm->plane_index = NULL;
+}
+
+static MechanicalPlaneIndex *plane_index_ensure(BMesh *bm)
+{
+	MechanicalPlaneIndex *pi = bm->plane_index;
+	BMFace *f;
+	BMIter iter;
+	int i;
+
+	if (pi && pi->totvert == bm->totvert && pi->totface == bm->totface) {
+		return pi;
+	}
+	mechanical_plane_index_free(bm);
+
+	/* indices are kept until the index is freed, topology changes free it */
+	BM_mesh_elem_index_ensure(bm, BM_VERT | BM_FACE);
+
+	pi = MEM_callocN(sizeof(*pi), __func__);
+	pi->totvert = bm->totvert;
+	pi->totface = bm->totface;
+	pi->face_clusters = BLI_ghash_new(BLI_ghashutil_inthash_v4_p, BLI_ghashutil_inthash_v4_cmp, __func__);
+	pi->face_keys = MEM_mallocN(sizeof(*pi->face_keys) * bm->totface, __func__);
+	pi->moved_verts = BLI_gset_ptr_new(__func__);
+
+	BM_ITER_MESH_INDEX (f, &iter, bm, BM_FACES_OF_MESH, i) {
+		plane_index_normal_key(pi->face_keys[i], f->no);
+		plane_index_face_add(pi, f);
+	}
+
+	bm->plane_index = pi;
+	return pi;
+}
+
+/**
+ * Tags vertices of faces coplanar to the plane at \a point normal to \a dir,
+ * only testing faces with normal near \a dir.
+ */
+void tag_vertexs_on_coplanar_faces(BMesh *bm, float *point, float *dir)
+{
+	MechanicalPlaneIndex *pi = plane_index_ensure(bm);
+	BMVert *eve;
+	BMIter viter;
+	GSetIterator gs_iter;
+	float p[3], vec[3];
+	float no[3];
+	int key_center[4], key[4];
+
+	for (int side = 0; side < 2; side++) {
+		// Coplanar faces may face both sides
+		if (side == 0) {
+			copy_v3_v3(no, dir);
+		}
+		else {
+			negate_v3_v3(no, dir);
+		}
+		plane_index_normal_key(key_center, no);
+		key[3] = 0;
+
+		for (int x = -1; x <= 1; x++) {
+			for (int y = -1; y <= 1; y++) {
+				for (int z = -1; z <= 1; z++) {
+					GSet *cluster;
+					key[0] = key_center[0] + x;
+					key[1] = key_center[1] + y;
+					key[2] = key_center[2] + z;
+
+					if ((cluster = BLI_ghash_lookup(pi->face_clusters, key)) == NULL) {
+						continue;
+					}
+
+					GSET_ITER (gs_iter, cluster) {
+						BMFace *f = BLI_gsetIterator_getKey(&gs_iter);
+						int ok = 1;
+						if (!parallel_v3u_v3u(dir, f->no)) {
+							continue;
+						}
+						BM_ITER_ELEM (eve, &viter, f, BM_VERTS_OF_FACE) {
+							sub_v3_v3v3(vec, point, eve->co);
+							normalize_v3(vec);
+							project_v3_v3v3(p, vec, dir);
+							if (len_squared_v3(p) > DIM_CONSTRAINT_PRECISION) {
+								ok = 0;
+								break;
+							}
+						}
+						if (ok) {
+							BM_ITER_ELEM (eve, &viter, f, BM_VERTS_OF_FACE) {
+								BM_elem_flag_enable(eve, BM_ELEM_TAG);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Tags vertices on the plane at \a point normal to \a dir,
+ * only testing vertices with offset near the plane.
+ */
+void tag_vertexs_on_plane(BMesh *bm, float *point, float *dir)
+{
+	MechanicalPlaneIndex *pi = plane_index_ensure(bm);
+	GSetIterator gs_iter;
+	int cell;
+
+	plane_index_verts_ensure(pi, bm, dir);
+	cell = plane_index_vert_cell(pi, point);
+
+	for (int i = -PLANE_INDEX_OFFSET_RANGE; i <= PLANE_INDEX_OFFSET_RANGE; i++) {
+		GSet *verts = BLI_ghash_lookup(pi->vert_cells, SET_INT_IN_POINTER(cell + i));
+		if (verts == NULL) {
+			continue;
+		}
+		GSET_ITER (gs_iter, verts) {
+			BMVert *eve = BLI_gsetIterator_getKey(&gs_iter);
+			if (!BM_elem_flag_test(eve, BM_ELEM_TAG) && point_on_plane_prec(eve->co, dir, point)) {
+				BM_elem_flag_enable(eve, BM_ELEM_TAG);
+			}
+		}
+	}
+}
+
+/**
+ * Keeps track of vertices moved applying a dimension, to update its place on the index.
+ */
+void mechanical_plane_index_vert_moved(BMesh *bm, BMVert *v)
+{
+	if (bm->plane_index) {
+		BLI_gset_add(bm->plane_index->moved_verts, v);
+	}
+}
+
+/**
+ * Normals update keeping the index, only moved vertices and its faces are updated on it.
+ */
+void mechanical_plane_index_normals_update(BMesh *bm)
+{
+	MechanicalPlaneIndex *pi = bm->plane_index;
+	GSetIterator gs_iter;
+
+	// BM_mesh_normals_update frees the index
+	bm->plane_index = NULL;
+	BM_mesh_normals_update(bm);
+	bm->plane_index = pi;
+
+	if (pi == NULL) {
+		return;
+	}
+
+	GSET_ITER (gs_iter, pi->moved_verts) {
+		BMVert *v = BLI_gsetIterator_getKey(&gs_iter);
+		BMFace *f;
+		BMIter iter;
+
+		if (pi->vert_cells) {
+			plane_index_vert_update(pi, v);
+		}
+		BM_ITER_ELEM (f, &iter, v, BM_FACES_OF_VERT) {
+			plane_index_face_update(pi, f);
+		}
+	}
+	BLI_gset_clear(pi->moved_verts, NULL);
+}
@@ -18,49 +18,6 @@
 
 
 
-void tag_vertexs_on_coplanar_faces(BMesh *bm, float *point, float* dir){
-	BMFace *f;
-	BMVert *eve;
-	BMIter iter, viter;
-	float p[3],vec[3];
-
-	BM_ITER_MESH (f, &iter, bm, BM_FACES_OF_MESH) {
-		if (parallel_v3u_v3u(dir,f->no)) {
-			// Coplanar?
-			int ok =1;
-			BM_ITER_ELEM (eve, &viter, f, BM_VERTS_OF_FACE) {
-				sub_v3_v3v3(vec, point, eve->co);
-				normalize_v3(vec);
-				project_v3_v3v3(p,vec,dir);
-				if (len_squared_v3(p) > DIM_CONSTRAINT_PRECISION) {
-					ok = 0;
-					break;
-				}
-			}
-			if (ok) {
-				BM_ITER_ELEM (eve, &viter, f, BM_VERTS_OF_FACE) {
-					BM_elem_flag_enable(eve, BM_ELEM_TAG);
-				}
-			}
-		}
-	}
-}
-
-void tag_vertexs_on_plane(BMesh *bm, float *p, float *n) {
-	BMVert *eve;
-	BMIter iter;
-
-	BM_ITER_MESH (eve, &iter, bm, BM_VERTS_OF_MESH) {
-		if (!BM_elem_flag_test(eve, BM_ELEM_TAG)) {
-			if (point_on_plane_prec(eve->co, n, p)) {
-				BM_elem_flag_enable(eve, BM_ELEM_TAG);
-			}
-		} else {
-			// Already Tagged
-		}
-	}
-}
-
 void tag_vertexs_affected_by_dimension (BMesh *bm, BMDim *edm)
 {
 	BMIter iter;
@@ -2,6 +2,9 @@
 #include "BLI_utildefines.h"
 #include "BLI_math.h"
 #include "BLI_listbase.h"
+#include "BLI_ghash.h"
+#include "BLI_task.h"
+#include "BLI_hash_mm2a.h"
 
 #include "DNA_mesh_types.h"
 
@@ -16,13 +19,55 @@
 #include "mesh_dimensions.h"
 #include "mesh_references.h"
 #include "mechanical_utils.h"
+#include "mechanical_plane_index.h"
 #include "prec_math.h"
 
 #include "MEM_guardedalloc.h"
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 
 static void set_dimension_start_end(BMesh *bm, BMDim *edm, Scene *scene);
 
+/* Batched dimension changes, vertices affected by every non driven dimension are gathered once */
+typedef struct DimensionBatch {
+	BMVert **sel_verts;
+	int sel_tot;
+	/* when set, collects moved vertices */
+	GSet *moved_verts;
+} DimensionBatch;
+
+static void dimension_vert_moved(BMesh *bm, const DimensionBatch *batch, BMVert *v)
+{
+	mechanical_plane_index_vert_moved(bm, v);
+	if (batch && batch->moved_verts) {
+		BLI_gset_add(batch->moved_verts, v);
+	}
+}
+
+/**
+ * Tags vertices affected by \a edm, on a batch only selected vertices are tagged
+ * as all tags are disabled before and after applying each dimension.
+ */
+static void dimension_tag_affected(BMesh *bm, BMDim *edm, const DimensionBatch *batch)
+{
+	if (batch == NULL) {
+		tag_vertexs_affected_by_dimension(bm, edm);
+		return;
+	}
+
+	if (!edm->mdim->adt) {
+		for (int i = 0; i < batch->sel_tot; i++) {
+			BM_elem_flag_enable(batch->sel_verts[i], BM_ELEM_TAG);
+		}
+	}
+	for (int i = 0; i < edm->totverts; i++) {
+		BM_elem_flag_enable(edm->v[i], BM_ELEM_TAG);
+	}
+}
+
 bool valid_constraint_setting(BMDim *edm, int constraint) {
 	bool ret = false;
 	switch (constraint) {
@@ -101,13 +146,176 @@ static void apply_dimension_radius_from_center_exec(float* point, float *center,
 	add_v3_v3v3(point,ncenter,v);
 }
 
-static void apply_dimension_radius_from_center(BMesh *bm, BMDim *edm, float value, int constraints) {
+/* Moves of tagged vertices
+ *
+ * Tagged vertices are gathered once, its coordinates are copied by chunks to SoA buffers
+ * (x, y and z arrays) to be moved four at once and copied back.
+ */
+
+/* Vertices moved by each task */
+#define DIM_MOVE_CHUNK 512
+
+typedef struct DimensionVertsMove {
+	BMVert **verts;
+	int tot;
+
+	/* translation */
+	float vec[3];
+
+	/* radial move around the axis through center */
+	bool radial;
+	float center[3], axis[3];
+	float inc;
+
+	const DimensionBatch *batch;
+} DimensionVertsMove;
+
+/**
+ * \return tagged vertices of \a bm, tags are disabled.
+ */
+static BMVert **dimension_tagged_verts_gather(BMesh *bm, int *r_tot)
+{
+	BMVert **verts = MEM_mallocN(sizeof(*verts) * bm->totvert, __func__);
+	BMVert *eve;
+	BMIter iter;
+	int tot = 0;
+
+	BM_ITER_MESH (eve, &iter, bm, BM_VERTS_OF_MESH) {
+		if (BM_elem_flag_test(eve, BM_ELEM_TAG)) {
+			verts[tot++] = eve;
+			BM_elem_flag_disable(eve, BM_ELEM_TAG);
+		}
+	}
+
+	*r_tot = tot;
+	return verts;
+}
+
+static void dimension_move_translate(float *x, float *y, float *z, const int tot, const float vec[3])
+{
+	int i = 0;
+
+#ifdef __SSE2__
+	const __m128 vx = _mm_set1_ps(vec[0]);
+	const __m128 vy = _mm_set1_ps(vec[1]);
+	const __m128 vz = _mm_set1_ps(vec[2]);
+	for (; i + 4 <= tot; i += 4) {
+		_mm_storeu_ps(&x[i], _mm_add_ps(_mm_loadu_ps(&x[i]), vx));
+		_mm_storeu_ps(&y[i], _mm_add_ps(_mm_loadu_ps(&y[i]), vy));
+		_mm_storeu_ps(&z[i], _mm_add_ps(_mm_loadu_ps(&z[i]), vz));
+	}
+#endif
+
+	for (; i < tot; i++) {
+		x[i] += vec[0];
+		y[i] += vec[1];
+		z[i] += vec[2];
+	}
+}
+
+/**
+ * Same as #apply_dimension_radius_from_center_exec, \a axis must be normalized.
+ */
+static void dimension_move_radial(float *x, float *y, float *z, const int tot,
+                                  const float center[3], const float axis[3], const float inc)
+{
+	int i = 0;
+
+#ifdef __SSE2__
+	const __m128 cx = _mm_set1_ps(center[0]);
+	const __m128 cy = _mm_set1_ps(center[1]);
+	const __m128 cz = _mm_set1_ps(center[2]);
+	const __m128 ax = _mm_set1_ps(axis[0]);
+	const __m128 ay = _mm_set1_ps(axis[1]);
+	const __m128 az = _mm_set1_ps(axis[2]);
+	const __m128 vinc = _mm_set1_ps(inc);
+	const __m128 eps = _mm_set1_ps(1.0e-35f);
+	for (; i + 4 <= tot; i += 4) {
+		const __m128 px = _mm_sub_ps(_mm_loadu_ps(&x[i]), cx);
+		const __m128 py = _mm_sub_ps(_mm_loadu_ps(&y[i]), cy);
+		const __m128 pz = _mm_sub_ps(_mm_loadu_ps(&z[i]), cz);
+		const __m128 t = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, ax), _mm_mul_ps(py, ay)), _mm_mul_ps(pz, az));
+		/* point on axis, relative to center */
+		const __m128 nx = _mm_mul_ps(t, ax);
+		const __m128 ny = _mm_mul_ps(t, ay);
+		const __m128 nz = _mm_mul_ps(t, az);
+		const __m128 rx = _mm_sub_ps(px, nx);
+		const __m128 ry = _mm_sub_ps(py, ny);
+		const __m128 rz = _mm_sub_ps(pz, nz);
+		const __m128 len_sq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)), _mm_mul_ps(rz, rz));
+		const __m128 len = _mm_sqrt_ps(len_sq);
+		/* points on the axis are moved to the axis, as normalize_v3 gives a zero vector */
+		const __m128 fac = _mm_and_ps(_mm_cmpgt_ps(len_sq, eps), _mm_div_ps(_mm_add_ps(len, vinc), len));
+		_mm_storeu_ps(&x[i], _mm_add_ps(_mm_add_ps(cx, nx), _mm_mul_ps(rx, fac)));
+		_mm_storeu_ps(&y[i], _mm_add_ps(_mm_add_ps(cy, ny), _mm_mul_ps(ry, fac)));
+		_mm_storeu_ps(&z[i], _mm_add_ps(_mm_add_ps(cz, nz), _mm_mul_ps(rz, fac)));
+	}
+#endif
+
+	for (; i < tot; i++) {
+		float co[3] = {x[i], y[i], z[i]};
+		apply_dimension_radius_from_center_exec(co, (float *)center, (float *)axis, inc);
+		x[i] = co[0];
+		y[i] = co[1];
+		z[i] = co[2];
+	}
+}
+
+static void dimension_verts_move_task_cb(void *userdata, const int chunk)
+{
+	const DimensionVertsMove *data = userdata;
+	float x[DIM_MOVE_CHUNK], y[DIM_MOVE_CHUNK], z[DIM_MOVE_CHUNK];
+	BMVert **verts = &data->verts[chunk * DIM_MOVE_CHUNK];
+	const int tot = min_ii(data->tot - chunk * DIM_MOVE_CHUNK, DIM_MOVE_CHUNK);
+	int i;
+
+	for (i = 0; i < tot; i++) {
+		x[i] = verts[i]->co[0];
+		y[i] = verts[i]->co[1];
+		z[i] = verts[i]->co[2];
+	}
+
+	if (data->radial) {
+		dimension_move_radial(x, y, z, tot, data->center, data->axis, data->inc);
+	}
+	else {
+		dimension_move_translate(x, y, z, tot, data->vec);
+	}
+
+	for (i = 0; i < tot; i++) {
+		verts[i]->co[0] = x[i];
+		verts[i]->co[1] = y[i];
+		verts[i]->co[2] = z[i];
+	}
+}
+
+/**
+ * Moves and untags tagged vertices of \a bm, as set on \a data.
+ */
+static void dimension_tagged_verts_move(BMesh *bm, DimensionVertsMove *data)
+{
+	data->verts = dimension_tagged_verts_gather(bm, &data->tot);
+	if (data->tot) {
+		BLI_task_parallel_range(0, (data->tot + DIM_MOVE_CHUNK - 1) / DIM_MOVE_CHUNK, data,
+		                        dimension_verts_move_task_cb, (data->tot >= BM_OMP_LIMIT));
+	}
+
+	// plane index is not thread safe
+	for (int i = 0; i < data->tot; i++) {
+		dimension_vert_moved(bm, data->batch, data->verts[i]);
+	}
+	MEM_freeN(data->verts);
+}
+
+static void apply_dimension_radius_from_center(BMesh *bm, BMDim *edm, float value, int constraints,
+                                               const DimensionBatch *batch) {
 
 	BLI_assert (ELEM(edm->mdim->dim_type,DIM_TYPE_DIAMETER, DIM_TYPE_RADIUS));
 
 	float axis[3],v[3], ncenter[3], p[3];
 	float curv = get_dimension_value(edm); // Current Value
 	float inc;
+	DimensionVertsMove move = {NULL};
 
 	BMIter iter;
 	BMVert* eve;
@@ -120,7 +328,7 @@ static void apply_dimension_radius_from_center(BMesh *bm, BMDim *edm, float valu
 
 	get_dimension_plane(axis, p, edm);
 
-	tag_vertexs_affected_by_dimension (bm, edm);
+	dimension_tag_affected(bm, edm, batch);
 
 	if (constraints & DIM_AXIS_CONSTRAINT) {
 
@@ -139,13 +347,12 @@ static void apply_dimension_radius_from_center(BMesh *bm, BMDim *edm, float valu
 	}
 
 	// Update related Verts
-	BM_ITER_MESH (eve, &iter, bm, BM_VERTS_OF_MESH) {
-		if (BM_elem_flag_test(eve, BM_ELEM_TAG)) {
-			apply_dimension_radius_from_center_exec(eve->co,edm->mdim->center,axis,inc);
-			// Reset tag
-			BM_elem_flag_disable(eve, BM_ELEM_TAG);
-		}
-	}
+	move.radial = true;
+	copy_v3_v3(move.center, edm->mdim->center);
+	normalize_v3_v3(move.axis, axis);
+	move.inc = inc;
+	move.batch = batch;
+	dimension_tagged_verts_move(bm, &move);
 }
 
 /**
@@ -171,12 +378,11 @@ static void apply_dimension_linear_value_exec( float *a, float *b, float value,
 }
 
 
-static void apply_dimension_linear_value(BMesh *bm, BMDim *edm, float value, int constraints) {
+static void apply_dimension_linear_value(BMesh *bm, BMDim *edm, float value, int constraints,
+                                         const DimensionBatch *batch) {
 
 	float v[3], n[3];
-
-	BMIter iter;
-	BMVert* eve;
+	DimensionVertsMove move = {NULL};
 
 	BLI_assert (edm->mdim->dim_type == DIM_TYPE_LINEAR);
 
@@ -185,14 +391,14 @@ static void apply_dimension_linear_value(BMesh *bm, BMDim *edm, float value, int
 		float len=get_dimension_value(edm);
 		float len2=(value-len)/2;
 		edm->mdim->dir = DIM_DIR_RIGHT;
-		apply_dimension_linear_value(bm, edm,(len+len2), constraints);
+		apply_dimension_linear_value(bm, edm,(len+len2), constraints, batch);
 		edm->mdim->dir = DIM_DIR_LEFT;
-		apply_dimension_linear_value(bm, edm,value,constraints);
+		apply_dimension_linear_value(bm, edm,value,constraints, batch);
 		edm->mdim->dir = DIM_DIR_BOTH;
 		return;
 	}
 
-	tag_vertexs_affected_by_dimension (bm, edm);
+	dimension_tag_affected(bm, edm, batch);
 
 	if (constraints & DIM_PLANE_CONSTRAINT) {
 		float p[3], d_dir[3];
@@ -214,25 +420,24 @@ static void apply_dimension_linear_value(BMesh *bm, BMDim *edm, float value, int
 		sub_v3_v3v3(n, edm->mdim->end, edm->mdim->start);
 		normalize_v3(n);
 		apply_dimension_linear_value_exec(edm->v[1]->co,edm->v[0]->co, value, v, n);
+		dimension_vert_moved(bm, batch, edm->v[1]);
 	}else if(edm->mdim->dir== DIM_DIR_LEFT){
 		sub_v3_v3v3(n, edm->mdim->start, edm->mdim->end);
 		normalize_v3(n);
 		apply_dimension_linear_value_exec(edm->v[0]->co,edm->v[1]->co, value, v, n);
+		dimension_vert_moved(bm, batch, edm->v[0]);
 	}
 
 	// Update related Verts
-	BM_ITER_MESH (eve, &iter, bm, BM_VERTS_OF_MESH) {
-		if (BM_elem_flag_test(eve, BM_ELEM_TAG)) {
-			add_v3_v3(eve->co, v);
-			// Reset tag
-			BM_elem_flag_disable(eve, BM_ELEM_TAG);
-		}
-	}
+	copy_v3_v3(move.vec, v);
+	move.batch = batch;
+	dimension_tagged_verts_move(bm, &move);
 
 }
 
 static void apply_dimension_angle_exec(BMesh *bm, BMVert *eve, float *center,
-                                       float *axis, float value, int constraints) {
+                                       float *axis, float value, int constraints,
+                                       const DimensionBatch *batch) {
 	float rot[3], delta[3], r[3], p[3];
 	BMVert *v,*v2;
 	BMFace *f;
@@ -246,6 +451,7 @@ static void apply_dimension_angle_exec(BMesh *bm, BMVert *eve, float *center,
 	normalize_v3(dir);
 	rotate_v3_v3v3fl(rot, delta, axis, DEG2RAD(value));
 	add_v3_v3v3(eve->co, rot, center);
+	dimension_vert_moved(bm, batch, eve);
 
 	if (constraints & DIM_ALLOW_SLIDE_CONSTRAINT) {
 		// DIM_TYPE_ANGLE_3P
@@ -272,7 +478,8 @@ static void apply_dimension_angle_exec(BMesh *bm, BMVert *eve, float *center,
 	}
 }
 
-static void apply_dimension_angle(BMesh *bm, BMDim *edm, float value, int constraints) {
+static void apply_dimension_angle(BMesh *bm, BMDim *edm, float value, int constraints,
+                                  const DimensionBatch *batch) {
 	float axis[3], ncenter[3], v[3], pp[3];
 	float d; //Difential to move
 
@@ -290,9 +497,9 @@ static void apply_dimension_angle(BMesh *bm, BMDim *edm, float value, int constr
 	if (edm->mdim->dir == DIM_DIR_BOTH) {
 		// Both sides
 		edm->mdim->dir = DIM_DIR_RIGHT;
-		apply_dimension_angle(bm, edm,value - d/2.0f, constraints);
+		apply_dimension_angle(bm, edm,value - d/2.0f, constraints, batch);
 		edm->mdim->dir = DIM_DIR_LEFT;
-		apply_dimension_angle(bm, edm,value,constraints);
+		apply_dimension_angle(bm, edm,value,constraints, batch);
 		edm->mdim->dir = DIM_DIR_BOTH;
 		return;
 	}
@@ -314,7 +521,7 @@ static void apply_dimension_angle(BMesh *bm, BMDim *edm, float value, int constr
 	cross_v3_v3v3(d_dir,axis,r);
 	normalize_v3(d_dir);
 
-	tag_vertexs_affected_by_dimension (bm, edm);
+	dimension_tag_affected(bm, edm, batch);
 
 	if (constraints & DIM_PLANE_CONSTRAINT) {
 		tag_vertexs_on_coplanar_faces(bm, p, d_dir);
@@ -325,16 +532,16 @@ static void apply_dimension_angle(BMesh *bm, BMDim *edm, float value, int constr
 	untag_dimension_necessary_verts(edm);
 
 	if (edm->mdim->dir == DIM_DIR_RIGHT) {
-		apply_dimension_angle_exec(bm,edm->v[2],edm->mdim->center, axis,d,constraints);
+		apply_dimension_angle_exec(bm,edm->v[2],edm->mdim->center, axis,d,constraints, batch);
 		if (edm->mdim->dim_type == DIM_TYPE_ANGLE_4P){
-			apply_dimension_angle_exec(bm, edm->v[3],edm->mdim->center, axis,d,constraints);
+			apply_dimension_angle_exec(bm, edm->v[3],edm->mdim->center, axis,d,constraints, batch);
 		}
 	}
 	if (edm->mdim->dir == DIM_DIR_LEFT) {
 		d = d*(-1);
-		apply_dimension_angle_exec(bm, edm->v[0],edm->mdim->center, axis, d,constraints);
+		apply_dimension_angle_exec(bm, edm->v[0],edm->mdim->center, axis, d,constraints, batch);
 		if (edm->mdim->dim_type == DIM_TYPE_ANGLE_4P){
-			apply_dimension_angle_exec(bm, edm->v[1],edm->mdim->center, axis,d, constraints);
+			apply_dimension_angle_exec(bm, edm->v[1],edm->mdim->center, axis,d, constraints, batch);
 		}
 	}
 
@@ -350,7 +557,7 @@ static void apply_dimension_angle(BMesh *bm, BMDim *edm, float value, int constr
 			project_v3_v3v3(ncenter,v, axis);
 			add_v3_v3(ncenter,edm->mdim->center);
 
-			apply_dimension_angle_exec(bm, eve,ncenter, axis, d, constraints);
+			apply_dimension_angle_exec(bm, eve,ncenter, axis, d, constraints, batch);
 
 			// Reset tag
 			BM_elem_flag_disable(eve, BM_ELEM_TAG);
@@ -358,70 +565,239 @@ static void apply_dimension_angle(BMesh *bm, BMDim *edm, float value, int constr
 	}
 }
 
+/* Cylindrical index cells, radius cells match eq_ff_prec precision
+ * and axial cells the distance accepted by point_on_plane_prec */
+#define CONCENTRIC_CELL 0.1f
+/* Neighbour cells looked at, covers the precision loss of the exact tests */
+#define CONCENTRIC_AXIAL_RANGE 2
+#define CONCENTRIC_RADIAL_RANGE 1
+
+typedef struct ConcentricMove {
+	float c_original[3], c_modified[3];
+	float r1, r2;
+	bool valid;
+} ConcentricMove;
+
+typedef struct ConcentricData {
+	BMVert **vtable;
+	const float *v_in;
+	const float *axis_co, *axis_co2;
+	const float *axis;
+
+	/* cylindrical cell of untagged vertices */
+	int (*keys)[4];
+
+	/* tagged vertices and its moves */
+	const int *tagged;
+	ConcentricMove *moves;
+
+	/* vertices to move and the move applied */
+	const int *verts;
+	const int *vert_move;
+} ConcentricData;
+
+static void concentric_cell_key(int r_key[4], const float co[3], const float axis_co[3], const float axis[3])
+{
+	float r[3], p[3];
+	v_perpendicular_to_axis(r, (float *)co, (float *)axis_co, (float *)axis);
+	sub_v3_v3v3(p, co, axis_co);
+	r_key[0] = (int)floorf(dot_v3v3(p, axis) / CONCENTRIC_CELL);
+	r_key[1] = (int)floorf(len_v3(r) / CONCENTRIC_CELL);
+	r_key[2] = 0;
+	r_key[3] = 0;
+}
+
+static void concentric_keys_task_cb(void *userdata, const int i)
+{
+	ConcentricData *data = userdata;
+	BMVert *eve = data->vtable[i];
+
+	if (!BM_elem_flag_test_bool(eve, BM_ELEM_TAG)) {
+		concentric_cell_key(data->keys[i], eve->co, data->axis_co, data->axis);
+	}
+}
+
+static void concentric_moves_task_cb(void *userdata, const int i)
+{
+	ConcentricData *data = userdata;
+	const int index = data->tagged[i];
+	BMVert *eve1 = data->vtable[index];
+	const float *co_in = &data->v_in[index * 3];
+	ConcentricMove *move = &data->moves[i];
+	float r_original[3], r_modified[3];
+	float n[3];
+
+	move->valid = false;
+	if (equals_v3v3(co_in, eve1->co)) {
+		return;
+	}
+
+	// Changed apply changes on concetric
+	v_perpendicular_to_axis(r_original, (float *)co_in, (float *)data->axis_co, (float *)data->axis);
+	add_v3_v3v3(move->c_original, co_in, r_original);
+	normal_tri_v3(n, data->axis_co, data->axis_co2, co_in);
+	if (point_on_plane_prec((float *)data->axis_co, n, eve1->co)) {
+		v_perpendicular_to_axis(r_modified, eve1->co, (float *)data->axis_co, (float *)data->axis);
+		add_v3_v3v3(move->c_modified, eve1->co, r_modified);
+		move->r1 = len_v3(r_original);
+		move->r2 = len_v3(r_modified);
+		move->valid = true;
+	}
+}
+
+static void concentric_apply_task_cb(void *userdata, const int i)
+{
+	ConcentricData *data = userdata;
+	BMVert *eve = data->vtable[data->verts[i]];
+	const ConcentricMove *move = &data->moves[data->vert_move[i]];
+	float rad[3];
+
+	v_perpendicular_to_axis(rad, eve->co, (float *)data->axis_co, (float *)data->axis);
+	normalize_v3_length(rad, -move->r2);
+	add_v3_v3v3(eve->co, move->c_modified, rad);
+}
+
 /**
  * @brief apply_dimension_concentric_constraint
  * @param bm
  * @param edm
  * @param v_in
  * @see http://www.mechanicalblender.org/modules/static/doc/apply_dimension_concentric_constraint.svg
+ *
+ * Untagged vertices are grouped by axial position and radius around the reference axis,
+ * only vertices on the cells around each moved circle are tested. A vertex on several moved
+ * circles takes the move of the first tagged vertex, as when moves were applied one by one.
  */
-static void apply_dimension_concentric_constraint (BMesh *bm, BMDim *edm, float *v_in){
-	float constraint_axis[3], r_original[3], r_modified[3];
-	float rad[3], r_rad[3];
-	float c_original[3], c_modified[3];
-	float r1, r2;
-	float n[3];
-	int i =0;
-	BMVert *eve, *eve1;
-	BMIter iter, iter1;
+static void apply_dimension_concentric_constraint (BMesh *bm, BMDim *edm, float *v_in,
+                                                   const DimensionBatch *batch) {
+	float constraint_axis[3];
+	const bool use_threading = (bm->totvert >= BM_OMP_LIMIT);
+	ConcentricData data;
+	GHash *cells;
+	int *tagged, *next, *vert_move, *verts;
+	int tagged_tot = 0, verts_tot = 0;
+	int i, m;
+	BMVert *eve;
+	BMIter iter;
 	BMReference *erf = BM_reference_at_index_find(bm, edm->mdim->axis-1);
 	BLI_assert(erf->type == BM_REFERENCE_TYPE_AXIS);
 	sub_v3_v3v3(constraint_axis,erf->v1, erf->v2);
 	normalize_v3(constraint_axis);
 
-	tag_vertexs_affected_by_dimension(bm,edm);
+	dimension_tag_affected(bm, edm, batch);
+
+	BM_mesh_elem_index_ensure(bm, BM_VERT);
+	BM_mesh_elem_table_ensure(bm, BM_VERT);
 
-	BM_ITER_MESH_INDEX (eve1, &iter1, bm, BM_VERTS_OF_MESH, i) {
-		if (!BM_elem_flag_test_bool(eve1, BM_ELEM_TAG)) {
+	tagged = MEM_mallocN(sizeof(*tagged) * bm->totvert, __func__);
+	BM_ITER_MESH_INDEX (eve, &iter, bm, BM_VERTS_OF_MESH, i) {
+		if (BM_elem_flag_test_bool(eve, BM_ELEM_TAG)) {
+			tagged[tagged_tot++] = i;
+		}
+	}
+
+	data.vtable = bm->vtable;
+	data.v_in = v_in;
+	data.axis_co = erf->v1;
+	data.axis_co2 = erf->v2;
+	data.axis = constraint_axis;
+	data.keys = MEM_mallocN(sizeof(*data.keys) * bm->totvert, __func__);
+	data.tagged = tagged;
+	data.moves = MEM_mallocN(sizeof(*data.moves) * max_ii(tagged_tot, 1), __func__);
+
+	BLI_task_parallel_range(0, bm->totvert, &data, concentric_keys_task_cb, use_threading);
+	BLI_task_parallel_range(0, tagged_tot, &data, concentric_moves_task_cb, use_threading);
+
+	// Cells keep a list of vertices, linked by index on next
+	cells = BLI_ghash_new(BLI_ghashutil_inthash_v4_p, BLI_ghashutil_inthash_v4_cmp, __func__);
+	next = MEM_mallocN(sizeof(*next) * bm->totvert, __func__);
+	for (i = 0; i < bm->totvert; i++) {
+		void **val_p;
+		if (BM_elem_flag_test_bool(bm->vtable[i], BM_ELEM_TAG)) {
 			continue;
 		}
-		if (!equals_v3v3(&v_in[i*3],eve1->co)) {
-			// Changed apply changes on concetric
-			v_perpendicular_to_axis (r_original, &v_in[i*3], erf->v1, constraint_axis);
-			add_v3_v3v3(c_original, &v_in[i*3], r_original);
-			normal_tri_v3(n,erf->v1, erf->v2, &v_in[i*3]);
-			if (point_on_plane_prec(erf->v1, n, eve1->co)) {
-				v_perpendicular_to_axis (r_modified, eve1->co, erf->v1, constraint_axis);
-				add_v3_v3v3(c_modified,eve1->co, r_modified);
-				r1 = len_v3(r_original);
-				r2 = len_v3(r_modified);
-
-				BM_ITER_MESH (eve, &iter, bm, BM_VERTS_OF_MESH) {
-					if (!BM_elem_flag_test_bool(eve, BM_ELEM_TAG)) {
-						if (point_on_plane_prec(eve->co,constraint_axis,c_original)) {
-							// OK
-							v_perpendicular_to_axis (rad, eve->co, erf->v1, constraint_axis);
-							if (eq_ff_prec(len_v3(rad), r1)) {
-								copy_v3_v3(r_rad,rad);
-								normalize_v3_length(r_rad,-r2);
-								add_v3_v3v3(eve->co, c_modified, r_rad);
-							}
+		next[i] = BLI_ghash_ensure_p(cells, data.keys[i], &val_p) ? GET_INT_FROM_POINTER(*val_p) - 1 : -1;
+		*val_p = SET_INT_IN_POINTER(i + 1);
+	}
+
+	vert_move = MEM_mallocN(sizeof(*vert_move) * bm->totvert, __func__);
+	copy_vn_i(vert_move, bm->totvert, -1);
+	verts = MEM_mallocN(sizeof(*verts) * bm->totvert, __func__);
+
+	for (m = 0; m < tagged_tot; m++) {
+		ConcentricMove *move = &data.moves[m];
+		int key_center[4], key[4];
+
+		if (!move->valid) {
+			continue;
+		}
+		concentric_cell_key(key_center, move->c_original, erf->v1, constraint_axis);
+		key[2] = key[3] = 0;
+
+		for (int a = -CONCENTRIC_AXIAL_RANGE; a <= CONCENTRIC_AXIAL_RANGE; a++) {
+			for (int r = -CONCENTRIC_RADIAL_RANGE; r <= CONCENTRIC_RADIAL_RANGE; r++) {
+				void *val;
+				key[0] = key_center[0] + a;
+				key[1] = (int)floorf(move->r1 / CONCENTRIC_CELL) + r;
+
+				if ((val = BLI_ghash_lookup(cells, key)) == NULL) {
+					continue;
+				}
+				for (i = GET_INT_FROM_POINTER(val) - 1; i != -1; i = next[i]) {
+					float rad[3];
+					eve = bm->vtable[i];
+					if (vert_move[i] != -1) {
+						continue;
+					}
+					if (point_on_plane_prec(eve->co, constraint_axis, move->c_original)) {
+						// OK
+						v_perpendicular_to_axis (rad, eve->co, erf->v1, constraint_axis);
+						if (eq_ff_prec(len_v3(rad), move->r1)) {
+							vert_move[i] = m;
 						}
 					}
 				}
 			}
 		}
+	}
 
+	// Deterministic order, moves are written once per vertex
+	for (i = 0; i < bm->totvert; i++) {
+		if (vert_move[i] != -1) {
+			verts[verts_tot] = i;
+			vert_move[verts_tot] = vert_move[i];
+			verts_tot++;
+		}
 	}
+	data.verts = verts;
+	data.vert_move = vert_move;
+	BLI_task_parallel_range(0, verts_tot, &data, concentric_apply_task_cb, use_threading);
+
+	for (i = 0; i < verts_tot; i++) {
+		dimension_vert_moved(bm, batch, bm->vtable[verts[i]]);
+	}
+
+	BLI_ghash_free(cells, NULL, NULL);
+	MEM_freeN(next);
+	MEM_freeN(vert_move);
+	MEM_freeN(verts);
+	MEM_freeN(data.keys);
+	MEM_freeN(data.moves);
+	MEM_freeN(tagged);
 
 	BM_ITER_MESH(eve, &iter, bm, BM_VERTS_OF_MESH) {
 		BM_elem_flag_disable(eve, BM_ELEM_TAG);
 	}
 }
 
-void apply_dimension_value (BMesh *bm, BMDim *edm, float value, ToolSettings *ts) {
+static int dimension_constraints_get(BMDim *edm, const int constraints_default)
+{
+	return (edm->mdim->constraints & DIM_CONSTRAINT_OVERRIDE) ? edm->mdim->constraints : constraints_default;
+}
 
-	int constraints = (edm->mdim->constraints & DIM_CONSTRAINT_OVERRIDE) ? edm->mdim->constraints : ts->dimension_constraints;
+static void apply_dimension_value_ex(BMesh *bm, BMDim *edm, float value, int constraints,
+                                     const DimensionBatch *batch)
+{
 	float *v_in = NULL;
 	int i =0;
 	BMVert *eve;
@@ -437,28 +813,218 @@ void apply_dimension_value (BMesh *bm, BMDim *edm, float value, ToolSettings *ts
 
 	switch (edm->mdim->dim_type) {
 		case DIM_TYPE_LINEAR:
-			apply_dimension_linear_value(bm,edm,value,constraints);
+			apply_dimension_linear_value(bm,edm,value,constraints,batch);
 			break;
 		case DIM_TYPE_DIAMETER:
-			apply_dimension_radius_from_center(bm,edm,value/2.0f,constraints);
+			apply_dimension_radius_from_center(bm,edm,value/2.0f,constraints,batch);
 			break;
 		case DIM_TYPE_RADIUS:
-			apply_dimension_radius_from_center(bm,edm,value,constraints);
+			apply_dimension_radius_from_center(bm,edm,value,constraints,batch);
 			break;
 		case DIM_TYPE_ANGLE_3P:
 		case DIM_TYPE_ANGLE_4P:
-			apply_dimension_angle(bm,edm,value,constraints);
+			apply_dimension_angle(bm,edm,value,constraints,batch);
 			break;
 		default:
 			BLI_assert(0);
 	}
 
 	if (edm->mdim->axis > 0) {
-		apply_dimension_concentric_constraint (bm, edm, v_in);
+		apply_dimension_concentric_constraint (bm, edm, v_in, batch);
 		MEM_freeN (v_in);
 	}
+}
+
+void apply_dimension_value (BMesh *bm, BMDim *edm, float value, ToolSettings *ts) {
+
+	int constraints = dimension_constraints_get(edm, ts->dimension_constraints);
+
+	// Vertices may have been moved outside dimensions since the index was built
+	mechanical_plane_index_free(bm);
+
+	apply_dimension_value_ex(bm, edm, value, constraints, NULL);
 
-	BM_mesh_normals_update(bm);
+	// Only updates the plane index for moved vertices
+	mechanical_plane_index_normals_update(bm);
+}
+
+/**
+ * Collects dimensions with a changed value not yet applied to the mesh.
+ *
+ * \param r_dims Array of pending dimensions, to be freed by the caller when any.
+ * \return Number of pending dimensions.
+ */
+int get_pending_dimensions(BMesh *bm, BMDim ***r_dims)
+{
+	BMDim **dims = NULL;
+	BMDim *edm;
+	BMIter iter;
+	int tot = 0;
+
+	BM_ITER_MESH (edm, &iter, bm, BM_DIMS_OF_MESH) {
+		if ((get_dimension_value(edm) != edm->mdim->value) &&
+		    (edm->mdim->value != edm->mdim->value_pr))
+		{
+			if (dims == NULL) {
+				dims = MEM_mallocN(sizeof(*dims) * bm->totdim, __func__);
+			}
+			dims[tot++] = edm;
+		}
+	}
+
+	*r_dims = dims;
+	return tot;
+}
+
+typedef struct DimensionOrder {
+	int group;
+	int index;
+} DimensionOrder;
+
+static int dimension_order_cmp(const void *a_v, const void *b_v)
+{
+	const DimensionOrder *a = a_v, *b = b_v;
+
+	if (a->group != b->group) {
+		return (a->group < b->group) ? -1 : 1;
+	}
+	return (a->index < b->index) ? -1 : (a->index > b->index);
+}
+
+static int dimension_group_find(int *group, int i)
+{
+	while (group[i] != i) {
+		group[i] = group[group[i]];
+		i = group[i];
+	}
+	return i;
+}
+
+/**
+ * Dimensions sharing vertices depend on each other, they are grouped to be applied
+ * one after the other keeping its order. Groups are ordered by its first dimension.
+ */
+static DimensionOrder *dimension_order_create(BMDim **dims, const int tot)
+{
+	DimensionOrder *order = MEM_mallocN(sizeof(*order) * tot, __func__);
+	int *group = MEM_mallocN(sizeof(*group) * tot, __func__);
+	GHash *vert_dim = BLI_ghash_ptr_new(__func__);
+	int i;
+
+	for (i = 0; i < tot; i++) {
+		group[i] = i;
+	}
+
+	for (i = 0; i < tot; i++) {
+		for (int j = 0; j < dims[i]->totverts; j++) {
+			void **val_p;
+			if (BLI_ghash_ensure_p(vert_dim, dims[i]->v[j], &val_p)) {
+				const int a = dimension_group_find(group, GET_INT_FROM_POINTER(*val_p));
+				const int b = dimension_group_find(group, i);
+				// First dimension is the root
+				group[max_ii(a, b)] = min_ii(a, b);
+			}
+			else {
+				*val_p = SET_INT_IN_POINTER(i);
+			}
+		}
+	}
+
+	for (i = 0; i < tot; i++) {
+		order[i].group = dimension_group_find(group, i);
+		order[i].index = i;
+	}
+	qsort(order, tot, sizeof(*order), dimension_order_cmp);
+
+	BLI_ghash_free(vert_dim, NULL, NULL);
+	MEM_freeN(group);
+
+	return order;
+}
+
+/**
+ * Applies the value of many dimensions in one pass. Dimensions are applied by dependency order,
+ * selected vertices are gathered once and normals are only updated when a dimension constraint
+ * needs them after moving vertices, and at the end.
+ *
+ * \param constraints_default Constraints of dimensions not overriding them.
+ * \param scene Used to update dimension data of dependent dimensions, can be NULL.
+ */
+void apply_dimension_values(BMesh *bm, BMDim **dims, const int tot, const int constraints_default, Scene *scene)
+{
+	apply_dimension_values_ex(bm, dims, tot, constraints_default, scene, NULL);
+}
+
+/**
+ * Same as #apply_dimension_values, collecting moved vertices on \a r_moved_verts when not NULL.
+ * In that case vertices of \a bm must be untagged, as left by a previous call, and selected
+ * vertices are only gathered when a dimension isn't driven, so no vertex loop is done for them.
+ */
+void apply_dimension_values_ex(BMesh *bm, BMDim **dims, const int tot, const int constraints_default,
+                               Scene *scene, GSet *r_moved_verts)
+{
+	DimensionBatch batch = {NULL};
+	DimensionOrder *order;
+	BMVert *eve;
+	BMIter iter;
+	bool normals_dirty = false;
+	bool use_selection = false;
+
+	if (tot == 0) {
+		return;
+	}
+
+	// Vertices may have been moved outside dimensions since the index was built
+	mechanical_plane_index_free(bm);
+
+	// Driven dimensions don't move selected vertices
+	for (int i = 0; i < tot; i++) {
+		if (!dims[i]->mdim->adt) {
+			use_selection = true;
+			break;
+		}
+	}
+
+	// Single tagging pass, tags are kept disabled between dimensions
+	if (use_selection || (r_moved_verts == NULL)) {
+		batch.sel_verts = MEM_mallocN(sizeof(*batch.sel_verts) * bm->totvert, __func__);
+		BM_ITER_MESH (eve, &iter, bm, BM_VERTS_OF_MESH) {
+			BM_elem_flag_disable(eve, BM_ELEM_TAG);
+			if (BM_elem_flag_test(eve, BM_ELEM_SELECT)) {
+				batch.sel_verts[batch.sel_tot++] = eve;
+			}
+		}
+	}
+	batch.moved_verts = r_moved_verts;
+
+	order = dimension_order_create(dims, tot);
+
+	for (int i = 0; i < tot; i++) {
+		BMDim *edm = dims[order[i].index];
+		const int constraints = dimension_constraints_get(edm, constraints_default);
+
+		if (i > 0 && order[i].group == order[i - 1].group) {
+			// Previous dimension may have moved its vertices
+			dimension_data_update(bm, edm, scene);
+			if (get_dimension_value(edm) == edm->mdim->value) {
+				continue;
+			}
+		}
+
+		if (normals_dirty && (constraints & (DIM_PLANE_CONSTRAINT | DIM_ALLOW_SLIDE_CONSTRAINT))) {
+			mechanical_plane_index_normals_update(bm);
+			normals_dirty = false;
+		}
+
+		apply_dimension_value_ex(bm, edm, edm->mdim->value, constraints, &batch);
+		normals_dirty = true;
+	}
+
+	// Only updates the plane index for moved vertices
+	mechanical_plane_index_normals_update(bm);
+
+	MEM_freeN(order);
+	MEM_SAFE_FREE(batch.sel_verts);
 }
 
 BMDim* get_selected_dimension(BMesh *bm){
@@ -752,6 +1318,80 @@ void dimension_data_update (BMesh *bm, BMDim *edm, Scene *scene) {
 	}
 }
 
+/* Dimensions to update before using threads, each update is only some vector math */
+#define DIM_DATA_UPDATE_THREAD_MIN 1000
+
+typedef struct DimensionUpdateData {
+	BMesh *bm;
+	BMDim **dims;
+} DimensionUpdateData;
+
+static void dimension_data_update_task_cb(void *userdata, const int i)
+{
+	DimensionUpdateData *data = userdata;
+	dimension_data_update(data->bm, data->dims[i], NULL);
+}
+
+/**
+ * Updates data of all \a dims, on threads for many of them.
+ * Without scene, updates only read the dimension vertices and write its MDim.
+ */
+void dimension_data_update_array(BMesh *bm, BMDim **dims, const int tot)
+{
+	DimensionUpdateData data = {bm, dims};
+
+	BLI_task_parallel_range(0, tot, &data, dimension_data_update_task_cb, (tot >= DIM_DATA_UPDATE_THREAD_MIN));
+}
+
+static unsigned int dimension_data_hash(BMDim *edm)
+{
+	BLI_HashMurmur2A mm2;
+	unsigned int hash;
+
+	BLI_hash_mm2a_init(&mm2, 0);
+	for (int i = 0; i < edm->totverts; i++) {
+		BLI_hash_mm2a_add(&mm2, (const unsigned char *)edm->v[i]->co, sizeof(float[3]));
+	}
+	BLI_hash_mm2a_add(&mm2, (const unsigned char *)edm->mdim->fpos, sizeof(float[3]));
+	BLI_hash_mm2a_add(&mm2, (const unsigned char *)&edm->mdim->dpos_fact, sizeof(float));
+	BLI_hash_mm2a_add(&mm2, (const unsigned char *)&edm->mdim->value, sizeof(float));
+	BLI_hash_mm2a_add_int(&mm2, edm->totverts);
+	BLI_hash_mm2a_add_int(&mm2, edm->mdim->dim_type);
+	BLI_hash_mm2a_add_int(&mm2, edm->mdim->dir);
+	BLI_hash_mm2a_add_int(&mm2, edm->mdim->dimension_flag);
+	hash = BLI_hash_mm2a_end(&mm2);
+
+	return hash ? hash : 1;
+}
+
+/**
+ * Same as #dimension_data_update, skipped when dimension vertices and placement
+ * did not change since the last call.
+ *
+ * \return true when dimension data has been updated.
+ */
+bool dimension_data_update_check(BMesh *bm, BMDim *edm, Scene *scene)
+{
+	unsigned int hash;
+
+	if (edm->mdim->dimension_flag & DIMENSION_FLAG_TS_ALIGNED) {
+		// Depends on scene transform orientation
+		dimension_data_update(bm, edm, scene);
+		edm->data_hash = 0;
+		return true;
+	}
+
+	hash = dimension_data_hash(edm);
+	if (hash == edm->data_hash) {
+		return false;
+	}
+
+	dimension_data_update(bm, edm, scene);
+	// Placement may be adjusted by the update
+	edm->data_hash = dimension_data_hash(edm);
+	return true;
+}
+
 void get_dimension_transform_orientation_matrix (float mat[][3], BMDim *edm, Scene *scene) {
 	if (edm->mdim->ts ==  0) {
 		// Global
@@ -0,0 +1,214 @@
+/*
+ * Driven dimensions
+ *
+ * Dimension values set by drivers out of edit mode are applied on a BMesh kept on the mesh
+ * (Mesh.dim_bm). Only vertex coordinates are synced with the mesh, and nothing is done when no
+ * driven value changed. Only vertices moved by the dimensions are copied back, but applying a
+ * change still compares all vertices with the mesh (they may be moved without bmesh) and
+ * updates all normals, as constraints look at the whole mesh.
+ *
+ * Changes on the mesh through bmesh (leaving edit mode) free the BMesh, other changes are
+ * detected comparing element counts and dimensions.
+ */
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_utildefines.h"
+#include "BLI_math.h"
+#include "BLI_ghash.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "BKE_mesh.h"
+
+#include "bmesh.h"
+
+#include "mesh_dimensions.h"
+#include "mesh_dimensions_driven.h"
+
+void mesh_dimensions_driven_cache_free(Mesh *me)
+{
+	if (me->dim_bm) {
+		BM_mesh_free(me->dim_bm);
+		me->dim_bm = NULL;
+	}
+}
+
+static bool dimensions_cache_valid(Mesh *me, BMesh *bm)
+{
+	if ((bm->totvert != me->totvert) ||
+	    (bm->totedge != me->totedge) ||
+	    (bm->totface != me->totpoly) ||
+	    (bm->totloop != me->totloop) ||
+	    (bm->totdim != me->totdim))
+	{
+		return false;
+	}
+
+	// Same counts don't mean same topology, edits may link elements to other vertices
+	BM_mesh_elem_index_ensure(bm, BM_VERT);
+	BM_mesh_elem_table_ensure(bm, BM_EDGE | BM_FACE | BM_DIM);
+	for (int i = 0; i < me->totdim; i++) {
+		BMDim *edm = bm->dtable[i];
+		MDim *mdim = me->mdim[i];
+
+		if ((edm->mdim != mdim) || (edm->totverts != mdim->totverts)) {
+			return false;
+		}
+		for (int j = 0; j < mdim->totverts; j++) {
+			if (BM_elem_index_get(edm->v[j]) != (int)mdim->v[j]) {
+				return false;
+			}
+		}
+	}
+	for (int i = 0; i < me->totedge; i++) {
+		BMEdge *eed = bm->etable[i];
+		if ((BM_elem_index_get(eed->v1) != (int)me->medge[i].v1) ||
+		    (BM_elem_index_get(eed->v2) != (int)me->medge[i].v2))
+		{
+			return false;
+		}
+	}
+	for (int i = 0; i < me->totpoly; i++) {
+		const MPoly *mp = &me->mpoly[i];
+		const MLoop *ml = &me->mloop[mp->loopstart];
+		BMFace *efa = bm->ftable[i];
+		BMLoop *l_iter, *l_first;
+
+		if (efa->len != mp->totloop) {
+			return false;
+		}
+		l_iter = l_first = BM_FACE_FIRST_LOOP(efa);
+		do {
+			if (BM_elem_index_get(l_iter->v) != (int)(ml++)->v) {
+				return false;
+			}
+		} while ((l_iter = l_iter->next) != l_first);
+	}
+	return true;
+}
+
+/**
+ * \param moved_verts Collects vertices moved on the mesh since the last update, all of them
+ * when the BMesh is created, as their normals are copied back too.
+ */
+static BMesh *dimensions_cache_ensure(Object *ob, GSet *moved_verts)
+{
+	Mesh *me = ob->data;
+	BMVert *eve;
+	BMIter iter;
+	bool changed = false;
+	int i;
+
+	if (me->dim_bm && !dimensions_cache_valid(me, me->dim_bm)) {
+		mesh_dimensions_driven_cache_free(me);
+	}
+
+	if (me->dim_bm == NULL) {
+		if (UNLIKELY(!me->mpoly && me->totface)) {
+			BKE_mesh_convert_mfaces_to_mpolys(me);
+		}
+		me->dim_bm = BKE_mesh_to_bmesh(me, ob, false, &((struct BMeshCreateParams){.use_toolflags = true,}));
+		// Needed for Auto-constraints
+		BM_mesh_normals_update(me->dim_bm);
+		// Normals of the mesh are not known to match its vertices
+		BM_ITER_MESH (eve, &iter, me->dim_bm, BM_VERTS_OF_MESH) {
+			BLI_gset_add(moved_verts, eve);
+		}
+		return me->dim_bm;
+	}
+
+	// Vertices may be moved without bmesh (python, sculpt)
+	BM_ITER_MESH_INDEX (eve, &iter, me->dim_bm, BM_VERTS_OF_MESH, i) {
+		if (!equals_v3v3(eve->co, me->mvert[i].co)) {
+			copy_v3_v3(eve->co, me->mvert[i].co);
+			BLI_gset_add(moved_verts, eve);
+			changed = true;
+		}
+	}
+	if (changed) {
+		BM_mesh_normals_update(me->dim_bm);
+	}
+
+	return me->dim_bm;
+}
+
+/**
+ * Applies changed values of driven dimensions to the mesh.
+ *
+ * \return false when the mesh has shape keys, not supported out of edit mode.
+ */
+bool mesh_dimensions_driven_update(Scene *scene, Object *ob)
+{
+	Mesh *me = ob->data;
+	BMesh *bm;
+	BMDim **dims;
+	GSet *moved_verts;
+	GSetIterator gs_iter;
+	int *pending;
+	int pending_tot = 0;
+	int i;
+
+	if (me->key) {
+		return false;
+	}
+
+	// Changed values, found before building the BMesh as it updates dimension data
+	pending = MEM_mallocN(sizeof(*pending) * me->totdim, __func__);
+	for (i = 0; i < me->totdim; i++) {
+		MDim *mdim = me->mdim[i];
+		if (mdim->adt && (mdim->value != mdim->value_pr)) {
+			pending[pending_tot++] = i;
+		}
+	}
+
+	if (pending_tot == 0) {
+		MEM_freeN(pending);
+		return true;
+	}
+
+	moved_verts = BLI_gset_ptr_new(__func__);
+	bm = dimensions_cache_ensure(ob, moved_verts);
+	BM_mesh_elem_table_ensure(bm, BM_DIM);
+
+	dims = MEM_mallocN(sizeof(*dims) * pending_tot, __func__);
+	for (i = 0; i < pending_tot; i++) {
+		dims[i] = bm->dtable[pending[i]];
+		// Measured from current vertices
+		dimension_data_update(bm, dims[i], scene);
+	}
+
+	apply_dimension_values_ex(bm, dims, pending_tot, scene->toolsettings->dimension_constraints, scene,
+	                          moved_verts);
+
+	for (i = 0; i < bm->totdim; i++) {
+		dimension_data_update_check(bm, bm->dtable[i], scene);
+	}
+
+	// Only coordinates of moved vertices change, and normals of vertices on its faces
+	BM_mesh_elem_index_ensure(bm, BM_VERT);
+	GSET_ITER (gs_iter, moved_verts) {
+		BMVert *eve = BLI_gsetIterator_getKey(&gs_iter);
+		BMFace *f;
+		BMIter iter;
+
+		copy_v3_v3(me->mvert[BM_elem_index_get(eve)].co, eve->co);
+		normal_float_to_short_v3(me->mvert[BM_elem_index_get(eve)].no, eve->no);
+		BM_ITER_ELEM (f, &iter, eve, BM_FACES_OF_VERT) {
+			BMLoop *l_iter, *l_first;
+			l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+			do {
+				normal_float_to_short_v3(me->mvert[BM_elem_index_get(l_iter->v)].no, l_iter->v->no);
+			} while ((l_iter = l_iter->next) != l_first);
+		}
+	}
+
+	BLI_gset_free(moved_verts, NULL);
+	MEM_freeN(dims);
+	MEM_freeN(pending);
+
+	return true;
+}
@@ -18,8 +18,27 @@
 #include "mechanical_utils.h"
 
 
-void reference_plane_matrix (BMReference *erf, float mat[3][3]) {
-	float x[3],y[3],z[3];
+/**
+ * \return frame of \a erf, computed again only when its points have changed since last call.
+ */
+const BMReferenceFrame *reference_frame_get(BMReference *erf)
+{
+	BMReferenceFrame *frame = &erf->frame;
+	float x[3], y[3], z[3];
+	float mat[3][3], imat[3][3];
+
+	if (frame->valid &&
+	    equals_v3v3(frame->co[0], erf->v1) && equals_v3v3(frame->co[1], erf->v2) &&
+	    equals_v3v3(frame->co[2], erf->v3) && equals_v3v3(frame->co[3], erf->v4))
+	{
+		return frame;
+	}
+
+	copy_v3_v3(frame->co[0], erf->v1);
+	copy_v3_v3(frame->co[1], erf->v2);
+	copy_v3_v3(frame->co[2], erf->v3);
+	copy_v3_v3(frame->co[3], erf->v4);
+
 	sub_v3_v3v3(x, erf->v2, erf->v1);
 	v_perpendicular_to_axis(y,erf->v1,erf->v3,x);
 	cross_v3_v3v3(z,x,y);
@@ -27,8 +46,31 @@ void reference_plane_matrix (BMReference *erf, float mat[3][3]) {
 	copy_v3_v3(mat[0],x);
 	copy_v3_v3(mat[1],y);
 	copy_v3_v3(mat[2],z);
-
 	normalize_m3(mat);
+	copy_m3_m3(frame->mat, mat);
+	// Orthonormal, unless points are degenerated
+	if (!invert_m3_m3(imat, mat)) {
+		transpose_m3_m3(imat, mat);
+	}
+	copy_m3_m3(frame->imat, imat);
+
+	normal_tri_v3(frame->no, erf->v1, erf->v2, erf->v3);
+
+	zero_v3(frame->origin);
+	add_v3_v3(frame->origin, erf->v1);
+	add_v3_v3(frame->origin, erf->v2);
+	add_v3_v3(frame->origin, erf->v3);
+	add_v3_v3(frame->origin, erf->v4);
+	mul_v3_fl(frame->origin, 0.25f);
+
+	frame->size = len_v3v3(erf->v1, erf->v3);
+	frame->valid = true;
+
+	return frame;
+}
+
+void reference_plane_matrix (BMReference *erf, float mat[3][3]) {
+	copy_m3_m3(mat, (float (*)[3])reference_frame_get(erf)->mat);
 }
 
 bool reference_plane_project_input (Object *ob, BMReference *erf, ARegion *ar, View3D *v3d, const int mval[2], float r_co[3]) {
@@ -67,7 +109,7 @@ bool reference_plane_project_input (Object *ob, BMReference *erf, ARegion *ar, V
 		 * away ray_start values (as returned in case of ortho view3d).
 		 */
 		madd_v3_v3v3fl(ray_start_local, ray_org_local, ray_normal_local,
-		               -len_v3v3(erf->v1, erf->v3));
+		               -reference_frame_get(erf)->size);
 	}
 
 
@@ -84,17 +126,52 @@ bool reference_plane_project_input (Object *ob, BMReference *erf, ARegion *ar, V
 }
 
 void reference_plane_normal(BMReference *erf, float *r) {
-	normal_tri_v3(r, erf->v1, erf->v2, erf->v3);
+	copy_v3_v3(r, reference_frame_get(erf)->no);
 }
 
 void reference_plane_origin(BMReference *erf, float *origin) {
-	float median[3]={0};
-	add_v3_v3(median, erf->v1);
-	add_v3_v3(median, erf->v2);
-	add_v3_v3(median, erf->v3);
-	add_v3_v3(median, erf->v4);
-	mul_v3_v3fl(origin,median,0.25);
+	copy_v3_v3(origin, reference_frame_get(erf)->origin);
 }
 
+/**
+ * Projects \a tot points of \a co on \a erf, to its plane or to its line for an axis.
+ * \a r_co may be \a co.
+ */
+void reference_project_v3_array(BMReference *erf, const float (*co)[3], float (*r_co)[3], const int tot)
+{
+	const BMReferenceFrame *frame = reference_frame_get(erf);
+	const float *p0 = frame->co[0];
+	int i;
+
+	if (erf->type == BM_REFERENCE_TYPE_AXIS) {
+		const float *dir = frame->mat[0];
+		for (i = 0; i < tot; i++) {
+			float v[3];
+			sub_v3_v3v3(v, co[i], p0);
+			madd_v3_v3v3fl(r_co[i], p0, dir, dot_v3v3(v, dir));
+		}
+	}
+	else {
+		const float *no = frame->no;
+		for (i = 0; i < tot; i++) {
+			float v[3];
+			sub_v3_v3v3(v, co[i], p0);
+			madd_v3_v3v3fl(r_co[i], co[i], no, -dot_v3v3(v, no));
+		}
+	}
+}
 
-
+/**
+ * Points of \a co in \a erf local space, origin at its median and axes as #reference_plane_matrix,
+ * the third component is the distance to the plane.
+ */
+void reference_to_local_v3_array(BMReference *erf, const float (*co)[3], float (*r_co)[3], const int tot)
+{
+	const BMReferenceFrame *frame = reference_frame_get(erf);
+
+	for (int i = 0; i < tot; i++) {
+		float v[3];
+		sub_v3_v3v3(v, co[i], frame->origin);
+		mul_v3_m3v3(r_co[i], (float (*)[3])frame->imat, v);
+	}
+}
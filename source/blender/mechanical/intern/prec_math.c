@@ -11,6 +11,10 @@
 #include "prec_math.h"
 #include "math.h"
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 
 static void v_pre(int *r, const float *v) {
 
@@ -116,3 +120,67 @@ int eq_ff_prec(const float fa, const float fb)
 
 	return (a == b);
 }
+
+
+/* Batched functions
+ *
+ * Quantised vectors are stored as int[4] (last one always 0) to be compared as a whole,
+ * two points are equal for #eq_v3v3_prec when its quantised vectors are equal.
+ */
+
+/* Number of points quantised at once */
+#define PREC_ARRAY_CHUNK 256
+
+/**
+ * Same as #v_pre followed by #reduce_v3_precision, for \a tot contiguous floats.
+ */
+static void quantize_f_prec_array(int *r_q, const float *fa, const int tot)
+{
+	int i = 0;
+
+#ifdef __SSE2__
+	/* roundf: truncate, then step away from zero when the remainder reaches one half */
+	const __m128 prec = _mm_set1_ps((float)MECHANICAL_DEC_PRECISION);
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 half_neg = _mm_set1_ps(-0.5f);
+	for (; i + 4 <= tot; i += 4) {
+		const __m128 x = _mm_mul_ps(_mm_loadu_ps(&fa[i]), prec);
+		__m128i t = _mm_cvttps_epi32(x);
+		const __m128 d = _mm_sub_ps(x, _mm_cvtepi32_ps(t));
+		t = _mm_sub_epi32(t, _mm_castps_si128(_mm_cmpge_ps(d, half)));
+		t = _mm_add_epi32(t, _mm_castps_si128(_mm_cmple_ps(d, half_neg)));
+		_mm_storeu_si128((__m128i *)&r_q[i], t);
+	}
+#endif
+
+	for (; i < tot; i++) {
+		r_q[i] = (int) roundf(fa[i] * MECHANICAL_DEC_PRECISION);
+	}
+	for (i = 0; i < tot; i++) {
+		r_q[i] = reduce_f_precision(r_q[i]);
+	}
+}
+
+static void quantize_v3_prec_array_chunk(int (*r_q)[4], int *buf, const float (*fa)[3], const int tot)
+{
+	quantize_f_prec_array(buf, &fa[0][0], tot * 3);
+	for (int i = 0; i < tot; i++) {
+		r_q[i][0] = buf[i * 3];
+		r_q[i][1] = buf[i * 3 + 1];
+		r_q[i][2] = buf[i * 3 + 2];
+		r_q[i][3] = 0;
+	}
+}
+
+/**
+ * Quantises \a tot points of \a fa into \a r_q, as compared by #eq_v3v3_prec.
+ */
+void quantize_v3_prec_array(int (*r_q)[4], const float (*fa)[3], const int tot)
+{
+	int buf[PREC_ARRAY_CHUNK * 3];
+
+	for (int i = 0; i < tot; i += PREC_ARRAY_CHUNK) {
+		const int chunk = (tot - i < PREC_ARRAY_CHUNK) ? tot - i : PREC_ARRAY_CHUNK;
+		quantize_v3_prec_array_chunk(&r_q[i], buf, &fa[i], chunk);
+	}
+}
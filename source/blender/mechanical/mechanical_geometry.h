@@ -21,10 +21,21 @@ typedef struct test_circle_data {
 }test_circle_data;
 
 void mechanical_update_mesh_geometry(BMesh *bm);
+void mechanical_update_mesh_geometry_ex(BMesh *bm, const bool use_threading);
+void mechanical_update_mesh_geometry_dirty(BMesh *bm);
+void mechanical_geometry_snapshot_free(BMesh *bm);
+struct LinkNode *mechanical_geometry_of_elem(BMesh *bm, const void *ele);
+void mechanical_geometry_elem_kill(BMesh *bm, void *ele);
 void set_geometry_center (BMesh *em, float center[3]);
 
 void mechanical_clean_geometry (BMesh *bm);
 
+struct Mesh;
+unsigned int mechanical_geometry_mesh_hash(const struct Mesh *me);
+void mechanical_geometry_mesh_free(struct Mesh *me);
+void mechanical_geometry_to_mesh(BMesh *bm, struct Mesh *me);
+bool mechanical_geometry_from_mesh(BMesh *bm, const struct Mesh *me, BMVert **vtable, BMEdge **etable);
+
 
  int get_max_geom_points(BMesh *em);
  void arc_mid_point(BMGeom *egm);
@@ -0,0 +1,17 @@
+#ifndef MECHANICAL_PLANE_INDEX_H
+#define MECHANICAL_PLANE_INDEX_H
+/*
+ * Planar region index, faces grouped by normal and vertices by offset along a direction,
+ * used by dimension plane constraints (tag_vertexs_on_coplanar_faces, tag_vertexs_on_plane).
+ *
+ * Built on first use and kept on the BMesh until a normals update or a vertex/face removal,
+ * moves done applying dimensions are updated on the index. Other coordinate changes aren't
+ * tracked, so applying dimensions frees it on entry and it is only reused within one apply.
+*/
+
+void mechanical_plane_index_free(BMesh *bm);
+
+void mechanical_plane_index_vert_moved(BMesh *bm, BMVert *v);
+void mechanical_plane_index_normals_update(BMesh *bm);
+
+#endif //MECHANICAL_PLANE_INDEX_H
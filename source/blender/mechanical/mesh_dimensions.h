@@ -15,8 +15,13 @@
 
 #include "DNA_scene_types.h"
 
+struct GSet;
 
 void apply_dimension_value(BMesh *bm, BMDim *edm, float value, ToolSettings *ts);
+int get_pending_dimensions(BMesh *bm, BMDim ***r_dims);
+void apply_dimension_values(BMesh *bm, BMDim **dims, const int tot, const int constraints_default, Scene *scene);
+void apply_dimension_values_ex(BMesh *bm, BMDim **dims, const int tot, const int constraints_default,
+                               Scene *scene, struct GSet *r_moved_verts);
 void apply_dimension_direction_value(BMVert *va, BMVert *vb, float value, float *res);
 
 float get_dimension_value(BMDim *edm);
@@ -31,6 +36,8 @@ void get_dimension_transform_orientation_plane (float normal[3], BMDim *edm, Sce
 void get_dimension_transform_orientation_matrix (float mat[][3], BMDim *edm, Scene *scene);
 
 void dimension_data_update(BMesh *bm, BMDim *edm, Scene *scene);
+void dimension_data_update_array(BMesh *bm, BMDim **dims, const int tot);
+bool dimension_data_update_check(BMesh *bm, BMDim *edm, Scene *scene);
 
 void set_dimension_center(BMDim *edm);
 
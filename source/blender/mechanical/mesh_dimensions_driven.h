@@ -0,0 +1,16 @@
+#ifndef MESH_DIMENSIONS_DRIVEN_H
+#define MESH_DIMENSIONS_DRIVEN_H
+/*
+ * Driven dimensions out of edit mode, applied on a BMesh kept on the mesh between updates
+ * instead of converting the whole mesh to edit mesh and back on every object update.
+*/
+
+struct Mesh;
+struct Object;
+struct Scene;
+
+void mesh_dimensions_driven_cache_free(struct Mesh *me);
+
+bool mesh_dimensions_driven_update(struct Scene *scene, struct Object *ob);
+
+#endif //MESH_DIMENSIONS_DRIVEN_H
@@ -7,10 +7,14 @@
 #include "DNA_screen_types.h"
 #include "DNA_object_types.h"
 
+const BMReferenceFrame *reference_frame_get(BMReference *erf);
 void reference_plane_matrix(BMReference *erf, float mat[3][3]);
 bool reference_plane_project_input (Object *ob, BMReference *erf, ARegion *ar, View3D *v3d, const int mval[2], float r_co[3]);
 void reference_plane_normal(BMReference *erf, float *r);
 void reference_plane_origin(BMReference *erf, float *origin);
 
+void reference_project_v3_array(BMReference *erf, const float (*co)[3], float (*r_co)[3], const int tot);
+void reference_to_local_v3_array(BMReference *erf, const float (*co)[3], float (*r_co)[3], const int tot);
+
 #endif //MESH_REFERENCES_H
 
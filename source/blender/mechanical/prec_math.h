@@ -22,4 +22,7 @@ int eq_v3v3_prec(const float fa[3], const float fb[3]);
 float ensure_f_prec (float f);
 void ensure_v3_prec (float f[3]);
 
+/* Batched variant, coordinates are quantised once to compare many */
+void quantize_v3_prec_array(int (*r_q)[4], const float (*fa)[3], const int tot);
+
 #endif //PREC_MATH_H
@@ -9,6 +9,7 @@ extern "C" {
 #include "MEM_guardedalloc.h"
 #include "BLI_utildefines.h"
 #include "BLI_ghash.h"
+#include "BLI_rhash.h"
 #include "BLI_rand.h"
 #include "BLI_string.h"
 #include "PIL_time_utildefines.h"
@@ -38,6 +39,16 @@ extern "C" {
 	       BLI_ghash_size(_gh), q, var, lf, pempty * 100.0, poverloaded * 100.0, bigb); \
 } void (0)
 
+#define PRINTF_RHASH_STATS(_rh) \
+{ \
+	double q, lf; \
+	int probe_max; \
+	q = BLI_rhash_calc_quality_ex((_rh), &lf, &probe_max); \
+	printf("RHash stats (%u entries):\n\t" \
+	       "Mean probe length (the lower the better): %f\n\tLoad: %f\n\tLongest probe: %d\n", \
+	       BLI_rhash_size(_rh), q, lf, probe_max); \
+} void (0)
+
 /* Str: whole text, lines and words from a 'corpus' text. */
 
 static void str_ghash_tests(GHash *ghash, const char *id)
@@ -163,6 +174,67 @@ TEST(ghash, TextMurmur2a)
 	str_ghash_tests(ghash, "StrGHash - Murmur");
 }
 
+static void str_rhash_tests(RHash *rhash, const char *id)
+{
+	printf("\n========== STARTING %s ==========\n", id);
+
+	char *data = BLI_strdup(words10k);
+	char *data_w = BLI_strdup(data);
+	char *data_bis = BLI_strdup(data);
+
+	{
+		char *w, *c_w;
+
+		TIMEIT_START(string_insert);
+
+		for (w = c_w = data_w; *c_w; c_w++) {
+			if (ELEM(*c_w, '.', ' ')) {
+				*c_w = '\0';
+				if (!BLI_rhash_haskey(rhash, w)) {
+					BLI_rhash_insert(rhash, w, SET_INT_IN_POINTER(w[0]));
+				}
+				w = c_w + 1;
+			}
+		}
+
+		TIMEIT_END(string_insert);
+	}
+
+	PRINTF_RHASH_STATS(rhash);
+
+	{
+		char *w, *c;
+		void *v;
+
+		TIMEIT_START(string_lookup);
+
+		for (w = c = data_bis; *c; c++) {
+			if (ELEM(*c, '.', ' ')) {
+				*c = '\0';
+				v = BLI_rhash_lookup(rhash, w);
+				EXPECT_EQ(GET_INT_FROM_POINTER(v), w[0]);
+				w = c + 1;
+			}
+		}
+
+		TIMEIT_END(string_lookup);
+	}
+
+	BLI_rhash_free(rhash, NULL, NULL);
+	MEM_freeN(data);
+	MEM_freeN(data_w);
+	MEM_freeN(data_bis);
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(ghash, TextRHash)
+{
+	RHash *rhash = BLI_rhash_new(BLI_ghashutil_strhash_p, BLI_ghashutil_strcmp, __func__);
+
+	str_rhash_tests(rhash, "StrGHash - RHash");
+}
+
 
 /* Int: uniform 100M first integers. */
 
@@ -253,6 +325,84 @@ TEST(ghash, IntMurmur2a100000000)
 }
 #endif
 
+static void int_rhash_tests(RHash *rhash, const char *id, const unsigned int nbr)
+{
+	printf("\n========== STARTING %s ==========\n", id);
+
+	{
+		unsigned int i = nbr;
+
+		TIMEIT_START(int_insert);
+
+#ifdef GHASH_RESERVE
+		BLI_rhash_reserve(rhash, nbr);
+#endif
+
+		while (i--) {
+			BLI_rhash_insert(rhash, SET_UINT_IN_POINTER(i), SET_UINT_IN_POINTER(i));
+		}
+
+		TIMEIT_END(int_insert);
+	}
+
+	PRINTF_RHASH_STATS(rhash);
+
+	{
+		unsigned int i = nbr;
+
+		TIMEIT_START(int_lookup);
+
+		while (i--) {
+			void *v = BLI_rhash_lookup(rhash, SET_UINT_IN_POINTER(i));
+			EXPECT_EQ(GET_UINT_FROM_POINTER(v), i);
+		}
+
+		TIMEIT_END(int_lookup);
+	}
+
+	{
+		unsigned int i = nbr;
+
+		TIMEIT_START(int_remove);
+
+		while (i--) {
+			void *v = BLI_rhash_popkey(rhash, SET_UINT_IN_POINTER(i), NULL);
+			EXPECT_EQ(GET_UINT_FROM_POINTER(v), i);
+		}
+
+		TIMEIT_END(int_remove);
+	}
+	EXPECT_EQ(BLI_rhash_size(rhash), 0);
+
+	BLI_rhash_free(rhash, NULL, NULL);
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(ghash, IntRHash12000)
+{
+	RHash *rhash = BLI_rhash_int_new(__func__);
+
+	int_rhash_tests(rhash, "IntGHash - RHash - 12000", 12000);
+}
+
+#ifdef GHASH_RUN_BIG
+TEST(ghash, IntRHash100000000)
+{
+	RHash *rhash = BLI_rhash_int_new(__func__);
+
+	int_rhash_tests(rhash, "IntGHash - RHash - 100000000", 100000000);
+}
+#endif
+
+/* Same as above, calling the hash & compare functions. */
+TEST(ghash, IntRHashCallbacks12000)
+{
+	RHash *rhash = BLI_rhash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+
+	int_rhash_tests(rhash, "IntGHash - RHash callbacks - 12000", 12000);
+}
+
 /* Int: random 50M integers. */
 
 static void randint_ghash_tests(GHash *ghash, const char *id, const unsigned int nbr)
@@ -335,6 +485,72 @@ TEST(ghash, IntRandMurmur2a50000000)
 }
 #endif
 
+static void randint_rhash_tests(RHash *rhash, const char *id, const unsigned int nbr)
+{
+	printf("\n========== STARTING %s ==========\n", id);
+
+	unsigned int *data = (unsigned int *)MEM_mallocN(sizeof(*data) * (size_t)nbr, __func__);
+	unsigned int *dt;
+	unsigned int i;
+
+	{
+		RNG *rng = BLI_rng_new(0);
+		for (i = nbr, dt = data; i--; dt++) {
+			*dt = BLI_rng_get_uint(rng);
+		}
+		BLI_rng_free(rng);
+	}
+
+	{
+		TIMEIT_START(int_insert);
+
+#ifdef GHASH_RESERVE
+		BLI_rhash_reserve(rhash, nbr);
+#endif
+
+		for (i = nbr, dt = data; i--; dt++) {
+			/* random data may have duplicates */
+			BLI_rhash_reinsert(rhash, SET_UINT_IN_POINTER(*dt), SET_UINT_IN_POINTER(*dt), NULL, NULL);
+		}
+
+		TIMEIT_END(int_insert);
+	}
+
+	PRINTF_RHASH_STATS(rhash);
+
+	{
+		TIMEIT_START(int_lookup);
+
+		for (i = nbr, dt = data; i--; dt++) {
+			void *v = BLI_rhash_lookup(rhash, SET_UINT_IN_POINTER(*dt));
+			EXPECT_EQ(GET_UINT_FROM_POINTER(v), *dt);
+		}
+
+		TIMEIT_END(int_lookup);
+	}
+
+	BLI_rhash_free(rhash, NULL, NULL);
+	MEM_freeN(data);
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(ghash, IntRandRHash12000)
+{
+	RHash *rhash = BLI_rhash_int_new(__func__);
+
+	randint_rhash_tests(rhash, "RandIntGHash - RHash - 12000", 12000);
+}
+
+#ifdef GHASH_RUN_BIG
+TEST(ghash, IntRandRHash50000000)
+{
+	RHash *rhash = BLI_rhash_int_new(__func__);
+
+	randint_rhash_tests(rhash, "RandIntGHash - RHash - 50000000", 50000000);
+}
+#endif
+
 static unsigned int ghashutil_tests_nohash_p(const void *p)
 {
 	return GET_UINT_FROM_POINTER(p);
@@ -447,6 +663,74 @@ TEST(ghash, Int4Murmur2a20000000)
 }
 #endif
 
+static void int4_rhash_tests(RHash *rhash, const char *id, const unsigned int nbr)
+{
+	printf("\n========== STARTING %s ==========\n", id);
+
+	void *data_v = MEM_mallocN(sizeof(unsigned int[4]) * (size_t)nbr, __func__);
+	unsigned int (*data)[4] = (unsigned int (*)[4])data_v;
+	unsigned int (*dt)[4];
+	unsigned int i, j;
+
+	{
+		RNG *rng = BLI_rng_new(0);
+		for (i = nbr, dt = data; i--; dt++) {
+			for (j = 4; j--; ) {
+				(*dt)[j] = BLI_rng_get_uint(rng);
+			}
+		}
+		BLI_rng_free(rng);
+	}
+
+	{
+		TIMEIT_START(int_v4_insert);
+
+#ifdef GHASH_RESERVE
+		BLI_rhash_reserve(rhash, nbr);
+#endif
+
+		for (i = nbr, dt = data; i--; dt++) {
+			BLI_rhash_insert(rhash, *dt, SET_UINT_IN_POINTER(i));
+		}
+
+		TIMEIT_END(int_v4_insert);
+	}
+
+	PRINTF_RHASH_STATS(rhash);
+
+	{
+		TIMEIT_START(int_v4_lookup);
+
+		for (i = nbr, dt = data; i--; dt++) {
+			void *v = BLI_rhash_lookup(rhash, (void *)(*dt));
+			EXPECT_EQ(GET_UINT_FROM_POINTER(v), i);
+		}
+
+		TIMEIT_END(int_v4_lookup);
+	}
+
+	BLI_rhash_free(rhash, NULL, NULL);
+	MEM_freeN(data);
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(ghash, Int4RHash2000)
+{
+	RHash *rhash = BLI_rhash_new(BLI_ghashutil_uinthash_v4_p, BLI_ghashutil_uinthash_v4_cmp, __func__);
+
+	int4_rhash_tests(rhash, "Int4GHash - RHash - 2000", 2000);
+}
+
+#ifdef GHASH_RUN_BIG
+TEST(ghash, Int4RHash20000000)
+{
+	RHash *rhash = BLI_rhash_new(BLI_ghashutil_uinthash_v4_p, BLI_ghashutil_uinthash_v4_cmp, __func__);
+
+	int4_rhash_tests(rhash, "Int4GHash - RHash - 20000000", 20000000);
+}
+#endif
+
 /* MultiSmall: create and manipulate a lot of very small ghashes (90% < 10 items, 9% < 100 items, 1% < 1000 items). */
 
 static void multi_small_ghash_tests_one(GHash *ghash, RNG *rng, const unsigned int nbr)
@@ -534,3 +818,66 @@ TEST(ghash, MultiRandIntMurmur2a200000)
 
 	multi_small_ghash_tests(ghash, "MultiSmall RandIntGHash - Murmur2a - 200000", 200000);
 }
+
+static void multi_small_rhash_tests_one(RHash *rhash, RNG *rng, const unsigned int nbr)
+{
+	unsigned int *data = (unsigned int *)MEM_mallocN(sizeof(*data) * (size_t)nbr, __func__);
+	unsigned int *dt;
+	unsigned int i;
+
+	for (i = nbr, dt = data; i--; dt++) {
+		*dt = BLI_rng_get_uint(rng);
+	}
+
+#ifdef GHASH_RESERVE
+	BLI_rhash_reserve(rhash, nbr);
+#endif
+
+	for (i = nbr, dt = data; i--; dt++) {
+		BLI_rhash_reinsert(rhash, SET_UINT_IN_POINTER(*dt), SET_UINT_IN_POINTER(*dt), NULL, NULL);
+	}
+
+	for (i = nbr, dt = data; i--; dt++) {
+		void *v = BLI_rhash_lookup(rhash, SET_UINT_IN_POINTER(*dt));
+		EXPECT_EQ(GET_UINT_FROM_POINTER(v), *dt);
+	}
+
+	BLI_rhash_clear(rhash, NULL, NULL);
+	MEM_freeN(data);
+}
+
+static void multi_small_rhash_tests(RHash *rhash, const char *id, const unsigned int nbr)
+{
+	printf("\n========== STARTING %s ==========\n", id);
+
+	RNG *rng = BLI_rng_new(0);
+
+	TIMEIT_START(multi_small_rhash);
+
+	unsigned int i = nbr;
+	while (i--) {
+		const int nbr = 1 + (BLI_rng_get_int(rng) % TESTCASE_SIZE_SMALL) * (!(i % 100) ? 100 : (!(i % 10) ? 10 : 1));
+		multi_small_rhash_tests_one(rhash, rng, nbr);
+	}
+
+	TIMEIT_END(multi_small_rhash);
+
+	BLI_rhash_free(rhash, NULL, NULL);
+	BLI_rng_free(rng);
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(ghash, MultiRandIntRHash2000)
+{
+	RHash *rhash = BLI_rhash_int_new(__func__);
+
+	multi_small_rhash_tests(rhash, "MultiSmall RandIntGHash - RHash - 2000", 2000);
+}
+
+TEST(ghash, MultiRandIntRHash200000)
+{
+	RHash *rhash = BLI_rhash_int_new(__func__);
+
+	multi_small_rhash_tests(rhash, "MultiSmall RandIntGHash - RHash - 200000", 200000);
+}
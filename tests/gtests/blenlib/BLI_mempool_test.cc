@@ -0,0 +1,119 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_mempool.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
+}
+
+#define TESTCASE_SIZE 100000
+#define MEMPOOL_TEST_THREADS 8
+
+typedef struct MempoolTestElem {
+	int index;
+	int thread_id;
+} MempoolTestElem;
+
+typedef struct MempoolTestData {
+	BLI_mempool *pool;
+	MempoolTestElem **elems;
+} MempoolTestData;
+
+static void mempool_alloc_cb(void *userdata, void *UNUSED(userdata_chunk), const int iter, const int thread_id)
+{
+	MempoolTestData *data = (MempoolTestData *)userdata;
+	MempoolTestElem *elem = (MempoolTestElem *)BLI_mempool_alloc_thread(data->pool, thread_id);
+
+	elem->index = iter;
+	elem->thread_id = thread_id;
+	data->elems[iter] = elem;
+}
+
+static void mempool_free_cb(void *userdata, void *UNUSED(userdata_chunk), const int iter, const int thread_id)
+{
+	MempoolTestData *data = (MempoolTestData *)userdata;
+
+	/* Free every second element, often from another thread than the one that allocated it. */
+	if (iter % 2) {
+		BLI_mempool_free_thread(data->pool, data->elems[iter], thread_id);
+		data->elems[iter] = NULL;
+	}
+}
+
+/* Elements allocated from all threads are iterated once each, with the values they were given. */
+static void mempool_concurrent_test(const unsigned int totelem_reserve)
+{
+	MempoolTestData data;
+	BLI_mempool_iter iter;
+	MempoolTestElem *elem;
+	int *found = (int *)MEM_callocN(sizeof(*found) * TESTCASE_SIZE, __func__);
+	int i, num_threads, count;
+
+	/* Before the global scheduler is created, so there are several threads on any machine. */
+	BLI_system_num_threads_override_set(MEMPOOL_TEST_THREADS);
+	BLI_threadapi_init();
+	num_threads = BLI_task_scheduler_num_threads(BLI_task_scheduler_get());
+
+	data.pool = BLI_mempool_create(sizeof(MempoolTestElem), 0, 512, BLI_MEMPOOL_ALLOW_ITER);
+	data.elems = (MempoolTestElem **)MEM_mallocN(sizeof(*data.elems) * TESTCASE_SIZE, __func__);
+
+	/* Free elements from before are handed over too. */
+	elem = (MempoolTestElem *)BLI_mempool_alloc(data.pool);
+	BLI_mempool_free(data.pool, BLI_mempool_alloc(data.pool));
+	elem->index = -1;
+
+	BLI_mempool_concurrent_begin(data.pool, (unsigned int)num_threads, totelem_reserve);
+	BLI_task_parallel_range_ex(0, TESTCASE_SIZE, &data, NULL, 0, mempool_alloc_cb, true, false);
+	BLI_task_parallel_range_ex(0, TESTCASE_SIZE, &data, NULL, 0, mempool_free_cb, true, false);
+	BLI_mempool_concurrent_end(data.pool);
+
+	EXPECT_EQ(BLI_mempool_count(data.pool), TESTCASE_SIZE / 2 + 1);
+
+	count = 0;
+	BLI_mempool_iternew(data.pool, &iter);
+	while ((elem = (MempoolTestElem *)BLI_mempool_iterstep(&iter))) {
+		if (elem->index != -1) {
+			ASSERT_TRUE(elem->index >= 0 && elem->index < TESTCASE_SIZE);
+			EXPECT_EQ(data.elems[elem->index], elem);
+			EXPECT_TRUE(elem->thread_id >= 0 && elem->thread_id < num_threads);
+			found[elem->index]++;
+		}
+		count++;
+	}
+	EXPECT_EQ(count, TESTCASE_SIZE / 2 + 1);
+
+	for (i = 0; i < TESTCASE_SIZE; i++) {
+		EXPECT_EQ(found[i], (i % 2) ? 0 : 1);
+	}
+
+	/* Freed elements are reused by the regular allocator afterwards. */
+	for (i = 0; i < TESTCASE_SIZE / 2; i++) {
+		elem = (MempoolTestElem *)BLI_mempool_alloc(data.pool);
+		elem->index = -1;
+	}
+	EXPECT_EQ(BLI_mempool_count(data.pool), TESTCASE_SIZE + 1);
+
+	BLI_mempool_destroy(data.pool);
+	MEM_freeN(data.elems);
+	MEM_freeN(found);
+}
+
+TEST(mempool, ConcurrentAlloc)
+{
+	mempool_concurrent_test(0);
+}
+
+TEST(mempool, ConcurrentAllocReserve)
+{
+	mempool_concurrent_test(TESTCASE_SIZE);
+}
+
+TEST(mempool, ConcurrentAllocReserveUnused)
+{
+	/* More chunks reserved than used, the remaining ones only hold free elements. */
+	mempool_concurrent_test(TESTCASE_SIZE * 3);
+}
@@ -0,0 +1,177 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#define GHASH_INTERNAL_API
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_rhash.h"
+#include "BLI_string.h"
+}
+
+#define TESTCASE_SIZE 10000
+
+/* Unique keys, multiplying by an odd number never collides. */
+static void init_keys(unsigned int keys[TESTCASE_SIZE], const unsigned int seed)
+{
+	for (unsigned int i = 0; i < TESTCASE_SIZE; i++) {
+		keys[i] = (i + seed) * 2654435761u;
+	}
+}
+
+/* Here we simply insert and then lookup all keys, ensuring we do get back the expected stored 'data'. */
+TEST(rhash, InsertLookup)
+{
+	RHash *rhash = BLI_rhash_int_new(__func__);
+	unsigned int keys[TESTCASE_SIZE], *k;
+	int i;
+
+	init_keys(keys, 0);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		BLI_rhash_insert(rhash, SET_UINT_IN_POINTER(*k), SET_UINT_IN_POINTER(*k));
+	}
+
+	EXPECT_EQ(BLI_rhash_size(rhash), TESTCASE_SIZE);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		void *v = BLI_rhash_lookup(rhash, SET_UINT_IN_POINTER(*k));
+		EXPECT_EQ(GET_UINT_FROM_POINTER(v), *k);
+	}
+
+	BLI_rhash_free(rhash, NULL, NULL);
+}
+
+/* Here we insert all keys, then remove every second one, checking the other ones are still found. */
+TEST(rhash, InsertRemove)
+{
+	RHash *rhash = BLI_rhash_ptr_new(__func__);
+	unsigned int keys[TESTCASE_SIZE];
+	int i;
+
+	init_keys(keys, 10);
+
+	for (i = 0; i < TESTCASE_SIZE; i++) {
+		BLI_rhash_insert(rhash, SET_UINT_IN_POINTER(keys[i]), SET_UINT_IN_POINTER(keys[i]));
+	}
+
+	for (i = 0; i < TESTCASE_SIZE; i += 2) {
+		void *v = BLI_rhash_popkey(rhash, SET_UINT_IN_POINTER(keys[i]), NULL);
+		EXPECT_EQ(GET_UINT_FROM_POINTER(v), keys[i]);
+	}
+
+	EXPECT_EQ(BLI_rhash_size(rhash), TESTCASE_SIZE / 2);
+
+	for (i = 0; i < TESTCASE_SIZE; i++) {
+		void **v_p = BLI_rhash_lookup_p(rhash, SET_UINT_IN_POINTER(keys[i]));
+		if (i % 2) {
+			ASSERT_TRUE(v_p != NULL);
+			EXPECT_EQ(GET_UINT_FROM_POINTER(*v_p), keys[i]);
+		}
+		else {
+			EXPECT_TRUE(v_p == NULL);
+		}
+	}
+
+	for (i = 1; i < TESTCASE_SIZE; i += 2) {
+		EXPECT_TRUE(BLI_rhash_remove(rhash, SET_UINT_IN_POINTER(keys[i]), NULL, NULL));
+		EXPECT_FALSE(BLI_rhash_haskey(rhash, SET_UINT_IN_POINTER(keys[i])));
+	}
+
+	EXPECT_EQ(BLI_rhash_size(rhash), 0);
+
+	BLI_rhash_free(rhash, NULL, NULL);
+}
+
+/* Ensure and reinsert existing keys, values are changed in place. */
+TEST(rhash, EnsureReinsert)
+{
+	RHash *rhash = BLI_rhash_int_new(__func__);
+	unsigned int keys[TESTCASE_SIZE];
+	void **val_p;
+	int i;
+
+	init_keys(keys, 20);
+
+	for (i = 0; i < TESTCASE_SIZE; i++) {
+		EXPECT_FALSE(BLI_rhash_ensure_p(rhash, SET_UINT_IN_POINTER(keys[i]), &val_p));
+		*val_p = SET_INT_IN_POINTER(i);
+	}
+	for (i = 0; i < TESTCASE_SIZE; i++) {
+		EXPECT_TRUE(BLI_rhash_ensure_p(rhash, SET_UINT_IN_POINTER(keys[i]), &val_p));
+		EXPECT_EQ(GET_INT_FROM_POINTER(*val_p), i);
+		EXPECT_FALSE(BLI_rhash_reinsert(rhash, SET_UINT_IN_POINTER(keys[i]), SET_INT_IN_POINTER(-i), NULL, NULL));
+	}
+
+	EXPECT_EQ(BLI_rhash_size(rhash), TESTCASE_SIZE);
+
+	for (i = 0; i < TESTCASE_SIZE; i++) {
+		EXPECT_EQ(GET_INT_FROM_POINTER(BLI_rhash_lookup(rhash, SET_UINT_IN_POINTER(keys[i]))), -i);
+	}
+
+	BLI_rhash_free(rhash, NULL, NULL);
+}
+
+/* Iterate, every key is found once. */
+TEST(rhash, Iterator)
+{
+	RHash *rhash = BLI_rhash_int_new(__func__);
+	RHashIterator rh_iter;
+	unsigned int sum = 0, sum_iter = 0;
+	int i, count = 0;
+
+	for (i = 0; i < TESTCASE_SIZE; i++) {
+		BLI_rhash_insert(rhash, SET_INT_IN_POINTER(i), SET_INT_IN_POINTER(i));
+		sum += (unsigned int)i;
+	}
+
+	RHASH_ITER (rh_iter, rhash) {
+		EXPECT_EQ(BLI_rhashIterator_getKey(&rh_iter), BLI_rhashIterator_getValue(&rh_iter));
+		sum_iter += GET_UINT_FROM_POINTER(BLI_rhashIterator_getKey(&rh_iter));
+		count++;
+	}
+
+	EXPECT_EQ(count, TESTCASE_SIZE);
+	EXPECT_EQ(sum, sum_iter);
+
+	BLI_rhash_clear(rhash, NULL, NULL);
+	EXPECT_EQ(BLI_rhash_size(rhash), 0);
+
+	RHASH_ITER (rh_iter, rhash) {
+		ADD_FAILURE();
+	}
+
+	BLI_rhash_free(rhash, NULL, NULL);
+}
+
+/* Set of strings, using the hash and compare callbacks. */
+TEST(rhash, StrSet)
+{
+	RSet *rset = BLI_rset_str_new(__func__);
+	char *strs[TESTCASE_SIZE];
+	char str[32];
+	int i;
+
+	for (i = 0; i < TESTCASE_SIZE; i++) {
+		BLI_snprintf(str, sizeof(str), "key%d", i);
+		strs[i] = BLI_strdup(str);
+		EXPECT_TRUE(BLI_rset_add(rset, strs[i]));
+	}
+	for (i = 0; i < TESTCASE_SIZE; i++) {
+		BLI_snprintf(str, sizeof(str), "key%d", i);
+		EXPECT_TRUE(BLI_rset_haskey(rset, str));
+		EXPECT_FALSE(BLI_rset_add(rset, str));
+	}
+
+	EXPECT_EQ(BLI_rset_size(rset), TESTCASE_SIZE);
+
+	for (i = 0; i < TESTCASE_SIZE; i += 3) {
+		EXPECT_TRUE(BLI_rset_remove(rset, strs[i], MEM_freeN));
+	}
+	EXPECT_FALSE(BLI_rset_haskey(rset, "key0"));
+	EXPECT_TRUE(BLI_rset_haskey(rset, "key1"));
+
+	BLI_rset_free(rset, MEM_freeN);
+}
@@ -0,0 +1,250 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_math.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
+#include "PIL_time.h"
+}
+
+/* Run the longest tests! */
+//#define TASK_RUN_BIG
+
+#define TASK_MAX_THREADS 64
+
+/* Per thread results, on its own cache line. */
+typedef struct TaskThreadCount {
+	unsigned long long count;
+	unsigned long long work;
+	char pad[64 - 2 * sizeof(unsigned long long)];
+} TaskThreadCount;
+
+typedef struct TaskTestData {
+	TaskThreadCount threads[TASK_MAX_THREADS + 1];
+	/* Tasks pushed from a task, as a tree of this depth. */
+	int depth;
+	/* Iterations of dummy work of the biggest task, 0 for tiny tasks. */
+	int work_max;
+} TaskTestData;
+
+static unsigned long long task_dummy_work(const int iter, const int size)
+{
+	unsigned long long r = (unsigned long long)iter;
+	for (int i = 0; i < size; i++) {
+		r = r * 6364136223846793005ULL + 1442695040888963407ULL;
+	}
+	return r & 1;
+}
+
+static int task_work_size(const TaskTestData *data, const int iter)
+{
+	/* Mixed sizes, a few big tasks between many small ones. */
+	if (data->work_max == 0) {
+		return 0;
+	}
+	return ((iter % 16) == 0) ? data->work_max : data->work_max / 64;
+}
+
+static void task_test_run(TaskPool *__restrict pool, void *taskdata, int threadid)
+{
+	TaskTestData *data = (TaskTestData *)BLI_task_pool_userdata(pool);
+	const int iter = GET_INT_FROM_POINTER(taskdata);
+	TaskThreadCount *tc = &data->threads[threadid];
+
+	tc->count++;
+	tc->work += task_dummy_work(iter, task_work_size(data, iter));
+}
+
+static void task_test_tree_run(TaskPool *__restrict pool, void *taskdata, int threadid)
+{
+	TaskTestData *data = (TaskTestData *)BLI_task_pool_userdata(pool);
+	const int node = GET_INT_FROM_POINTER(taskdata);
+
+	/* Nodes are numbered as a heap, leaves do the work. */
+	if (node < (1 << data->depth)) {
+		BLI_task_pool_push_from_thread(pool, task_test_tree_run, SET_INT_IN_POINTER(node * 2), false,
+		                               TASK_PRIORITY_HIGH, threadid);
+		BLI_task_pool_push_from_thread(pool, task_test_tree_run, SET_INT_IN_POINTER(node * 2 + 1), false,
+		                               TASK_PRIORITY_HIGH, threadid);
+	}
+	else {
+		task_test_run(pool, taskdata, threadid);
+	}
+}
+
+static unsigned long long task_test_count(const TaskTestData *data)
+{
+	unsigned long long count = 0;
+	for (int i = 0; i <= TASK_MAX_THREADS; i++) {
+		count += data->threads[i].count;
+	}
+	return count;
+}
+
+static void task_scaling_test(const int num_tasks, const int work_max, const int depth, const char *id)
+{
+	const int threads_tot[] = {1, 2, 4, 8, 16, 32, 64};
+	double time_single = 0.0;
+
+	printf("\n========== STARTING %s ==========\n", id);
+
+	BLI_threadapi_init();
+
+	for (int t = 0; t < (int)ARRAY_SIZE(threads_tot); t++) {
+		TaskScheduler *scheduler = BLI_task_scheduler_create(threads_tot[t]);
+		TaskTestData *data = (TaskTestData *)MEM_callocN(sizeof(*data), __func__);
+		TaskPool *pool = BLI_task_pool_create(scheduler, data);
+		unsigned long long expected;
+		double time_start, time;
+
+		BLI_assert(BLI_task_scheduler_num_threads(scheduler) <= TASK_MAX_THREADS + 1);
+
+		data->depth = depth;
+		data->work_max = work_max;
+
+		time_start = PIL_check_seconds_timer();
+		if (depth) {
+			/* One tree per task, leaves are pushed from worker threads. */
+			for (int i = 0; i < num_tasks; i++) {
+				BLI_task_pool_push_from_thread(pool, task_test_tree_run, SET_INT_IN_POINTER(1), false,
+				                               TASK_PRIORITY_HIGH, 0);
+			}
+			expected = (unsigned long long)num_tasks << depth;
+		}
+		else {
+			for (int i = 0; i < num_tasks; i++) {
+				BLI_task_pool_push_from_thread(pool, task_test_run, SET_INT_IN_POINTER(i), false,
+				                               TASK_PRIORITY_HIGH, 0);
+			}
+			expected = (unsigned long long)num_tasks;
+		}
+		BLI_task_pool_work_and_wait(pool);
+		time = PIL_check_seconds_timer() - time_start;
+
+		if (t == 0) {
+			time_single = time;
+		}
+		printf("%2d threads: %.6f seconds, %.0f tasks/second, speedup %.2f\n",
+		       threads_tot[t], time,
+		       time > 0.0 ? (double)expected / time : 0.0, time > 0.0 ? time_single / time : 0.0);
+
+		EXPECT_EQ(expected, task_test_count(data));
+
+		BLI_task_pool_free(pool);
+		BLI_task_scheduler_free(scheduler);
+		MEM_freeN(data);
+	}
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(task, TinyTasks_100k)
+{
+	task_scaling_test(100000, 0, 0, "Tiny tasks - 100k tasks");
+}
+
+TEST(task, TinyTasksNested_100k)
+{
+	task_scaling_test(64, 0, 11, "Tiny tasks pushed from tasks - 131k tasks");
+}
+
+TEST(task, MixedTasks_10k)
+{
+	task_scaling_test(10000, 4096, 0, "Mixed size tasks - 10k tasks");
+}
+
+TEST(task, MixedTasksNested_10k)
+{
+	task_scaling_test(16, 4096, 10, "Mixed size tasks pushed from tasks - 16k tasks");
+}
+
+/* Parallel range */
+
+/* Threads of the global scheduler, used by parallel ranges. */
+#define TASK_RANGE_THREADS 8
+
+typedef struct TaskRangeTestData {
+	int *count;
+	unsigned char *work;
+	int work_max;
+} TaskRangeTestData;
+
+static void task_range_test_init(void)
+{
+	/* Before the global scheduler is created. */
+	BLI_system_num_threads_override_set(TASK_RANGE_THREADS);
+	BLI_threadapi_init();
+}
+
+static void task_range_test_cb(void *userdata, void *UNUSED(userdata_chunk), const int iter,
+                               const int UNUSED(thread_id))
+{
+	TaskRangeTestData *data = (TaskRangeTestData *)userdata;
+	const int size = ((iter % 64) == 0) ? data->work_max : data->work_max / 256;
+
+	data->count[iter]++;
+	data->work[iter] = (unsigned char)task_dummy_work(iter, size);
+}
+
+static void task_range_test(const int num_iter, const int work_max, const char *id)
+{
+	TaskRangeTestData data;
+	double time_start, time_static, time_dynamic;
+	int i;
+
+	task_range_test_init();
+
+	printf("\n========== STARTING %s ==========\n", id);
+
+	data.count = (int *)MEM_callocN(sizeof(*data.count) * num_iter, __func__);
+	data.work = (unsigned char *)MEM_callocN(sizeof(*data.work) * num_iter, __func__);
+	data.work_max = work_max;
+
+	time_start = PIL_check_seconds_timer();
+	BLI_task_parallel_range_ex(0, num_iter, &data, NULL, 0, task_range_test_cb, true, false);
+	time_static = PIL_check_seconds_timer() - time_start;
+
+	time_start = PIL_check_seconds_timer();
+	BLI_task_parallel_range_ex(0, num_iter, &data, NULL, 0, task_range_test_cb, true, true);
+	time_dynamic = PIL_check_seconds_timer() - time_start;
+
+	printf("%d iterations, static: %.6f seconds, dynamic: %.6f seconds\n", num_iter, time_static, time_dynamic);
+
+	for (i = 0; i < num_iter; i++) {
+		if (data.count[i] != 2) {
+			break;
+		}
+	}
+	EXPECT_EQ(num_iter, i);
+
+	MEM_freeN(data.count);
+	MEM_freeN(data.work);
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(task, RangeTiny_1M)
+{
+	task_range_test(1000000, 0, "Tiny iterations - 1M iterations");
+}
+
+TEST(task, RangeMixed_100k)
+{
+	task_range_test(100000, 65536, "Mixed cost iterations - 100k iterations");
+}
+
+#ifdef TASK_RUN_BIG
+TEST(task, TinyTasks_10M)
+{
+	task_scaling_test(10000000, 0, 0, "Tiny tasks - 10M tasks");
+}
+
+TEST(task, MixedTasksNested_1M)
+{
+	task_scaling_test(256, 4096, 12, "Mixed size tasks pushed from tasks - 1M tasks");
+}
+#endif
@@ -0,0 +1,228 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_math.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
+}
+
+/* Threads of the global scheduler, used by parallel ranges. */
+#define TASK_RANGE_THREADS 8
+
+static void task_range_test_init(void)
+{
+	/* Before the global scheduler is created. */
+	BLI_system_num_threads_override_set(TASK_RANGE_THREADS);
+	BLI_threadapi_init();
+}
+
+/* Parallel range */
+
+static void task_range_count_cb(void *userdata, void *UNUSED(userdata_chunk), const int iter,
+                                const int UNUSED(thread_id))
+{
+	int *count = (int *)userdata;
+	count[iter]++;
+}
+
+static void task_range_test(const int num_iter)
+{
+	int *count = (int *)MEM_callocN(sizeof(*count) * num_iter, __func__);
+
+	BLI_task_parallel_range_ex(0, num_iter, count, NULL, 0, task_range_count_cb, true, false);
+	BLI_task_parallel_range_ex(0, num_iter, count, NULL, 0, task_range_count_cb, true, true);
+
+	for (int i = 0; i < num_iter; i++) {
+		EXPECT_EQ(2, count[i]);
+	}
+	MEM_freeN(count);
+}
+
+TEST(task, RangeSmall)
+{
+	task_range_test_init();
+
+	/* Fewer iterations than threads and than the first dynamic chunks. */
+	for (int num_iter = 1; num_iter <= 64; num_iter++) {
+		task_range_test(num_iter);
+	}
+}
+
+TEST(task, Range)
+{
+	task_range_test_init();
+
+	task_range_test(1000);
+	task_range_test(100003);
+}
+
+/* Parallel reductions */
+
+static int task_reduce_int_cb(void *UNUSED(userdata), const int iter)
+{
+	return iter % 7;
+}
+
+static float task_reduce_float_cb(void *UNUSED(userdata), const int iter)
+{
+	return (float)((iter * 37) % 1001) - 500.0f;
+}
+
+static void task_reduce_minmax_cb(void *UNUSED(userdata), const int iter, float r_min[3], float r_max[3])
+{
+	const float co[3] = {(float)iter, -(float)iter, (float)(iter % 10)};
+	minmax_v3v3_v3(r_min, r_max, co);
+}
+
+static void task_reduce_concat_cb(void *UNUSED(userdata), const int iter, TaskParallelConcat *concat)
+{
+	/* Multiples of 3, twice. */
+	if ((iter % 3) == 0) {
+		*(int *)BLI_task_parallel_concat_append(concat) = iter;
+		*(int *)BLI_task_parallel_concat_append(concat) = iter;
+	}
+}
+
+static void task_reduce_test(const int num_iter, const bool use_threading)
+{
+	int sum_i, expected_i = 0;
+	float min_f = FLT_MAX, max_f = -FLT_MAX, expected_min_f = FLT_MAX, expected_max_f = -FLT_MAX;
+	float min[3], max[3];
+	int *concat, concat_len;
+	int *concat_count;
+
+	for (int i = 0; i < num_iter; i++) {
+		expected_i += task_reduce_int_cb(NULL, i);
+		expected_min_f = min_ff(expected_min_f, task_reduce_float_cb(NULL, i));
+		expected_max_f = max_ff(expected_max_f, task_reduce_float_cb(NULL, i));
+	}
+
+	sum_i = BLI_task_parallel_range_sum_i(0, num_iter, NULL, task_reduce_int_cb, use_threading);
+	EXPECT_EQ(expected_i, sum_i);
+
+	BLI_task_parallel_range_minmax_f(0, num_iter, NULL, task_reduce_float_cb, &min_f, &max_f, use_threading);
+	EXPECT_EQ(expected_min_f, min_f);
+	EXPECT_EQ(expected_max_f, max_f);
+
+	INIT_MINMAX(min, max);
+	BLI_task_parallel_range_minmax_v3(0, num_iter, NULL, task_reduce_minmax_cb, min, max, use_threading);
+	EXPECT_EQ(0.0f, min[0]);
+	EXPECT_EQ((float)(num_iter - 1), max[0]);
+	EXPECT_EQ(-(float)(num_iter - 1), min[1]);
+	EXPECT_EQ(0.0f, max[1]);
+	EXPECT_EQ(0.0f, min[2]);
+	EXPECT_EQ(num_iter >= 10 ? 9.0f : (float)(num_iter - 1), max[2]);
+
+	concat = (int *)BLI_task_parallel_range_concat(0, num_iter, NULL, sizeof(int), task_reduce_concat_cb,
+	                                               &concat_len, use_threading);
+	EXPECT_EQ(((num_iter + 2) / 3) * 2, concat_len);
+	concat_count = (int *)MEM_callocN(sizeof(*concat_count) * num_iter, __func__);
+	for (int i = 0; i < concat_len; i += 2) {
+		/* Elements of an iteration stay together. */
+		EXPECT_EQ(concat[i], concat[i + 1]);
+		concat_count[concat[i]]++;
+	}
+	for (int i = 0; i < num_iter; i += 3) {
+		EXPECT_EQ(1, concat_count[i]);
+	}
+	MEM_freeN(concat_count);
+	if (concat) {
+		MEM_freeN(concat);
+	}
+}
+
+TEST(task, Reduce)
+{
+	task_range_test_init();
+
+	task_reduce_test(10, false);
+	task_reduce_test(10, true);
+	task_reduce_test(100000, false);
+	task_reduce_test(100000, true);
+}
+
+/* Mixed magnitudes, the sum depends on the order of additions. */
+static float task_reduce_sum_f_cb(void *UNUSED(userdata), const int iter)
+{
+	return ((iter % 97) == 0) ? 1.0e7f : 0.1f * (float)(iter % 13);
+}
+
+/* Float sums are the same threaded or not, on every run. */
+TEST(task, ReduceSumDeterministic)
+{
+	const int num_iter = 100003;
+	float sum, sum_ref;
+	double expected = 0.0;
+
+	task_range_test_init();
+
+	for (int i = 0; i < num_iter; i++) {
+		expected += (double)task_reduce_sum_f_cb(NULL, i);
+	}
+
+	sum_ref = BLI_task_parallel_range_sum_f(0, num_iter, NULL, task_reduce_sum_f_cb, false);
+	EXPECT_NEAR(expected, (double)sum_ref, expected * 1e-4);
+	for (int run = 0; run < 20; run++) {
+		sum = BLI_task_parallel_range_sum_f(0, num_iter, NULL, task_reduce_sum_f_cb, true);
+		EXPECT_EQ(sum_ref, sum);
+	}
+	EXPECT_EQ(0.0f, BLI_task_parallel_range_sum_f(0, 0, NULL, task_reduce_sum_f_cb, true));
+}
+
+/* Task pool cancel */
+
+#define TASK_CANCEL_CHILDREN 64
+
+typedef struct TaskCancelData {
+	volatile bool pushed;
+	volatile int num_run;
+} TaskCancelData;
+
+static void task_cancel_child_cb(TaskPool *__restrict pool, void *UNUSED(taskdata), int UNUSED(threadid))
+{
+	TaskCancelData *data = (TaskCancelData *)BLI_task_pool_userdata(pool);
+	data->num_run++;
+}
+
+static void task_cancel_spawn_cb(TaskPool *__restrict pool, void *UNUSED(taskdata), int threadid)
+{
+	TaskCancelData *data = (TaskCancelData *)BLI_task_pool_userdata(pool);
+
+	/* To the deque of this worker, the only one, nobody steals them while it waits. */
+	for (int i = 0; i < TASK_CANCEL_CHILDREN; i++) {
+		BLI_task_pool_push_from_thread(pool, task_cancel_child_cb, NULL, false, TASK_PRIORITY_HIGH, threadid);
+	}
+	data->pushed = true;
+
+	while (!BLI_task_pool_canceled(pool)) {
+		/* wait for the main thread to cancel */
+	}
+}
+
+/* Tasks left in the deque of another thread don't run once canceled. */
+TEST(task, PoolCancel)
+{
+	TaskScheduler *scheduler;
+	TaskPool *pool;
+	TaskCancelData data = {false, 0};
+
+	task_range_test_init();
+
+	/* Main thread and a single worker. */
+	scheduler = BLI_task_scheduler_create(2);
+	pool = BLI_task_pool_create(scheduler, &data);
+
+	BLI_task_pool_push(pool, task_cancel_spawn_cb, NULL, false, TASK_PRIORITY_HIGH);
+	while (!data.pushed) {
+		/* wait for the worker to push its tasks */
+	}
+	BLI_task_pool_cancel(pool);
+	EXPECT_EQ(0, data.num_run);
+
+	BLI_task_pool_free(pool);
+	BLI_task_scheduler_free(scheduler);
+}
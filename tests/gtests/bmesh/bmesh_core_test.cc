@@ -3,6 +3,7 @@
 #include "BLI_utildefines.h"
 #include "bmesh.h"
 #include "BLI_math.h"
+#include "BLI_memarena.h"
 
 TEST(bmesh_core, BMVertCreate) {
 	BMesh *bm;
@@ -37,3 +38,63 @@ TEST(bmesh_core, BMVertCreate) {
 	EXPECT_EQ(BM_mesh_elem_count(bm, BM_VERT), 3);
 	BM_mesh_free(bm);
 }
+
+TEST(bmesh_core, BMOpArenaReuse) {
+	BMesh *bm;
+	BMVert *verts[4];
+	BMOperator op;
+	MemArena *arena;
+	const float co[4][3] = {{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}};
+	int i;
+
+	BMeshCreateParams bm_params = {0};
+	bm_params.use_toolflags = true;
+	bm = BM_mesh_create(&bm_mesh_allocsize_default, &bm_params);
+	for (i = 0; i < 4; i++) {
+		verts[i] = BM_vert_create(bm, co[i], NULL, BM_CREATE_NOP);
+	}
+	BM_face_create_verts(bm, verts, 4, NULL, BM_CREATE_NOP, true);
+	BM_mesh_normals_update(bm);
+
+	/* each inset finishes its operator, the next one reuses the arena */
+	for (i = 0; i < 3; i++) {
+		BMO_op_initf(bm, &op, BMO_FLAG_DEFAULTS, "inset_region faces=%af use_boundary=%b thickness=%f depth=%f use_interpolate=%b",
+		             true, 0.05f, 0.1f, true);
+		BMO_op_exec(bm, &op);
+		EXPECT_EQ(BMO_slot_buffer_count(op.slots_out, "faces.out"), 4);
+		BMO_op_finish(bm, &op);
+	}
+	EXPECT_EQ(bm->totface, 13);
+
+	/* scratch memory is zeroed even from a reused arena, dirtied by the previous operator */
+	BMO_op_init(bm, &op, BMO_FLAG_DEFAULTS, "inset_region");
+	arena = op.arena;
+	{
+		int *scratch = (int *)BMO_op_scratch_alloc(&op, sizeof(int) * 1024);
+		for (i = 0; i < 1024; i++) {
+			scratch[i] = -1;
+		}
+	}
+	BMO_op_finish(bm, &op);
+
+	BMO_op_init(bm, &op, BMO_FLAG_DEFAULTS, "inset_region");
+	EXPECT_EQ(op.arena, arena);
+	{
+		int *scratch = (int *)BMO_op_scratch_calloc(&op, sizeof(int) * 1024);
+		for (i = 0; i < 1024; i++) {
+			EXPECT_EQ(scratch[i], 0);
+		}
+	}
+	/* a large buffer isn't kept after the operator finishes */
+	{
+		void *scratch = BMO_op_scratch_alloc(&op, (size_t)1 << 24);
+		EXPECT_TRUE(scratch != NULL);
+	}
+	BMO_op_finish(bm, &op);
+
+	BMO_op_init(bm, &op, BMO_FLAG_DEFAULTS, "inset_region");
+	EXPECT_LT(BLI_memarena_size_get(op.arena), (size_t)1 << 24);
+	BMO_op_finish(bm, &op);
+
+	BM_mesh_free(bm);
+}
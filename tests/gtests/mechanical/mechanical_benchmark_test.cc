@@ -0,0 +1,336 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <stdlib.h>
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_math.h"
+#include "BLI_string.h"
+#include "PIL_time.h"
+
+#include "DNA_meshdata_types.h"
+#include "DNA_scene_types.h"
+
+#include "bmesh.h"
+
+#include "mechanical_geometry.h"
+#include "mesh_dimensions.h"
+}
+
+#include "mechanical_testing.h"
+
+/* Benchmarks of the mechanical module on generated meshes, to catch performance regressions.
+ *
+ * Each measurement is printed as one line of JSON, prefixed by MECHANICAL_BENCHMARK, eg:
+ *     MECHANICAL_BENCHMARK {"benchmark": "detect_geometry", "fixture": "cylinders", "edges": 1152, ...}
+ * When MECHANICAL_BENCHMARK_FILE is set in the environment the lines are also appended to that file,
+ * without prefix.
+ */
+
+/* Run the longest tests! */
+//#define MECHANICAL_RUN_BIG
+
+static void benchmark_report(const char *benchmark, const char *fixture, const BMesh *bm,
+                             const char *extra_name, const int extra, const double seconds)
+{
+	const char *filepath = getenv("MECHANICAL_BENCHMARK_FILE");
+	char line[512];
+
+	BLI_snprintf(line, sizeof(line),
+	             "{\"benchmark\": \"%s\", \"fixture\": \"%s\", \"verts\": %d, \"edges\": %d, \"%s\": %d, "
+	             "\"seconds\": %.9f}",
+	             benchmark, fixture, bm->totvert, bm->totedge, extra_name, extra, seconds);
+
+	printf("MECHANICAL_BENCHMARK %s\n", line);
+
+	if (filepath && filepath[0]) {
+		FILE *fp = fopen(filepath, "a");
+		if (fp) {
+			fprintf(fp, "%s\n", line);
+			fclose(fp);
+		}
+	}
+}
+
+/* Fixtures */
+
+/* Square block with a through hole, top and bottom faces are quads between the hole and the
+ * block outline, sampled with the same number of segments (multiple of 8 to include corners). */
+static void bm_add_plate_tile(BMesh *bm, const int segments, const float size, const float radius,
+                              const float offset[3], const float height)
+{
+	BMVert **outer = (BMVert **)MEM_mallocN(sizeof(*outer) * segments * 2, __func__);
+	BMVert **hole = (BMVert **)MEM_mallocN(sizeof(*hole) * segments * 2, __func__);
+	BMVert *quad[4];
+	int i;
+
+	for (i = 0; i < segments; i++) {
+		const float angle = (float)(2.0 * M_PI) * (float)i / (float)segments;
+		const float c = cosf(angle), s = sinf(angle);
+		const float fac = (size * 0.5f) / max_ff(fabsf(c), fabsf(s));
+		float co_outer[3] = {c * fac, s * fac, 0.0f};
+		float co_hole[3] = {c * radius, s * radius, 0.0f};
+
+		add_v3_v3(co_outer, offset);
+		add_v3_v3(co_hole, offset);
+		outer[i] = BM_vert_create(bm, co_outer, NULL, BM_CREATE_NOP);
+		hole[i] = BM_vert_create(bm, co_hole, NULL, BM_CREATE_NOP);
+		co_outer[2] += height;
+		co_hole[2] += height;
+		outer[segments + i] = BM_vert_create(bm, co_outer, NULL, BM_CREATE_NOP);
+		hole[segments + i] = BM_vert_create(bm, co_hole, NULL, BM_CREATE_NOP);
+	}
+
+	for (i = 0; i < segments; i++) {
+		const int i_next = (i + 1) % segments;
+		for (int side = 0; side < 2; side++) {
+			const int o = side * segments;
+			// Top or bottom
+			quad[0] = outer[o + i];
+			quad[1] = outer[o + i_next];
+			quad[2] = hole[o + i_next];
+			quad[3] = hole[o + i];
+			BM_face_create_verts(bm, quad, 4, NULL, BM_CREATE_NOP, true);
+		}
+		// Outline and hole walls
+		quad[0] = outer[i];
+		quad[1] = outer[i_next];
+		quad[2] = outer[segments + i_next];
+		quad[3] = outer[segments + i];
+		BM_face_create_verts(bm, quad, 4, NULL, BM_CREATE_NOP, true);
+		quad[0] = hole[i];
+		quad[1] = hole[i_next];
+		quad[2] = hole[segments + i_next];
+		quad[3] = hole[segments + i];
+		BM_face_create_verts(bm, quad, 4, NULL, BM_CREATE_NOP, true);
+	}
+
+	MEM_freeN(outer);
+	MEM_freeN(hole);
+}
+
+/* Cylinders of 64 segments, 192 edges each. */
+static BMesh *fixture_cylinders(const int edges)
+{
+	return bm_create_cylinders(max_ii(edges / 192, 1), 64);
+}
+
+/* Hub with 8 bolts around it, 768 edges each pattern. */
+static BMesh *fixture_bolt_patterns(const int edges)
+{
+	BMesh *bm = bm_create_empty();
+	const int count = max_ii(edges / 768, 1);
+
+	for (int i = 0; i < count; i++) {
+		const float center[3] = {12.0f * (float)(i % 32), 12.0f * (float)(i / 32), 0.0f};
+		bm_add_cylinder(bm, 64, 2.0f, center, 1.0f, NULL);
+		for (int b = 0; b < 8; b++) {
+			const float angle = (float)(2.0 * M_PI) * (float)b / 8.0f;
+			float offset[3] = {4.0f * cosf(angle), 4.0f * sinf(angle), 0.0f};
+			add_v3_v3(offset, center);
+			bm_add_cylinder(bm, 24, 0.5f, offset, 3.0f, NULL);
+		}
+	}
+	BM_mesh_normals_update(bm);
+	return bm;
+}
+
+/* Plates of 4x4 tiles with a hole, 256 edges each tile. */
+static BMesh *fixture_plates_with_holes(const int edges)
+{
+	BMesh *bm = bm_create_empty();
+	const int count = max_ii(edges / (256 * 16), 1);
+
+	for (int i = 0; i < count; i++) {
+		for (int t = 0; t < 16; t++) {
+			const float offset[3] = {
+			    20.0f * (float)(i % 32) + 4.0f * (float)(t % 4),
+			    20.0f * (float)(i / 32) + 4.0f * (float)(t / 4),
+			    0.0f};
+			bm_add_plate_tile(bm, 32, 4.0f, 1.0f, offset, 0.5f);
+		}
+	}
+	BM_mesh_normals_update(bm);
+	return bm;
+}
+
+typedef BMesh *(*FixtureCreateFunc)(const int edges);
+
+typedef struct Fixture {
+	const char *name;
+	FixtureCreateFunc create;
+} Fixture;
+
+static const Fixture fixtures[] = {
+	{"cylinders", fixture_cylinders},
+	{"bolt_patterns", fixture_bolt_patterns},
+	{"plates_with_holes", fixture_plates_with_holes},
+};
+
+/* Geometry detection and snap points */
+
+static void geometry_benchmark(const int edges)
+{
+	for (int f = 0; f < (int)ARRAY_SIZE(fixtures); f++) {
+		BMesh *bm = fixtures[f].create(edges);
+		double time_start, time_delta;
+		int points;
+
+		time_start = PIL_check_seconds_timer();
+		mechanical_update_mesh_geometry(bm);
+		time_delta = PIL_check_seconds_timer() - time_start;
+		benchmark_report("detect_geometry", fixtures[f].name, bm, "geometries", bm->totgeom, time_delta);
+
+		EXPECT_GT(bm->totgeom, 0);
+
+		time_start = PIL_check_seconds_timer();
+		points = get_max_geom_points(bm);
+		time_delta = PIL_check_seconds_timer() - time_start;
+		benchmark_report("max_geom_points", fixtures[f].name, bm, "points", points, time_delta);
+
+		EXPECT_GT(points, 0);
+
+		mechanical_clean_geometry(bm);
+		BM_mesh_free(bm);
+	}
+}
+
+/* Dimension apply, one dimension of each type on the first cylinder */
+
+static const char *dim_type_names[] = {NULL, "linear", "diameter", "radius", "angle_3p", "angle_4p"};
+
+static void dimension_apply_benchmark(const int edges, const int dim_type)
+{
+	BMesh *bm = bm_create_empty();
+	const int count = max_ii(edges / 192, 1);
+	const int segments = 64;
+	MDim *mdim = (MDim *)MEM_callocN(sizeof(*mdim), __func__);
+	ToolSettings ts;
+	BMVert **verts, *v_arr[4];
+	BMDim *edm;
+	double time_start, time_delta;
+	float value;
+	int v_count;
+
+	const float origin[3] = {0.0f, 0.0f, 0.0f};
+	bm_add_cylinder(bm, segments, 1.0f, origin, 2.0f, &verts);
+	for (int i = 1; i < count; i++) {
+		const float offset[3] = {3.0f * (float)(i % 64), 3.0f * (float)(i / 64), 0.0f};
+		bm_add_cylinder(bm, segments, 1.0f, offset, 2.0f, NULL);
+	}
+	BM_mesh_normals_update(bm);
+
+	memset(&ts, 0, sizeof(ts));
+	ts.dimension_constraints = DIM_PLANE_CONSTRAINT | DIM_AXIS_CONSTRAINT;
+
+	switch (dim_type) {
+		case DIM_TYPE_LINEAR:
+			// Cylinder height, moves the top cap
+			v_arr[0] = verts[0];
+			v_arr[1] = verts[segments];
+			v_count = 2;
+			break;
+		case DIM_TYPE_DIAMETER:
+		case DIM_TYPE_RADIUS:
+			v_arr[0] = verts[0];
+			v_arr[1] = verts[segments / 3];
+			v_arr[2] = verts[2 * segments / 3];
+			v_count = 3;
+			break;
+		case DIM_TYPE_ANGLE_3P:
+			v_arr[0] = verts[0];
+			v_arr[1] = verts[1];
+			v_arr[2] = verts[2];
+			v_count = 3;
+			break;
+		case DIM_TYPE_ANGLE_4P:
+		default:
+			v_arr[0] = verts[0];
+			v_arr[1] = verts[1];
+			v_arr[2] = verts[2];
+			v_arr[3] = verts[3];
+			v_count = 4;
+			break;
+	}
+	MEM_freeN(verts);
+
+	edm = BM_dim_create(bm, v_arr, v_count, dim_type, NULL, BM_CREATE_SET_DEFAULT_DATA, mdim);
+	edm->mdim->dir = DIM_DIR_RIGHT;
+	dimension_data_update(bm, edm, NULL);
+
+	switch (dim_type) {
+		case DIM_TYPE_ANGLE_3P:
+		case DIM_TYPE_ANGLE_4P:
+			value = get_dimension_value(edm) - 1.0f;
+			break;
+		default:
+			value = get_dimension_value(edm) * 1.25f;
+			break;
+	}
+
+	time_start = PIL_check_seconds_timer();
+	apply_dimension_value(bm, edm, value, &ts);
+	dimension_data_update(bm, edm, NULL);
+	time_delta = PIL_check_seconds_timer() - time_start;
+
+	benchmark_report("apply_dimension_value", dim_type_names[dim_type], bm, "dim_type", dim_type, time_delta);
+
+	if (ELEM(dim_type, DIM_TYPE_LINEAR, DIM_TYPE_DIAMETER, DIM_TYPE_RADIUS)) {
+		EXPECT_NEAR(value, get_dimension_value(edm), 1e-4f);
+	}
+
+	BM_mesh_free(bm);
+	MEM_freeN(mdim);
+}
+
+static void dimensions_benchmark(const int edges)
+{
+	for (int dim_type = DIM_TYPE_LINEAR; dim_type <= DIM_TYPE_ANGLE_4P; dim_type++) {
+		dimension_apply_benchmark(edges, dim_type);
+	}
+}
+
+TEST(mechanical_benchmark, Geometry_1k)
+{
+	geometry_benchmark(1000);
+}
+
+TEST(mechanical_benchmark, Geometry_10k)
+{
+	geometry_benchmark(10000);
+}
+
+TEST(mechanical_benchmark, Geometry_100k)
+{
+	geometry_benchmark(100000);
+}
+
+TEST(mechanical_benchmark, Dimensions_1k)
+{
+	dimensions_benchmark(1000);
+}
+
+TEST(mechanical_benchmark, Dimensions_10k)
+{
+	dimensions_benchmark(10000);
+}
+
+TEST(mechanical_benchmark, Dimensions_100k)
+{
+	dimensions_benchmark(100000);
+}
+
+#ifdef MECHANICAL_RUN_BIG
+TEST(mechanical_benchmark, Geometry_1M)
+{
+	geometry_benchmark(1000000);
+}
+
+TEST(mechanical_benchmark, Dimensions_1M)
+{
+	dimensions_benchmark(1000000);
+}
+#endif
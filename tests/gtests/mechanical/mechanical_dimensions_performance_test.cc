@@ -0,0 +1,110 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_math.h"
+#include "PIL_time.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BKE_global.h"
+#include "BKE_library.h"
+#include "BKE_mesh.h"
+
+#include "bmesh.h"
+}
+
+#include "mechanical_testing.h"
+
+/* Run the longest tests! */
+//#define MECHANICAL_RUN_BIG
+
+static void dimensions_conversion_test(const int grid, const char *id)
+{
+	const int totdim = grid * (grid - 1);
+	MDim *mdims = (MDim *)MEM_callocN(sizeof(*mdims) * totdim, __func__);
+	Mesh *me = (Mesh *)MEM_callocN(sizeof(*me), __func__);
+	BMesh *bm = bm_create_dimension_grid(grid, mdims);
+	BMeshCreateParams bm_params = {0};
+	BMeshToMeshParams to_params = {0};
+	BMeshFromMeshParams from_params = {0};
+	BMDim *edm;
+	BMIter iter;
+	double time_start, time_to_me, time_to_me_again, time_from_me;
+	int i;
+
+	bm_params.use_toolflags = true;
+	from_params.calc_face_normal = true;
+
+	/* Converting again looks for objects parented to the mesh vertices. */
+	G.main = BKE_main_new();
+
+	printf("\n========== STARTING %s ==========\n", id);
+
+	time_start = PIL_check_seconds_timer();
+	BM_mesh_bm_to_me(bm, me, &to_params);
+	time_to_me = PIL_check_seconds_timer() - time_start;
+
+	/* Same dimensions again, as leaving edit mode a second time. */
+	time_start = PIL_check_seconds_timer();
+	BM_mesh_bm_to_me(bm, me, &to_params);
+	time_to_me_again = PIL_check_seconds_timer() - time_start;
+
+	BM_mesh_free(bm);
+	bm = BM_mesh_create(&bm_mesh_allocsize_default, &bm_params);
+
+	time_start = PIL_check_seconds_timer();
+	BM_mesh_bm_from_me(bm, me, &from_params);
+	time_from_me = PIL_check_seconds_timer() - time_start;
+
+	printf("%d dimensions\n", totdim);
+	printf("BMesh to Mesh: %.6f seconds, again: %.6f seconds\n", time_to_me, time_to_me_again);
+	printf("Mesh to BMesh: %.6f seconds: %.0f dimensions/second\n",
+	       time_from_me, time_from_me > 0.0 ? (double)totdim / time_from_me : 0.0);
+
+	EXPECT_EQ(totdim, me->totdim);
+	EXPECT_EQ(totdim, bm->totdim);
+
+	BM_mesh_elem_index_ensure(bm, BM_VERT);
+	BM_ITER_MESH_INDEX (edm, &iter, bm, BM_DIMS_OF_MESH, i) {
+		EXPECT_EQ(me->mdim[i], edm->mdim);
+		EXPECT_EQ(me->mdim[i]->v[0], BM_elem_index_get(edm->v[0]));
+		EXPECT_EQ(me->mdim[i]->v[1], BM_elem_index_get(edm->v[1]));
+	}
+
+	BM_mesh_free(bm);
+
+	for (i = 0; i < me->totdim; i++) {
+		MEM_freeN(me->mdim[i]->v);
+	}
+	MEM_freeN(me->mdim);
+	BKE_mesh_free(me);
+	MEM_freeN(me);
+	MEM_freeN(mdims);
+
+	BKE_main_free(G.main);
+	G.main = NULL;
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(mechanical_dimensions, Conversion_1k)
+{
+	dimensions_conversion_test(32, "Dimensions conversion - 1k dimensions");
+}
+
+TEST(mechanical_dimensions, Conversion_10k)
+{
+	dimensions_conversion_test(101, "Dimensions conversion - 10k dimensions");
+}
+
+#ifdef MECHANICAL_RUN_BIG
+TEST(mechanical_dimensions, Conversion_100k)
+{
+	dimensions_conversion_test(317, "Dimensions conversion - 100k dimensions");
+}
+#endif
@@ -0,0 +1,387 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_fileops.h"
+#include "BLI_math.h"
+#include "BLI_path_util.h"
+
+#include "DNA_anim_types.h"
+#include "DNA_genfile.h"
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "BKE_animsys.h"
+#include "BKE_appdir.h"
+#include "BKE_global.h"
+#include "BKE_library.h"
+#include "BKE_main.h"
+#include "BKE_mesh.h"
+
+#include "BLO_readfile.h"
+#include "BLO_writefile.h"
+
+#include "bmesh.h"
+
+#include "mesh_dimensions.h"
+#include "mesh_dimensions_driven.h"
+}
+
+#include "mechanical_testing.h"
+
+#define GRID_SIZE 8
+#define GRID_TOTDIM (GRID_SIZE * (GRID_SIZE - 1))
+
+static void mesh_dims_expect_eq(Mesh *me, BMesh *bm)
+{
+	BMDim *edm;
+	BMIter iter;
+	int i;
+
+	EXPECT_EQ(me->totdim, bm->totdim);
+
+	BM_mesh_elem_index_ensure(bm, BM_VERT);
+	BM_ITER_MESH_INDEX (edm, &iter, bm, BM_DIMS_OF_MESH, i) {
+		ASSERT_LT(i, me->totdim);
+		EXPECT_EQ(me->mdim[i], edm->mdim);
+		EXPECT_EQ(me->mdim[i]->totverts, edm->totverts);
+		EXPECT_EQ(me->mdim[i]->v[0], BM_elem_index_get(edm->v[0]));
+		EXPECT_EQ(me->mdim[i]->v[1], BM_elem_index_get(edm->v[1]));
+	}
+}
+
+static void mesh_dims_free(Mesh *me)
+{
+	for (int i = 0; i < me->totdim; i++) {
+		MEM_freeN(me->mdim[i]->v);
+	}
+	MEM_freeN(me->mdim);
+	BKE_mesh_free(me);
+	MEM_freeN(me);
+}
+
+/* Dimensions survive leaving and entering edit mode, converting again doesn't leak. */
+TEST(mechanical_dimensions, ConversionRoundTrip)
+{
+	MDim *mdims = (MDim *)MEM_callocN(sizeof(*mdims) * GRID_TOTDIM, __func__);
+	Mesh *me = (Mesh *)MEM_callocN(sizeof(*me), __func__);
+	BMesh *bm = bm_create_dimension_grid(GRID_SIZE, mdims);
+	BMeshToMeshParams to_params = {0};
+	BMeshFromMeshParams from_params = {0};
+	unsigned int blocks;
+
+	from_params.calc_face_normal = true;
+
+	/* Converting again looks for objects parented to the mesh vertices. */
+	G.main = BKE_main_new();
+
+	BM_mesh_bm_to_me(bm, me, &to_params);
+	EXPECT_EQ(GRID_TOTDIM, me->totdim);
+	mesh_dims_expect_eq(me, bm);
+
+	/* Same dimensions again, as leaving edit mode a second time. */
+	blocks = MEM_get_memory_blocks_in_use();
+	BM_mesh_bm_to_me(bm, me, &to_params);
+	EXPECT_EQ(blocks, MEM_get_memory_blocks_in_use());
+	mesh_dims_expect_eq(me, bm);
+
+	BM_mesh_free(bm);
+	bm = bm_create_empty();
+	BM_mesh_bm_from_me(bm, me, &from_params);
+	EXPECT_EQ(GRID_TOTDIM, bm->totdim);
+	mesh_dims_expect_eq(me, bm);
+
+	BM_mesh_free(bm);
+	mesh_dims_free(me);
+	MEM_freeN(mdims);
+
+	BKE_main_free(G.main);
+	G.main = NULL;
+}
+
+/* Removed dimensions free their vertex indices, kept ones are reused. */
+TEST(mechanical_dimensions, ConversionRemoved)
+{
+	MDim *mdims = (MDim *)MEM_callocN(sizeof(*mdims) * GRID_TOTDIM, __func__);
+	Mesh *me = (Mesh *)MEM_callocN(sizeof(*me), __func__);
+	BMesh *bm = bm_create_dimension_grid(GRID_SIZE, mdims);
+	BMeshToMeshParams to_params = {0};
+	BMDim *edm;
+	BMIter iter;
+	unsigned int blocks;
+	int i;
+
+	G.main = BKE_main_new();
+
+	BM_mesh_bm_to_me(bm, me, &to_params);
+
+	/* Every second dimension. */
+	BM_ITER_MESH_INDEX (edm, &iter, bm, BM_DIMS_OF_MESH, i) {
+		if (i % 2) {
+			BM_dim_kill(bm, edm);
+		}
+	}
+
+	blocks = MEM_get_memory_blocks_in_use();
+	BM_mesh_bm_to_me(bm, me, &to_params);
+	EXPECT_EQ(blocks - GRID_TOTDIM / 2, MEM_get_memory_blocks_in_use());
+	EXPECT_EQ(GRID_TOTDIM - GRID_TOTDIM / 2, me->totdim);
+	mesh_dims_expect_eq(me, bm);
+
+	BM_mesh_free(bm);
+	mesh_dims_free(me);
+	MEM_freeN(mdims);
+
+	BKE_main_free(G.main);
+	G.main = NULL;
+}
+
+/* Driven values applied out of edit mode give the same mesh than applied on a full BMesh,
+ * vertices moved without bmesh are kept. */
+TEST(mechanical_dimensions, DrivenUpdate)
+{
+	const int driven = 3 * (GRID_SIZE - 1) + 3;
+	const int moved = GRID_SIZE * GRID_SIZE - 1;
+	MDim *mdims = (MDim *)MEM_callocN(sizeof(*mdims) * GRID_TOTDIM, __func__);
+	MDim *mdims_ref = (MDim *)MEM_callocN(sizeof(*mdims_ref) * GRID_TOTDIM, __func__);
+	Mesh *me = (Mesh *)MEM_callocN(sizeof(*me), __func__);
+	Object *ob = (Object *)MEM_callocN(sizeof(*ob), __func__);
+	Scene *scene = (Scene *)MEM_callocN(sizeof(*scene), __func__);
+	AnimData *adt = (AnimData *)MEM_callocN(sizeof(*adt), __func__);
+	BMesh *bm = bm_create_dimension_grid(GRID_SIZE, mdims);
+	BMesh *bm_ref = bm_create_dimension_grid(GRID_SIZE, mdims_ref);
+	BMeshToMeshParams to_params = {0};
+	BMDim *edm;
+	BMVert *eve;
+	BMIter iter;
+	int i;
+
+	G.main = BKE_main_new();
+	scene->toolsettings = (ToolSettings *)MEM_callocN(sizeof(*scene->toolsettings), __func__);
+	scene->toolsettings->dimension_constraints = DIM_PLANE_CONSTRAINT;
+	ob->data = me;
+
+	BM_mesh_bm_to_me(bm, me, &to_params);
+	BM_mesh_free(bm);
+
+	/* First update builds the driven BMesh, second one reuses it. */
+	for (int pass = 0; pass < 2; pass++) {
+		const float value = 1.5f + (float)pass * 0.25f;
+		const float offset[3] = {0.0f, 0.0f, 0.5f};
+
+		add_v3_v3(me->mvert[moved].co, offset);
+		me->mdim[driven]->adt = adt;
+		me->mdim[driven]->value_pr = me->mdim[driven]->value;
+		me->mdim[driven]->value = value;
+		EXPECT_TRUE(mesh_dimensions_driven_update(scene, ob));
+
+		BM_mesh_elem_table_ensure(bm_ref, BM_VERT | BM_DIM);
+		add_v3_v3(bm_ref->vtable[moved]->co, offset);
+		BM_mesh_normals_update(bm_ref);
+		edm = bm_ref->dtable[driven];
+		edm->mdim->adt = adt;
+		edm->mdim->value_pr = edm->mdim->value;
+		edm->mdim->value = value;
+		dimension_data_update(bm_ref, edm, scene);
+		apply_dimension_values(bm_ref, &edm, 1, scene->toolsettings->dimension_constraints, scene);
+
+		BM_ITER_MESH_INDEX (eve, &iter, bm_ref, BM_VERTS_OF_MESH, i) {
+			short no[3];
+			normal_float_to_short_v3(no, eve->no);
+			EXPECT_V3_NEAR(eve->co, me->mvert[i].co, 1e-5f);
+			EXPECT_EQ(no[0], me->mvert[i].no[0]);
+			EXPECT_EQ(no[1], me->mvert[i].no[1]);
+			EXPECT_EQ(no[2], me->mvert[i].no[2]);
+		}
+		EXPECT_NEAR(value, len_v3v3(me->mvert[me->mdim[driven]->v[0]].co,
+		                            me->mvert[me->mdim[driven]->v[1]].co), 1e-5f);
+	}
+
+	me->mdim[driven]->adt = NULL;
+	mdims_ref[driven].adt = NULL;
+	MEM_freeN(adt);
+
+	mesh_dimensions_driven_cache_free(me);
+	BM_mesh_free(bm_ref);
+	mesh_dims_free(me);
+	MEM_freeN(mdims);
+	MEM_freeN(mdims_ref);
+	MEM_freeN(scene->toolsettings);
+	MEM_freeN(scene);
+	MEM_freeN(ob);
+
+	BKE_main_free(G.main);
+	G.main = NULL;
+}
+
+/* A dimension linked to other vertices, keeping all counts, isn't applied on the cached BMesh. */
+TEST(mechanical_dimensions, DrivenRelink)
+{
+	const int driven = 3 * (GRID_SIZE - 1) + 3;
+	MDim *mdims = (MDim *)MEM_callocN(sizeof(*mdims) * GRID_TOTDIM, __func__);
+	Mesh *me = (Mesh *)MEM_callocN(sizeof(*me), __func__);
+	Object *ob = (Object *)MEM_callocN(sizeof(*ob), __func__);
+	Scene *scene = (Scene *)MEM_callocN(sizeof(*scene), __func__);
+	AnimData *adt = (AnimData *)MEM_callocN(sizeof(*adt), __func__);
+	BMesh *bm = bm_create_dimension_grid(GRID_SIZE, mdims);
+	BMeshToMeshParams to_params = {0};
+	MDim *mdim;
+
+	G.main = BKE_main_new();
+	scene->toolsettings = (ToolSettings *)MEM_callocN(sizeof(*scene->toolsettings), __func__);
+	ob->data = me;
+
+	BM_mesh_bm_to_me(bm, me, &to_params);
+	BM_mesh_free(bm);
+	mdim = me->mdim[driven];
+	mdim->adt = adt;
+
+	for (int pass = 0; pass < 2; pass++) {
+		const float value = 1.5f - (float)pass * 0.25f;
+
+		if (pass == 1) {
+			/* To the vertex above the first one, after the first update built the cache. */
+			mdim->v[1] = mdim->v[0] + GRID_SIZE;
+		}
+		mdim->value_pr = mdim->value;
+		mdim->value = value;
+		EXPECT_TRUE(mesh_dimensions_driven_update(scene, ob));
+		EXPECT_NEAR(value, len_v3v3(me->mvert[mdim->v[0]].co, me->mvert[mdim->v[1]].co), 1e-5f);
+	}
+
+	mdim->adt = NULL;
+	MEM_freeN(adt);
+
+	mesh_dimensions_driven_cache_free(me);
+	mesh_dims_free(me);
+	MEM_freeN(mdims);
+	MEM_freeN(scene->toolsettings);
+	MEM_freeN(scene);
+	MEM_freeN(ob);
+
+	BKE_main_free(G.main);
+	G.main = NULL;
+}
+
+/* Vertices moved between two applies, without a normals update, are found on the plane
+ * of the second one. */
+TEST(mechanical_dimensions, PlaneIndexMovedVerts)
+{
+	const int dim = 2;
+	const int moved = 5 * GRID_SIZE + 6;
+	MDim *mdims = (MDim *)MEM_callocN(sizeof(*mdims) * GRID_TOTDIM, __func__);
+	BMesh *bm = bm_create_dimension_grid(GRID_SIZE, mdims);
+	BMVert *eve;
+	BMDim *edm;
+
+	BM_mesh_elem_table_ensure(bm, BM_VERT | BM_DIM);
+	edm = bm->dtable[dim];
+
+	for (int pass = 0; pass < 2; pass++) {
+		dimension_data_update(bm, edm, NULL);
+		edm->mdim->value = 1.5f + (float)pass * 0.5f;
+		apply_dimension_values(bm, &edm, 1, DIM_PLANE_CONSTRAINT, NULL);
+
+		eve = (edm->mdim->dir == DIM_DIR_LEFT) ? edm->v[0] : edm->v[1];
+		if (pass == 0) {
+			/* Onto the plane of the moving end, as a python co edit would do. */
+			bm->vtable[moved]->co[0] = eve->co[0];
+		}
+		else {
+			EXPECT_NEAR(eve->co[0], bm->vtable[moved]->co[0], 1e-5f);
+		}
+	}
+
+	BM_mesh_free(bm);
+	MEM_freeN(mdims);
+}
+
+/* Dimensions without animation are packed with the mesh, animated ones are ID blocks.
+ * Both come back in the same order after reading the file. */
+TEST(mechanical_dimensions, FileRoundTrip)
+{
+	const int animated = 5;
+	MDim *mdims = (MDim *)MEM_callocN(sizeof(*mdims) * GRID_TOTDIM, __func__);
+	BMesh *bm = bm_create_dimension_grid(GRID_SIZE, mdims);
+	BMeshToMeshParams to_params = {0};
+	char filepath[FILE_MAX];
+	BlendFileData *bfd;
+	Mesh *me, *me_read;
+	MDim *mdim_id;
+	int i;
+
+	/* As on startup, needed to write and read files. */
+	DNA_sdna_current_init();
+	BKE_tempdir_init(NULL);
+	BLI_join_dirfile(filepath, sizeof(filepath), BKE_tempdir_base(), "mechanical_dimensions_test.blend");
+
+	G.main = BKE_main_new();
+	me = BKE_mesh_add(G.main, "Mesh");
+	BM_mesh_bm_to_me(bm, me, &to_params);
+	BM_mesh_free(bm);
+
+	mdim_id = (MDim *)BKE_libblock_alloc(G.main, ID_DM, "Dimension", 0);
+	memcpy(((char *)mdim_id) + sizeof(ID), ((char *)me->mdim[animated]) + sizeof(ID), sizeof(MDim) - sizeof(ID));
+	mdim_id->v = (unsigned int *)MEM_dupallocN(me->mdim[animated]->v);
+	BKE_animdata_add_id(&mdim_id->id);
+	me->mdim[animated] = mdim_id;
+
+	ASSERT_TRUE(BLO_write_file(G.main, filepath, 0, NULL, NULL));
+	bfd = BLO_read_from_file(filepath, NULL, BLO_READ_SKIP_USERDEF);
+	ASSERT_TRUE(bfd != NULL);
+
+	me_read = (Mesh *)bfd->main->mesh.first;
+	ASSERT_TRUE(me_read != NULL);
+	EXPECT_EQ(GRID_TOTDIM, me_read->totdim);
+	EXPECT_EQ(GRID_TOTDIM - 1, me_read->totdim_pool);
+	EXPECT_EQ(NULL, me_read->mdim_pool_verts);
+	for (i = 0; i < me_read->totdim && i < me->totdim; i++) {
+		MDim *mdim = me_read->mdim[i];
+		ASSERT_TRUE(mdim != NULL);
+		ASSERT_EQ(me->mdim[i]->totverts, mdim->totverts);
+		EXPECT_EQ(me->mdim[i]->v[0], mdim->v[0]);
+		EXPECT_EQ(me->mdim[i]->v[1], mdim->v[1]);
+		EXPECT_EQ(me->mdim[i]->value, mdim->value);
+		if (i == animated) {
+			EXPECT_TRUE(mdim->adt != NULL);
+			EXPECT_EQ(bfd->main->dimensions.first, mdim);
+			EXPECT_EQ(0, mdim->id.tag & LIB_TAG_NO_MAIN);
+		}
+		else {
+			EXPECT_TRUE(mdim->adt == NULL);
+			EXPECT_EQ(&me_read->mdim_pool[i < animated ? i : i - 1], mdim);
+		}
+	}
+
+	/* A copy gets its own pool. */
+	Mesh *me_copy = BKE_mesh_copy(bfd->main, me_read);
+	ASSERT_EQ(me_read->totdim, me_copy->totdim);
+	for (i = 0; i < me_copy->totdim; i++) {
+		if (i == animated) {
+			EXPECT_EQ(me_read->mdim[i], me_copy->mdim[i]);
+		}
+		else {
+			EXPECT_EQ(&me_copy->mdim_pool[i < animated ? i : i - 1], me_copy->mdim[i]);
+		}
+	}
+
+	BLO_blendfiledata_free(bfd);
+	BLI_delete(filepath, false, false);
+
+	me->mdim[animated] = &mdims[animated];
+	for (i = 0; i < me->totdim; i++) {
+		MEM_freeN(me->mdim[i]->v);
+	}
+	MEM_SAFE_FREE(me->mdim);
+	me->totdim = 0;
+	MEM_freeN(mdims);
+
+	BKE_main_free(G.main);
+	G.main = NULL;
+	DNA_sdna_current_free();
+}
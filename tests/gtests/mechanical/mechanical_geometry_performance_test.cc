@@ -0,0 +1,205 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_math.h"
+#include "PIL_time.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BKE_mesh.h"
+
+#include "bmesh.h"
+
+#include "mechanical_geometry.h"
+}
+
+#include "mechanical_testing.h"
+
+/* Run the longest tests! */
+//#define MECHANICAL_RUN_BIG
+
+static void mechanical_detect_test(BMesh *bm, const char *id)
+{
+	double time_start, time_delta;
+
+	BM_mesh_normals_update(bm);
+
+	printf("\n========== STARTING %s ==========\n", id);
+
+	time_start = PIL_check_seconds_timer();
+	mechanical_update_mesh_geometry(bm);
+	time_delta = PIL_check_seconds_timer() - time_start;
+
+	printf("%d edges, %d geometries in %.6f seconds: %.0f edges/second\n",
+	       bm->totedge, bm->totgeom, time_delta,
+	       time_delta > 0.0 ? (double)bm->totedge / time_delta : 0.0);
+
+	EXPECT_GT(bm->totgeom, 0);
+
+	mechanical_clean_geometry(bm);
+	BM_mesh_free(bm);
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+static void cylinders_test(const int count, const int segments, const char *id)
+{
+	mechanical_detect_test(bm_create_cylinders(count, segments), id);
+}
+
+static void gears_test(const int count, const int teeth, const char *id)
+{
+	mechanical_detect_test(bm_create_gears(count, teeth), id);
+}
+
+/* Move one cylinder and only update the dirty region. */
+static void cylinders_dirty_test(const int count, const int segments, const char *id)
+{
+	BMesh *bm = bm_create_cylinders(count, segments);
+	BMVert *v;
+	BMIter iter;
+	double time_start, time_delta;
+	int totgeom, i;
+
+	printf("\n========== STARTING %s ==========\n", id);
+
+	mechanical_update_mesh_geometry(bm);
+	totgeom = bm->totgeom;
+
+	/* First cylinder verts are the first ones created. */
+	BM_ITER_MESH_INDEX (v, &iter, bm, BM_VERTS_OF_MESH, i) {
+		if (i == segments * 2) {
+			break;
+		}
+		v->co[2] += 0.5f;
+	}
+
+	time_start = PIL_check_seconds_timer();
+	mechanical_update_mesh_geometry_dirty(bm);
+	time_delta = PIL_check_seconds_timer() - time_start;
+
+	printf("%d edges, %d geometries, dirty update in %.6f seconds\n", bm->totedge, bm->totgeom, time_delta);
+
+	EXPECT_EQ(totgeom, bm->totgeom);
+
+	mechanical_clean_geometry(bm);
+	BM_mesh_free(bm);
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+/* Timing of detection on threads, see mechanical_geometry_test for the result check. */
+static void gears_threaded_test(const int count, const int teeth, const char *id)
+{
+	BMesh *bm_serial = bm_create_gears(count, teeth);
+	BMesh *bm_threaded = bm_create_gears(count, teeth);
+	double time_start, time_serial, time_threaded;
+
+	printf("\n========== STARTING %s ==========\n", id);
+
+	time_start = PIL_check_seconds_timer();
+	mechanical_update_mesh_geometry_ex(bm_serial, false);
+	time_serial = PIL_check_seconds_timer() - time_start;
+
+	time_start = PIL_check_seconds_timer();
+	mechanical_update_mesh_geometry_ex(bm_threaded, true);
+	time_threaded = PIL_check_seconds_timer() - time_start;
+
+	printf("%d edges, %d geometries, serial: %.6f seconds, threaded: %.6f seconds\n",
+	       bm_serial->totedge, bm_serial->totgeom, time_serial, time_threaded);
+
+	mechanical_clean_geometry(bm_serial);
+	mechanical_clean_geometry(bm_threaded);
+	BM_mesh_free(bm_serial);
+	BM_mesh_free(bm_threaded);
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+/* Timing of geometry restored from the mesh, see mechanical_geometry_test for the result check. */
+static void cylinders_restore_test(const int count, const int segments, const char *id)
+{
+	BMesh *bm = bm_create_cylinders(count, segments);
+	Mesh *me = (Mesh *)MEM_callocN(sizeof(*me), __func__);
+	BMeshToMeshParams to_params = {0};
+	BMeshFromMeshParams from_params = {0};
+	double time_start, time_detect, time_restore;
+
+	printf("\n========== STARTING %s ==========\n", id);
+
+	time_start = PIL_check_seconds_timer();
+	mechanical_update_mesh_geometry(bm);
+	time_detect = PIL_check_seconds_timer() - time_start;
+
+	BM_mesh_bm_to_me(bm, me, &to_params);
+	mechanical_clean_geometry(bm);
+	BM_mesh_free(bm);
+
+	bm = bm_create_empty();
+	time_start = PIL_check_seconds_timer();
+	BM_mesh_bm_from_me(bm, me, &from_params);
+	mechanical_update_mesh_geometry_dirty(bm);
+	time_restore = PIL_check_seconds_timer() - time_start;
+
+	printf("%d edges, %d geometries, detected in %.6f seconds, restored with mesh conversion in %.6f seconds\n",
+	       bm->totedge, bm->totgeom, time_detect, time_restore);
+
+	mechanical_clean_geometry(bm);
+	BM_mesh_free(bm);
+	BKE_mesh_free(me);
+	MEM_freeN(me);
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(mechanical_geometry, DetectCylinders_1k)
+{
+	cylinders_test(4, 64, "Detect cylinders - 1k edges");
+}
+
+TEST(mechanical_geometry, DetectCylinders_50k)
+{
+	cylinders_test(256, 64, "Detect cylinders - 50k edges");
+}
+
+TEST(mechanical_geometry, DetectGears_1k)
+{
+	gears_test(1, 48, "Detect gears - 1k edges");
+}
+
+TEST(mechanical_geometry, DetectGears_50k)
+{
+	gears_test(64, 48, "Detect gears - 50k edges");
+}
+
+TEST(mechanical_geometry, DirtyUpdateCylinders_50k)
+{
+	cylinders_dirty_test(256, 64, "Dirty update cylinders - 50k edges");
+}
+
+TEST(mechanical_geometry, DetectGearsThreaded_50k)
+{
+	gears_threaded_test(64, 48, "Detect gears on threads - 50k edges");
+}
+
+TEST(mechanical_geometry, RestoreCylinders_50k)
+{
+	cylinders_restore_test(256, 64, "Restore cylinders - 50k edges");
+}
+
+#ifdef MECHANICAL_RUN_BIG
+TEST(mechanical_geometry, DetectCylinders_200k)
+{
+	cylinders_test(1024, 64, "Detect cylinders - 200k edges");
+}
+
+TEST(mechanical_geometry, DetectGears_200k)
+{
+	gears_test(256, 48, "Detect gears - 200k edges");
+}
+#endif
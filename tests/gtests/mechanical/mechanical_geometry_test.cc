@@ -0,0 +1,278 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <algorithm>
+#include <vector>
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_math.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BKE_mesh.h"
+
+#include "bmesh.h"
+
+#include "mechanical_geometry.h"
+}
+
+#include "mechanical_testing.h"
+
+/* Geometry of the mesh as sorted (type, vertex indices...) lists, independent of its order. */
+static std::vector<std::vector<int> > geometry_signature(BMesh *bm)
+{
+	std::vector<std::vector<int> > sig;
+	BMGeom *egm;
+	BMIter iter;
+
+	BM_mesh_elem_index_ensure(bm, BM_VERT);
+	BM_ITER_MESH (egm, &iter, bm, BM_GEOMETRY_OF_MESH) {
+		std::vector<int> verts;
+		for (int i = 0; i < egm->totverts; i++) {
+			verts.push_back(BM_elem_index_get(egm->v[i]));
+		}
+		std::sort(verts.begin(), verts.end());
+		verts.insert(verts.begin(), egm->geometry_type);
+		sig.push_back(verts);
+	}
+	std::sort(sig.begin(), sig.end());
+	return sig;
+}
+
+/* Open chain of wire edges along X, each edge is a line on its own unless collinear with others. */
+static BMesh *bm_create_wire_chain(const int tot)
+{
+	BMesh *bm = bm_create_empty();
+	BMVert *v, *v_prev = NULL;
+
+	for (int i = 0; i < tot; i++) {
+		const float co[3] = {(float)i, 0.0f, 0.0f};
+		v = BM_vert_create(bm, co, NULL, BM_CREATE_NOP);
+		if (v_prev) {
+			BM_edge_create(bm, v_prev, v, NULL, BM_CREATE_NOP);
+		}
+		v_prev = v;
+	}
+	return bm;
+}
+
+static BMesh *bm_create_cylinder_pair(void)
+{
+	BMesh *bm = bm_create_empty();
+	const float offset_a[3] = {0.0f, 0.0f, 0.0f};
+	const float offset_b[3] = {3.0f, 0.0f, 0.0f};
+
+	bm_add_cylinder(bm, 32, 1.0f, offset_a, 2.0f, NULL);
+	bm_add_cylinder(bm, 32, 1.0f, offset_b, 2.0f, NULL);
+	BM_mesh_normals_update(bm);
+	return bm;
+}
+
+static void bm_vert_move(BMesh *bm, const int index, const float offset[3])
+{
+	BMVert *v;
+
+	BM_mesh_elem_table_ensure(bm, BM_VERT);
+	v = BM_vert_at_index(bm, index);
+	add_v3_v3(v->co, offset);
+	BM_mesh_normals_update(bm);
+}
+
+/**
+ * Detects geometry, moves a vertex by \a offset_a then \a offset_b, and checks the dirty update
+ * after each move gives the same geometry than a full update of the same mesh.
+ */
+static void dirty_update_compare_test(BMesh *(*create_fn)(void), const int index,
+                                      const float offset_a[3], const float offset_b[3])
+{
+	BMesh *bm_dirty = create_fn();
+	BMesh *bm_full = create_fn();
+	const float *offsets[2] = {offset_a, offset_b};
+
+	mechanical_update_mesh_geometry(bm_dirty);
+	mechanical_update_mesh_geometry(bm_full);
+	EXPECT_EQ(geometry_signature(bm_full), geometry_signature(bm_dirty));
+
+	for (int i = 0; i < 2; i++) {
+		bm_vert_move(bm_dirty, index, offsets[i]);
+		bm_vert_move(bm_full, index, offsets[i]);
+
+		mechanical_update_mesh_geometry_dirty(bm_dirty);
+		mechanical_update_mesh_geometry(bm_full);
+
+		EXPECT_EQ(bm_full->totgeom, bm_dirty->totgeom);
+		EXPECT_EQ(geometry_signature(bm_full), geometry_signature(bm_dirty));
+	}
+
+	mechanical_clean_geometry(bm_dirty);
+	mechanical_clean_geometry(bm_full);
+	BM_mesh_free(bm_dirty);
+	BM_mesh_free(bm_full);
+}
+
+static BMesh *bm_create_wire_chain_8(void)
+{
+	return bm_create_wire_chain(8);
+}
+
+/* Bending a vertex splits the line, moving it back merges the lines again. */
+TEST(mechanical_geometry, DirtyUpdateWireChain)
+{
+	const float bend[3] = {0.0f, 1.0f, 0.0f};
+	const float back[3] = {0.0f, -1.0f, 0.0f};
+	dirty_update_compare_test(bm_create_wire_chain_8, 4, bend, back);
+}
+
+/* Pulling a vertex of the bottom circle leaves an arc, moving it back grows the arc to a circle. */
+TEST(mechanical_geometry, DirtyUpdateCylinderCircle)
+{
+	/* Bottom verts are the even ones of the first cylinder. */
+	const float pull[3] = {-0.5f, 0.0f, 0.0f};
+	const float back[3] = {0.5f, 0.0f, 0.0f};
+	dirty_update_compare_test(bm_create_cylinder_pair, 0, pull, back);
+}
+
+/* Moving a bottom vertex up breaks the circle and side line, moving it back restores them. */
+TEST(mechanical_geometry, DirtyUpdateCylinderSide)
+{
+	const float up[3] = {0.0f, 0.0f, 0.5f};
+	const float down[3] = {0.0f, 0.0f, -0.5f};
+	dirty_update_compare_test(bm_create_cylinder_pair, 2, up, down);
+}
+
+/* Detection on threads gives the same geometry, in the same order, than serial detection. */
+static void threaded_compare_test(BMesh *bm_serial, BMesh *bm_threaded)
+{
+	BMGeom *egm_serial, *egm_threaded;
+	BMIter iter_serial, iter_threaded;
+
+	mechanical_update_mesh_geometry_ex(bm_serial, false);
+	mechanical_update_mesh_geometry_ex(bm_threaded, true);
+
+	EXPECT_GT(bm_serial->totgeom, 0);
+	EXPECT_EQ(bm_serial->totgeom, bm_threaded->totgeom);
+
+	BM_mesh_elem_index_ensure(bm_serial, BM_VERT | BM_EDGE);
+	BM_mesh_elem_index_ensure(bm_threaded, BM_VERT | BM_EDGE);
+	egm_threaded = (BMGeom *)BM_iter_new(&iter_threaded, bm_threaded, BM_GEOMETRY_OF_MESH, NULL);
+	BM_ITER_MESH (egm_serial, &iter_serial, bm_serial, BM_GEOMETRY_OF_MESH) {
+		ASSERT_TRUE(egm_threaded != NULL);
+		EXPECT_EQ(egm_serial->geometry_type, egm_threaded->geometry_type);
+		ASSERT_EQ(egm_serial->totverts, egm_threaded->totverts);
+		ASSERT_EQ(egm_serial->totedges, egm_threaded->totedges);
+		for (int i = 0; i < egm_serial->totverts; i++) {
+			EXPECT_EQ(BM_elem_index_get(egm_serial->v[i]), BM_elem_index_get(egm_threaded->v[i]));
+		}
+		for (int i = 0; i < egm_serial->totedges; i++) {
+			EXPECT_EQ(BM_elem_index_get(egm_serial->e[i]), BM_elem_index_get(egm_threaded->e[i]));
+		}
+		egm_threaded = (BMGeom *)BM_iter_step(&iter_threaded);
+	}
+	EXPECT_TRUE(egm_threaded == NULL);
+
+	mechanical_clean_geometry(bm_serial);
+	mechanical_clean_geometry(bm_threaded);
+	BM_mesh_free(bm_serial);
+	BM_mesh_free(bm_threaded);
+}
+
+TEST(mechanical_geometry, DetectThreadedGears)
+{
+	threaded_compare_test(bm_create_gears(8, 24), bm_create_gears(8, 24));
+}
+
+TEST(mechanical_geometry, DetectThreadedCylinders)
+{
+	threaded_compare_test(bm_create_cylinders(16, 32), bm_create_cylinders(16, 32));
+}
+
+/* Leaving edit mode stores geometry on the mesh, mesh with geometry of \a bm_create_cylinders. */
+static Mesh *mesh_with_geometry(const int count, int *r_totgeom)
+{
+	BMesh *bm = bm_create_cylinders(count, 32);
+	Mesh *me = (Mesh *)MEM_callocN(sizeof(*me), __func__);
+	BMeshToMeshParams to_params = {0};
+
+	mechanical_update_mesh_geometry(bm);
+	*r_totgeom = bm->totgeom;
+
+	BM_mesh_bm_to_me(bm, me, &to_params);
+	mechanical_clean_geometry(bm);
+	BM_mesh_free(bm);
+
+	return me;
+}
+
+/* Enter edit mode, returns the geometry count before and after the first update. */
+static void mesh_geometry_restore(Mesh *me, int *r_restored, int *r_updated)
+{
+	BMesh *bm = bm_create_empty();
+	BMeshFromMeshParams from_params = {0};
+
+	from_params.calc_face_normal = true;
+	BM_mesh_bm_from_me(bm, me, &from_params);
+	*r_restored = bm->totgeom;
+	mechanical_update_mesh_geometry_dirty(bm);
+	*r_updated = bm->totgeom;
+
+	mechanical_clean_geometry(bm);
+	BM_mesh_free(bm);
+}
+
+static void mesh_free(Mesh *me)
+{
+	BKE_mesh_free(me);
+	MEM_freeN(me);
+}
+
+/* Leave and enter edit mode, geometry is restored from the mesh instead of detected. */
+TEST(mechanical_geometry, RestoreFromMesh)
+{
+	int totgeom, restored, updated;
+	Mesh *me = mesh_with_geometry(8, &totgeom);
+
+	EXPECT_GT(totgeom, 0);
+	EXPECT_EQ(totgeom, me->totgeom);
+	EXPECT_NE(0u, me->geom_hash);
+
+	mesh_geometry_restore(me, &restored, &updated);
+	EXPECT_EQ(totgeom, restored);
+	EXPECT_EQ(totgeom, updated);
+
+	/* Changed outside edit mode, geometry is not restored. */
+	me->mvert[0].co[2] += 0.5f;
+	mesh_geometry_restore(me, &restored, &updated);
+	EXPECT_EQ(0, restored);
+
+	mesh_free(me);
+}
+
+/* Invalid entries, as read from a corrupt file, are dropped and detected again. */
+TEST(mechanical_geometry, RestoreFromMeshInvalid)
+{
+	int totgeom, restored, updated;
+	Mesh *me = mesh_with_geometry(2, &totgeom);
+
+	ASSERT_GE(me->totgeom, 5);
+	me->mgeom[0].index_start = -1;
+	me->mgeom[1].index_start = me->totgeom_index;
+	me->mgeom[2].totverts = -3;
+	me->mgeom_index[me->mgeom[3].index_start] = me->totvert;
+	me->mgeom_index[me->mgeom[4].index_start + me->mgeom[4].totverts] = me->totedge;
+
+	mesh_geometry_restore(me, &restored, &updated);
+	EXPECT_EQ(totgeom - 5, restored);
+	EXPECT_EQ(totgeom, updated);
+
+	/* Geometry array missing. */
+	MEM_SAFE_FREE(me->mgeom);
+	mesh_geometry_restore(me, &restored, &updated);
+	EXPECT_EQ(0, restored);
+	EXPECT_EQ(totgeom, updated);
+
+	mesh_free(me);
+}
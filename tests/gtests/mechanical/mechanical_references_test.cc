@@ -0,0 +1,198 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "BLI_utildefines.h"
+#include "BLI_math.h"
+
+#include "bmesh.h"
+
+#include "mesh_references.h"
+}
+
+#include "mechanical_testing.h"
+
+#define EPS 1e-5f
+
+/* Reference owned by \a bm, as created by the editors. */
+static BMReference *reference_create(BMesh *bm, int type,
+                                     const float v1[3], const float v2[3], const float v3[3], const float v4[3])
+{
+	char name[] = "Reference";
+	return BM_reference_create(bm, type, (float *)v1, (float *)v2, (float *)v3, (float *)v4, name,
+	                           NULL, BM_CREATE_NOP);
+}
+
+static const float test_co[][3] = {
+    {0.0f, 0.0f, 0.0f},
+    {1.0f, 2.0f, 3.0f},
+    {-4.0f, 0.5f, 2.0f},
+    {10.0f, -7.0f, 0.25f},
+    {0.3f, 0.3f, -9.0f},
+};
+static const int test_tot = ARRAY_SIZE(test_co);
+
+/* Per point projection, from the reference normal or the v1 v2 direction for axes. */
+static void reference_project_v3_single(BMReference *erf, const float co[3], float r_co[3])
+{
+	float v[3];
+	sub_v3_v3v3(v, co, erf->v1);
+	if (erf->type == BM_REFERENCE_TYPE_AXIS) {
+		float dir[3];
+		sub_v3_v3v3(dir, erf->v2, erf->v1);
+		normalize_v3(dir);
+		madd_v3_v3v3fl(r_co, erf->v1, dir, dot_v3v3(v, dir));
+	}
+	else {
+		float no[3];
+		reference_plane_normal(erf, no);
+		madd_v3_v3v3fl(r_co, co, no, -dot_v3v3(v, no));
+	}
+}
+
+/* Per point local coordinates, inverting the reference matrix (transposed when singular). */
+static void reference_to_local_v3_single(BMReference *erf, const float co[3], float r_co[3])
+{
+	float mat[3][3], imat[3][3], origin[3], v[3];
+	reference_plane_matrix(erf, mat);
+	if (!invert_m3_m3(imat, mat)) {
+		transpose_m3_m3(imat, mat);
+	}
+	reference_plane_origin(erf, origin);
+	sub_v3_v3v3(v, co, origin);
+	mul_v3_m3v3(r_co, imat, v);
+}
+
+static void reference_compare_test(BMReference *erf)
+{
+	float r_co[ARRAY_SIZE(test_co)][3], r_local[ARRAY_SIZE(test_co)][3];
+	float expect[3];
+
+	reference_project_v3_array(erf, test_co, r_co, test_tot);
+	reference_to_local_v3_array(erf, test_co, r_local, test_tot);
+
+	for (int i = 0; i < test_tot; i++) {
+		reference_project_v3_single(erf, test_co[i], expect);
+		EXPECT_V3_NEAR(expect, r_co[i], EPS);
+
+		reference_to_local_v3_single(erf, test_co[i], expect);
+		EXPECT_V3_NEAR(expect, r_local[i], EPS);
+		EXPECT_TRUE(isfinite(r_local[i][0]) && isfinite(r_local[i][1]) && isfinite(r_local[i][2]));
+	}
+}
+
+TEST(mechanical_references, ProjectPlane)
+{
+	const float v1[3] = {1.0f, 0.0f, 0.0f}, v2[3] = {2.0f, 1.0f, 0.5f};
+	const float v3[3] = {1.0f, 2.0f, 1.0f}, v4[3] = {0.0f, 1.0f, 0.5f};
+	BMesh *bm = bm_create_empty();
+	float r_co[ARRAY_SIZE(test_co)][3], no[3], v[3];
+
+	BMReference *erf = reference_create(bm, BM_REFERENCE_TYPE_PLANE, v1, v2, v3, v4);
+	reference_compare_test(erf);
+
+	/* Projected points lie on the plane, third local component is zero. */
+	reference_plane_normal(erf, no);
+	reference_project_v3_array(erf, test_co, r_co, test_tot);
+	for (int i = 0; i < test_tot; i++) {
+		sub_v3_v3v3(v, r_co[i], v1);
+		EXPECT_NEAR(0.0f, dot_v3v3(v, no), EPS);
+	}
+	reference_to_local_v3_array(erf, r_co, r_co, test_tot);
+	for (int i = 0; i < test_tot; i++) {
+		EXPECT_NEAR(0.0f, r_co[i][2], EPS);
+	}
+
+	BM_mesh_free(bm);
+}
+
+TEST(mechanical_references, ProjectAxis)
+{
+	const float v1[3] = {0.0f, 1.0f, 0.0f}, v2[3] = {3.0f, 1.0f, 4.0f};
+	const float v3[3] = {0.0f, 2.0f, 0.0f}, v4[3] = {3.0f, 2.0f, 4.0f};
+	BMesh *bm = bm_create_empty();
+	float r_co[ARRAY_SIZE(test_co)][3], dir[3], v[3], perp[3];
+
+	BMReference *erf = reference_create(bm, BM_REFERENCE_TYPE_AXIS, v1, v2, v3, v4);
+	reference_compare_test(erf);
+
+	/* Projected points lie on the v1 v2 line. */
+	sub_v3_v3v3(dir, v2, v1);
+	normalize_v3(dir);
+	reference_project_v3_array(erf, test_co, r_co, test_tot);
+	for (int i = 0; i < test_tot; i++) {
+		sub_v3_v3v3(v, r_co[i], v1);
+		cross_v3_v3v3(perp, v, dir);
+		EXPECT_NEAR(0.0f, len_v3(perp), EPS * 10.0f);
+	}
+
+	BM_mesh_free(bm);
+}
+
+/* All points on a line, the matrix can't be inverted. */
+TEST(mechanical_references, Degenerate)
+{
+	const float v1[3] = {0.0f, 0.0f, 0.0f}, v2[3] = {1.0f, 0.0f, 0.0f};
+	const float v3[3] = {2.0f, 0.0f, 0.0f}, v4[3] = {3.0f, 0.0f, 0.0f};
+	BMesh *bm = bm_create_empty();
+	float mat[3][3], imat[3][3];
+
+	BMReference *erf = reference_create(bm, BM_REFERENCE_TYPE_PLANE, v1, v2, v3, v4);
+	reference_plane_matrix(erf, mat);
+	EXPECT_FALSE(invert_m3_m3(imat, mat));
+
+	reference_compare_test(erf);
+
+	erf->type = BM_REFERENCE_TYPE_AXIS;
+	reference_compare_test(erf);
+
+	BM_mesh_free(bm);
+}
+
+/* Points edited in place, as transform does, give a new frame. */
+TEST(mechanical_references, FrameUpdate)
+{
+	const float v1[3] = {0.0f, 0.0f, 0.0f}, v2[3] = {1.0f, 0.0f, 0.0f};
+	const float v3[3] = {1.0f, 1.0f, 0.0f}, v4[3] = {0.0f, 1.0f, 0.0f};
+	const float z_axis[3] = {0.0f, 0.0f, 1.0f}, y_axis[3] = {0.0f, -1.0f, 0.0f};
+	BMesh *bm = bm_create_empty();
+	float r_co[ARRAY_SIZE(test_co)][3], r_co_new[ARRAY_SIZE(test_co)][3];
+	float r_local[ARRAY_SIZE(test_co)][3], r_local_new[ARRAY_SIZE(test_co)][3];
+	float no[3], origin[3];
+
+	BMReference *erf = reference_create(bm, BM_REFERENCE_TYPE_PLANE, v1, v2, v3, v4);
+	reference_plane_normal(erf, no);
+	EXPECT_V3_NEAR(z_axis, no, EPS);
+
+	/* Rotate the plane to XZ, moving each point. */
+	erf->v3[1] = 0.0f;
+	erf->v3[2] = 1.0f;
+	erf->v4[1] = 0.0f;
+	erf->v4[2] = 1.0f;
+	reference_plane_normal(erf, no);
+	EXPECT_V3_NEAR(y_axis, no, EPS);
+
+	reference_plane_origin(erf, origin);
+	const float origin_expect[3] = {0.5f, 0.0f, 0.5f};
+	EXPECT_V3_NEAR(origin_expect, origin, EPS);
+
+	/* Only v1 moved, the frame follows too. */
+	erf->v1[0] = -1.0f;
+	reference_plane_origin(erf, origin);
+	const float origin_expect_v1[3] = {0.25f, 0.0f, 0.5f};
+	EXPECT_V3_NEAR(origin_expect_v1, origin, EPS);
+
+	/* Batched functions give the same than a reference created with the edited points. */
+	BMReference *erf_new = reference_create(bm, BM_REFERENCE_TYPE_PLANE, erf->v1, erf->v2, erf->v3, erf->v4);
+	reference_to_local_v3_array(erf, test_co, r_local, test_tot);
+	reference_to_local_v3_array(erf_new, test_co, r_local_new, test_tot);
+	reference_project_v3_array(erf, test_co, r_co, test_tot);
+	reference_project_v3_array(erf_new, test_co, r_co_new, test_tot);
+	for (int i = 0; i < test_tot; i++) {
+		EXPECT_V3_NEAR(r_local_new[i], r_local[i], EPS);
+		EXPECT_V3_NEAR(r_co_new[i], r_co[i], EPS);
+	}
+
+	BM_mesh_free(bm);
+}
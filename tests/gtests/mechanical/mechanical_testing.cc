@@ -0,0 +1,164 @@
+/* Apache License, Version 2.0 */
+
+#include "mechanical_testing.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_math.h"
+
+#include "DNA_meshdata_types.h"
+
+#include "bmesh.h"
+}
+
+BMesh *bm_create_empty(void)
+{
+	BMeshCreateParams bm_params = {0};
+	bm_params.use_toolflags = true;
+	return BM_mesh_create(&bm_mesh_allocsize_default, &bm_params);
+}
+
+/* Extrude a closed 2D profile along Z, the caps are single ngons.
+ * Returns the vertices, bottom ones first, to be freed by the caller when r_verts is given. */
+void bm_add_prism(BMesh *bm, const float (*profile)[2], const int tot, const float offset[3], const float height,
+                  BMVert ***r_verts)
+{
+	BMVert **verts = (BMVert **)MEM_mallocN(sizeof(*verts) * tot * 2, __func__);
+	BMVert *quad[4];
+	int i;
+
+	for (i = 0; i < tot; i++) {
+		float co[3] = {profile[i][0], profile[i][1], 0.0f};
+		add_v3_v3(co, offset);
+		verts[i] = BM_vert_create(bm, co, NULL, BM_CREATE_NOP);
+		co[2] += height;
+		verts[tot + i] = BM_vert_create(bm, co, NULL, BM_CREATE_NOP);
+	}
+
+	for (i = 0; i < tot; i++) {
+		const int i_next = (i + 1) % tot;
+		quad[0] = verts[i];
+		quad[1] = verts[i_next];
+		quad[2] = verts[tot + i_next];
+		quad[3] = verts[tot + i];
+		BM_face_create_verts(bm, quad, 4, NULL, BM_CREATE_NOP, true);
+	}
+
+	BM_face_create_verts(bm, verts, tot, NULL, BM_CREATE_NOP, true);
+	BM_face_create_verts(bm, &verts[tot], tot, NULL, BM_CREATE_NOP, true);
+
+	if (r_verts) {
+		*r_verts = verts;
+	}
+	else {
+		MEM_freeN(verts);
+	}
+}
+
+void bm_add_cylinder(BMesh *bm, const int segments, const float radius, const float offset[3],
+                     const float height, BMVert ***r_verts)
+{
+	float (*profile)[2] = (float (*)[2])MEM_mallocN(sizeof(*profile) * segments, __func__);
+
+	for (int i = 0; i < segments; i++) {
+		const float angle = (float)(2.0 * M_PI) * (float)i / (float)segments;
+		profile[i][0] = radius * cosf(angle);
+		profile[i][1] = radius * sinf(angle);
+	}
+	bm_add_prism(bm, profile, segments, offset, height, r_verts);
+
+	MEM_freeN(profile);
+}
+
+/* Gear profile: each tooth is a root arc followed by a flat tip. */
+void bm_add_gear(BMesh *bm, const int teeth, const int root_segments, const float offset[3])
+{
+	const int tooth_tot = root_segments + 2;
+	const int tot = teeth * tooth_tot;
+	const float tooth_angle = (float)(2.0 * M_PI) / (float)teeth;
+	const float root_radius = 2.0f, tip_radius = 2.5f;
+	float (*profile)[2] = (float (*)[2])MEM_mallocN(sizeof(*profile) * tot, __func__);
+	int i = 0;
+
+	for (int t = 0; t < teeth; t++) {
+		const float base = tooth_angle * (float)t;
+		for (int s = 0; s < root_segments; s++) {
+			const float angle = base + (tooth_angle * 0.5f) * (float)s / (float)(root_segments - 1);
+			profile[i][0] = root_radius * cosf(angle);
+			profile[i][1] = root_radius * sinf(angle);
+			i++;
+		}
+		for (int s = 0; s < 2; s++) {
+			const float angle = base + tooth_angle * (0.6f + 0.3f * (float)s);
+			profile[i][0] = tip_radius * cosf(angle);
+			profile[i][1] = tip_radius * sinf(angle);
+			i++;
+		}
+	}
+	bm_add_prism(bm, profile, tot, offset, 1.0f, NULL);
+
+	MEM_freeN(profile);
+}
+
+/* Unit cylinders in rows of 64, with normals. */
+BMesh *bm_create_cylinders(const int count, const int segments)
+{
+	BMesh *bm = bm_create_empty();
+
+	for (int i = 0; i < count; i++) {
+		const float offset[3] = {3.0f * (float)(i % 64), 3.0f * (float)(i / 64), 0.0f};
+		bm_add_cylinder(bm, segments, 1.0f, offset, 2.0f, NULL);
+	}
+	BM_mesh_normals_update(bm);
+	return bm;
+}
+
+/* Gears in rows of 32, with normals. */
+BMesh *bm_create_gears(const int count, const int teeth)
+{
+	BMesh *bm = bm_create_empty();
+
+	for (int i = 0; i < count; i++) {
+		const float offset[3] = {6.0f * (float)(i % 32), 6.0f * (float)(i / 32), 0.0f};
+		bm_add_gear(bm, teeth, 4, offset);
+	}
+	BM_mesh_normals_update(bm);
+	return bm;
+}
+
+/* Grid of quads with a linear dimension on each edge along X, using \a mdims for their data. */
+BMesh *bm_create_dimension_grid(const int grid, MDim *mdims)
+{
+	BMVert **verts = (BMVert **)MEM_mallocN(sizeof(*verts) * grid * grid, __func__);
+	BMVert *quad[4];
+	BMesh *bm = bm_create_empty();
+	int x, y, i = 0;
+
+	for (y = 0; y < grid; y++) {
+		for (x = 0; x < grid; x++) {
+			const float co[3] = {(float)x, (float)y, 0.0f};
+			verts[y * grid + x] = BM_vert_create(bm, co, NULL, BM_CREATE_NOP);
+		}
+	}
+	for (y = 0; y < grid - 1; y++) {
+		for (x = 0; x < grid - 1; x++) {
+			quad[0] = verts[y * grid + x];
+			quad[1] = verts[y * grid + x + 1];
+			quad[2] = verts[(y + 1) * grid + x + 1];
+			quad[3] = verts[(y + 1) * grid + x];
+			BM_face_create_verts(bm, quad, 4, NULL, BM_CREATE_NOP, true);
+		}
+	}
+	BM_mesh_normals_update(bm);
+
+	for (y = 0; y < grid; y++) {
+		for (x = 0; x < grid - 1; x++) {
+			BMVert *v_arr[2] = {verts[y * grid + x], verts[y * grid + x + 1]};
+			BM_dim_create(bm, v_arr, 2, DIM_TYPE_LINEAR, NULL, BM_CREATE_SET_DEFAULT_DATA, &mdims[i++]);
+		}
+	}
+
+	MEM_freeN(verts);
+	return bm;
+}
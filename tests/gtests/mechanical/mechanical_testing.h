@@ -0,0 +1,24 @@
+/* Apache License, Version 2.0 */
+
+#ifndef __MECHANICAL_TESTING_H__
+#define __MECHANICAL_TESTING_H__
+
+/* Mesh fixtures shared by the mechanical tests and benchmarks. */
+
+struct BMesh;
+struct BMVert;
+struct MDim;
+
+struct BMesh *bm_create_empty(void);
+
+void bm_add_prism(struct BMesh *bm, const float (*profile)[2], const int tot, const float offset[3],
+                  const float height, struct BMVert ***r_verts);
+void bm_add_cylinder(struct BMesh *bm, const int segments, const float radius, const float offset[3],
+                     const float height, struct BMVert ***r_verts);
+void bm_add_gear(struct BMesh *bm, const int teeth, const int root_segments, const float offset[3]);
+
+struct BMesh *bm_create_cylinders(const int count, const int segments);
+struct BMesh *bm_create_gears(const int count, const int teeth);
+struct BMesh *bm_create_dimension_grid(const int grid, struct MDim *mdims);
+
+#endif  /* __MECHANICAL_TESTING_H__ */
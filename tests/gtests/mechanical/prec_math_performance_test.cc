@@ -0,0 +1,81 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_math_base.h"
+#include "BLI_rand.h"
+#include "PIL_time.h"
+
+#include "prec_math.h"
+}
+
+/* Random points on a coarse grid, so many of them are coincident.
+ * Multiples of 1/8 are exact halves once quantised, testing the rounding of ties. */
+static float (*points_create(const int tot, const unsigned int seed))[3]
+{
+	float (*co)[3] = (float (*)[3])MEM_mallocN(sizeof(*co) * tot, __func__);
+	RNG *rng = BLI_rng_new(seed);
+
+	for (int i = 0; i < tot; i++) {
+		for (int j = 0; j < 3; j++) {
+			const float f = BLI_rng_get_float(rng);
+			co[i][j] = (i % 2) ? (float)(int)((f - 0.5f) * 64.0f) / 8.0f : (f - 0.5f) * 2.0f;
+		}
+	}
+	BLI_rng_free(rng);
+
+	return co;
+}
+
+/* Search for a point, comparing with eq_v3v3_prec or comparing points quantised once. */
+static void prec_math_find_test(const int tot, const char *id)
+{
+	float (*co)[3] = points_create(tot, 0);
+	int (*q)[4] = (int (*)[4])MEM_mallocN(sizeof(*q) * tot, __func__);
+	const float target[3] = {1.0f / 8.0f, -3.0f / 8.0f, 0.5f};
+	int q_target[1][4];
+	double time_start, time_scalar, time_array;
+	int found_scalar = -1, found_array = -1;
+
+	printf("\n========== STARTING %s ==========\n", id);
+
+	time_start = PIL_check_seconds_timer();
+	for (int i = 0; i < tot; i++) {
+		if (eq_v3v3_prec(target, co[i])) {
+			found_scalar = i;
+			break;
+		}
+	}
+	time_scalar = PIL_check_seconds_timer() - time_start;
+
+	/* Whole array is quantised, as when comparing many points to many. */
+	time_start = PIL_check_seconds_timer();
+	quantize_v3_prec_array(q_target, (const float (*)[3])target, 1);
+	quantize_v3_prec_array(q, (const float (*)[3])co, tot);
+	for (int i = 0; i < tot; i++) {
+		if ((q[i][0] == q_target[0][0]) && (q[i][1] == q_target[0][1]) && (q[i][2] == q_target[0][2])) {
+			found_array = i;
+			break;
+		}
+	}
+	time_array = PIL_check_seconds_timer() - time_start;
+
+	EXPECT_EQ(found_scalar, found_array);
+
+	const int compared = (found_scalar == -1) ? tot : found_scalar + 1;
+	printf("eq_v3v3_prec: %.3f ns per comparison\n", time_scalar * 1e9 / (double)compared);
+	printf("quantize_v3_prec_array: %.3f ns per point\n", time_array * 1e9 / (double)tot);
+
+	MEM_freeN(q);
+	MEM_freeN(co);
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(prec_math, Find_1M)
+{
+	prec_math_find_test(1000000, "Find coincident point - 1M points");
+}
@@ -0,0 +1,79 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_rand.h"
+
+#include "prec_math.h"
+}
+
+/* Random points, every other one on a coarse grid so many of them are coincident.
+ * Multiples of 1/8 are exact halves once quantised, testing the rounding of ties. */
+static float (*points_create(const int tot, const unsigned int seed))[3]
+{
+	float (*co)[3] = (float (*)[3])MEM_mallocN(sizeof(*co) * tot, __func__);
+	RNG *rng = BLI_rng_new(seed);
+
+	for (int i = 0; i < tot; i++) {
+		for (int j = 0; j < 3; j++) {
+			const float f = BLI_rng_get_float(rng);
+			co[i][j] = (i % 2) ? (float)(int)((f - 0.5f) * 64.0f) / 8.0f : (f - 0.5f) * 2.0f;
+		}
+	}
+	BLI_rng_free(rng);
+
+	return co;
+}
+
+/* Points quantised together (SSE2 path when available) match points quantised one by one (roundf). */
+TEST(prec_math, QuantizeArray)
+{
+	const int tot = 10000;
+	float (*co)[3] = points_create(tot, 2);
+	int (*q)[4] = (int (*)[4])MEM_mallocN(sizeof(*q) * tot, __func__);
+	int q_single[1][4];
+
+	quantize_v3_prec_array(q, (const float (*)[3])co, tot);
+
+	for (int i = 0; i < tot; i++) {
+		quantize_v3_prec_array(q_single, (const float (*)[3])&co[i], 1);
+		EXPECT_EQ(q_single[0][0], q[i][0]);
+		EXPECT_EQ(q_single[0][1], q[i][1]);
+		EXPECT_EQ(q_single[0][2], q[i][2]);
+		EXPECT_EQ(0, q[i][3]);
+	}
+
+	/* Same equality than eq_v3v3_prec, compare grid points. */
+	for (int i = 2; i < tot; i++) {
+		const bool eq_q = (q[i][0] == q[i - 2][0]) && (q[i][1] == q[i - 2][1]) && (q[i][2] == q[i - 2][2]);
+		EXPECT_EQ(eq_v3v3_prec(co[i], co[i - 2]) != 0, eq_q);
+	}
+
+	MEM_freeN(q);
+	MEM_freeN(co);
+}
+
+/* Ties round away from zero, as roundf. */
+TEST(prec_math, QuantizeArrayTies)
+{
+	const float co[4][3] = {
+	    {0.125f, -0.125f, 0.375f},
+	    {-0.375f, 0.625f, -0.625f},
+	    {0.0f, -0.0f, 2.5f},
+	    {-2.5f, 0.005f, -0.005f},
+	};
+	int q[4][4], q_single[1][4];
+
+	quantize_v3_prec_array(q, co, 4);
+	for (int i = 0; i < 4; i++) {
+		quantize_v3_prec_array(q_single, &co[i], 1);
+		for (int j = 0; j < 3; j++) {
+			EXPECT_EQ(q_single[0][j], q[i][j]);
+		}
+	}
+	EXPECT_EQ(-q[0][0], q[0][1]);
+	EXPECT_EQ(-q[1][1], q[1][2]);
+}